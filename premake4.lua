@@ -117,6 +117,8 @@ solution "simhub"
                       "src/libs/variant/include", 
                       "src/libs",
                       "src/libs/variant/include/mpark",
+                      "src/libs/plugins",
+                      "lib/pokey",
                       "/usr/local/opt/openssl/include",
                                           "src/libs/queue" }
         links { "dl", 
@@ -135,6 +137,53 @@ solution "simhub"
             links { "boost_thread-mt" }
         configuration {}
 
+    project "simhub_bench"
+        kind "ConsoleApp"
+        language "C++"
+        files { "src/bench/**.h",
+                "src/bench/**.cpp",
+                "src/common/**.h",
+                "src/common/**.cpp",
+                "src/app/simhub.cpp",
+                "src/libs/plugins/common/**.cpp",
+                "src/libs/plugins/prepare3d/**.cpp" }
+
+        configuration {"Debug"}
+            excludes {"src/common/aws/**"}
+        configuration {}
+
+        libdirs { "/usr/local/opt/openssl/lib" }
+
+        includedirs { "src",
+                      "src/app",
+                      "src/common",
+                      "src/libs",
+                      "src/libs/plugins",
+                      "src/libs/variant/include",
+                      "src/libs/variant/include/mpark",
+                      "src/libs/queue",
+                      "lib/pokey",
+                      "/usr/local/opt/openssl/include" }
+
+        links { "pthread",
+                "zlog",
+                "uv",
+                "cpprest",
+                "ssl",
+                "boost_system",
+                "crypto",
+                "boost_chrono",
+                "config++" }
+
+        configuration {"linux"}
+            links {"dl"}
+        configuration {"macosx"}
+            links { "boost_thread-mt" }
+        configuration {""}
+
+        targetdir ("bin")
+        buildoptions { "--std=c++14" }
+
     project "prepare3d_plugin"
             kind "SharedLib"
                 language "C++"
@@ -157,6 +206,25 @@ solution "simhub"
                       "src/libs/queue" }
         buildoptions { "--std=c++14" }
 
+    project "loadgen_plugin"
+        kind "SharedLib"
+        language "C++"
+        targetname "loadgen"
+        targetdir ("bin/plugins")
+        links { 'config++',
+                'pthread'}
+        files { "src/libs/plugins/loadgen/**.h",
+                "src/libs/plugins/common/**.cpp",
+                "src/libs/plugins/loadgen/**.cpp",
+                "src/common/elements/attributes/attribute.cpp" }
+        includedirs { "src/common",
+                      "src/libs/plugins",
+                      "src/libs/variant/include",
+                      "src/libs",
+                      "src/libs/variant/include/mpark",
+                      "src/libs/queue" }
+        buildoptions { "--std=c++14" }
+
     project "pokey_dev_support"
         kind "Makefile"
         basedir ("lib/pokey")
@@ -26,6 +26,10 @@ void configureCli(cmdline::parser *cli)
 {
     cli->add<std::string>("config", 'c', "config file", false, "config/config.cfg");
     cli->add<std::string>("logConfig", 'l', "log config file", false, "config/zlog.conf");
+    cli->add<std::string>("record", 'r', "record every plugin event to this event log", false, "");
+    cli->add<std::string>("replay", 'R', "play this event log into the event loop", false, "");
+    cli->add<double>("replaySpeed", 's', "replay speed multiplier, 0 for as fast as possible", false, 1.0);
+    cli->add("replayLoop", '\0', "start the replay over when it reaches the end of the log");
 
 ///! If the AWS SDK is being used then allow Polly as a CLI option
 #if defined(_AWS_SDK)
@@ -79,25 +83,29 @@ void run_simhub(const cmdline::parser &cli)
     simhubController->enableKinesis();
 #endif
 
-    if (simhubController->loadPokeyPlugin()) {
-        if (simhubController->loadPrepare3dPlugin()) {
-            // kick off the simhub envent loop
+    if (!cli.get<std::string>("record").empty() && !simhubController->recordTo(cli.get<std::string>("record"))) {
+        exit(1);
+    }
+
+    if (!cli.get<std::string>("replay").empty()
+        && !simhubController->replayFrom(cli.get<std::string>("replay"), cli.get<double>("replaySpeed"), cli.exist("replayLoop"))) {
+        exit(1);
+    }
+
+    if (simhubController->loadPlugins()) {
+        // kick off the simhub envent loop
 
-            simhubController->runEventLoop([=](std::shared_ptr<Attribute> value) {
-                bool deliveryResult = simhubController->deliverValue(value);
+        simhubController->runEventLoop([=](EventSpan &events) {
+            bool deliveryResult = simhubController->deliverValues(events);
 
 #if defined(_AWS_SDK)
-                simhubController->deliverKinesisValue(value);
+            simhubController->deliverKinesisValues(events);
 #endif
-                return deliveryResult;
-            });
-        }
-        else {
-            logger.log(LOG_ERROR, "error loading prepare3d plugin");
-        }
+            return deliveryResult;
+        });
     }
     else {
-        logger.log(LOG_ERROR, "Could not load pokey plugin");
+        logger.log(LOG_ERROR, "Could not load plugins");
     }
 }
 
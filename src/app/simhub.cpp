@@ -33,11 +33,16 @@ void SimHubEventController::DestroyEventControllerInstance(void)
 
 SimHubEventController::SimHubEventController()
 {
-    _prepare3dMethods.plugin_instance = NULL;
-    _pokeyMethods.plugin_instance = NULL;
     _configManager = NULL;
+    _eventBatchSize = DEFAULT_EVENT_BATCH_SIZE;
+    _eventBatchLinger = std::chrono::microseconds(DEFAULT_EVENT_BATCH_LINGER);
     _running = false;
 
+    // counters on the event path are registered up front, plugins start eventing before the loop runs
+    _unresolvedEvents = &_metrics.counter("simhub_events_dropped_total", "Events dropped before reaching a lane", "reason=\"unresolved\"");
+    _unmappedEvents = &_metrics.counter("simhub_events_filtered_total", "Events not forwarded to a plugin", "reason=\"unmapped\"");
+    _echoedEvents = &_metrics.counter("simhub_events_filtered_total", "Events not forwarded to a plugin", "reason=\"echo\"");
+
 #if defined(_AWS_SDK)
     _awsHelper.init();
 #endif
@@ -132,13 +137,118 @@ std::string libconfigToJSON(std::string configFilename)
     return jsonStream.str();
 }
 
+//! dispatches GET requests on the configuration listener by path
+void SimHubEventController::httpGETHandler(web::http::http_request request)
+{
+    if (request.relative_uri().path() == "/latency") {
+        httpGETLatencyHandler(request);
+    }
+    else if (request.relative_uri().path() == "/metrics") {
+        httpGETMetricsHandler(request);
+    }
+    else {
+        httpGETConfigurationHandler(request);
+    }
+}
+
 /**
- * serves GET requests on http://localhost/configuration - returns
- * JSON converted pokey configuration content
+ * serves GET requests on http://localhost/latency - returns the end to
+ * end latency percentiles of every stage as JSON
+ */
+void SimHubEventController::httpGETLatencyHandler(web::http::http_request request)
+{
+    request.reply(web::http::status_codes::OK, latencyJSON(), "application/json");
+}
+
+/**
+ * serves GET requests on http://localhost/metrics - returns every
+ * registered metric in the Prometheus text exposition format. Scraping
+ * only reads atomics and never takes a lock the event path uses.
+ */
+void SimHubEventController::httpGETMetricsHandler(web::http::http_request request)
+{
+    request.reply(web::http::status_codes::OK, _metrics.exposition(), "text/plain; version=0.0.4");
+}
+
+/**
+ * registers the values the core already keeps (queue depths, drop and
+ * delivery counts, latency histograms) as series read at scrape time -
+ * called once the plugins and their delivery workers are up
+ */
+void SimHubEventController::registerMetrics(void)
+{
+    for (size_t lane = 0; lane < _eventLanes.laneCount(); lane++) {
+        std::string labels = "lane=\"" + _eventLanes.options(lane).name + "\"";
+
+        _metrics.gaugeFunction("simhub_event_lane_depth", "Events waiting in an event lane", labels, [this, lane] { return (double)_eventLanes.size(lane); });
+        _metrics.gaugeFunction("simhub_event_lane_high_water", "Deepest an event lane has been", labels, [this, lane] { return (double)_eventLanes.highWater(lane); });
+        _metrics.gaugeFunction("simhub_event_lane_capacity", "Capacity of an event lane", labels, [this, lane] { return (double)_eventLanes.capacity(lane); });
+        _metrics.counterFunction("simhub_event_lane_dropped_total", "Events dropped on event lane overflow", labels, [this, lane] { return (uint64_t)_eventLanes.droppedCount(lane); });
+    }
+
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        DeliveryWorker *delivery = plugin->delivery.get();
+        std::string labels = "plugin=\"" + plugin->descriptor.name + "\"";
+
+        if (!delivery) {
+            continue;
+        }
+
+        _metrics.gaugeFunction("simhub_delivery_queue_depth", "Values waiting for delivery to a plugin", labels, [delivery] { return (double)delivery->depth(); });
+        _metrics.counterFunction("simhub_delivery_delivered_total", "Values delivered to a plugin", labels, [delivery] { return (uint64_t)delivery->delivered(); });
+        _metrics.counterFunction("simhub_delivery_dropped_total", "Values dropped on delivery queue overflow", labels, [delivery] { return (uint64_t)delivery->dropped(); });
+        _metrics.counterFunction("simhub_delivery_errors_total", "Batches a plugin failed to take", labels, [delivery] { return (uint64_t)delivery->failedBatches(); });
+        _metrics.summary("simhub_delivery_queue_wait_seconds", "Time values wait in a plugin's delivery queue", labels, &delivery->queueLatencyHistogram(), 1e-9);
+        _metrics.summary("simhub_delivery_call_seconds", "Duration of the call handing a batch to a plugin", labels, &delivery->deliveryLatencyHistogram(), 1e-9);
+    }
+
+    _metrics.counterFunction("simhub_events_conflated_total", "Updates coalesced into one already queued", "", [this] { return (uint64_t)_conflation.coalescedCount(); });
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        std::string labels = std::string("stage=\"") + LatencyTracer::StageName((LatencyStage)stage) + "\"";
+        _metrics.summary("simhub_latency_seconds", "Time since ingest at each stage", labels, &_latency.histogram((LatencyStage)stage), 1e-9);
+    }
+}
+
+/**
+ * per stage latency (nanoseconds since ingest) as JSON, e.g.
+ * { "parse" : { "count" : 10, "p50" : 1200, "p99" : ..., "p999" : ..., "max" : ... }, ... }
+ */
+std::string SimHubEventController::latencyJSON(void)
+{
+    std::stringstream ss;
+
+    ss << "{";
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        HdrHistogram &histogram = _latency.histogram((LatencyStage)stage);
+
+        ss << (stage ? ", " : " ") << "\"" << LatencyTracer::StageName((LatencyStage)stage) << "\" : { \"count\" : " << histogram.count() << ", \"p50\" : " << histogram.percentile(50.0)
+           << ", \"p99\" : " << histogram.percentile(99.0) << ", \"p999\" : " << histogram.percentile(99.9) << ", \"max\" : " << histogram.max() << " }";
+    }
+
+    ss << " }";
+
+    return ss.str();
+}
+
+/**
+ * serves GET requests on http://localhost/configuration?plugin=<name> -
+ * returns JSON converted configuration content of the named plugin
+ * (pokey if no name is given)
  */
 void SimHubEventController::httpGETConfigurationHandler(web::http::http_request request)
 {
-    std::string config_json = libconfigToJSON(_configManager->pokeyConfigurationFilename());
+    std::map<utility::string_t, utility::string_t> query = web::uri::split_query(request.request_uri().query());
+    std::string pluginName = mapContains(query, utility::string_t("plugin")) ? query["plugin"] : "pokey";
+    PluginContext *plugin = _plugins.find(pluginName);
+
+    if (!plugin) {
+        request.reply(web::http::status_codes::NotFound);
+        return;
+    }
+
+    std::string config_json = libconfigToJSON(plugin->descriptor.configFile);
     request.reply(web::http::status_codes::OK, config_json);
 }
 
@@ -155,7 +265,7 @@ void SimHubEventController::startHTTPListener(void)
 
     // start http listener for json config read
     _configurationHTTPListener->open().wait();
-    _configurationHTTPListener->support(web::http::methods::GET, std::bind(&SimHubEventController::httpGETConfigurationHandler, this, std::placeholders::_1));
+    _configurationHTTPListener->support(web::http::methods::GET, std::bind(&SimHubEventController::httpGETHandler, this, std::placeholders::_1));
 }
 
 SimHubEventController::~SimHubEventController(void)
@@ -192,14 +302,15 @@ void SimHubEventController::startSustainThread(void)
 
             std::chrono::milliseconds now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
 
-            for (std::pair<std::string, SustainMapEntry> entry: _sustainValues) {
+            for (std::pair<const SymbolId, SustainMapEntry> &entry : _sustainValues) {
                 std::chrono::milliseconds sustain = entry.second.first;
-                std::chrono::milliseconds ts = entry.second.second->timestamp();
+                EventRecord &record = entry.second.second;
+                std::chrono::milliseconds ts = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(record.timestamp));
 
                 if ((ts + sustain) <= now) {
-                    entry.second.second->resetTimestamp();
-                    logger.log(LOG_INFO, "sustaining value: %s", entry.second.second->name().c_str());
-                    deliverKinesisValue(entry.second.second);
+                    record.resetTimestamp();
+                    logger.log(LOG_INFO, "sustaining value: %s", _symbols.name(record.symbol).c_str());
+                    deliverKinesisValue(record);
                 }
             }
         }
@@ -214,13 +325,16 @@ void SimHubEventController::ceaseSustainThread(void)
     _sustainThreadManager.shutdownThread();
 }
 
-void SimHubEventController::deliverKinesisValue(std::shared_ptr<Attribute> value)
+void SimHubEventController::deliverKinesisValue(const EventRecord &record)
 {
-    std::string name = value->name();
-    std::string val = value->valueToString();
-    std::string ts = value->timestampAsString();
-    std::string description = value->description();
-    std::string units = value->units();
+    // kinesis wants the richer string forms, view the record as an attribute
+    Attribute value(record, _symbols.name(record.symbol));
+
+    std::string name = value.name();
+    std::string val = value.valueToString();
+    std::string ts = value.timestampAsString();
+    std::string description = value.description();
+    std::string units = value.units();
 
     // {s:"a",t:"b",v:"123", ts:121}
     std::stringstream ss;
@@ -237,6 +351,33 @@ void SimHubEventController::deliverKinesisValue(std::shared_ptr<Attribute> value
     _awsHelper.kinesis()->putRecord(data);
 }
 
+//! batch variant of deliverKinesisValue - hands the whole batch to the kinesis queue in one go
+void SimHubEventController::deliverKinesisValues(EventSpan &events)
+{
+    std::vector<Aws::Utils::ByteBuffer> records;
+
+    records.reserve(events.size());
+
+    for (EventRecord &record : events) {
+        Attribute value(record, _symbols.name(record.symbol));
+        std::stringstream ss;
+
+        ss << "{ \"s\" : \"" << value.name() << "\", \"val\" : \"" << value.valueToString() << "\", \"ts\" : \"" << value.timestampAsString() << "\", \"d\" : \""
+           << value.description() << "\", \"u\":\"" << value.units() << "\"}";
+        std::string dataString = ss.str();
+
+        Aws::Utils::ByteBuffer data(dataString.length());
+
+        for (int i = 0; i < dataString.length(); i++) {
+            data[i] = dataString[i];
+        }
+
+        records.push_back(data);
+    }
+
+    _awsHelper.kinesis()->putRecords(records);
+}
+
 void SimHubEventController::enablePolly(void)
 {
     _awsHelper.initPolly();
@@ -256,7 +397,7 @@ void SimHubEventController::enableKinesis(void)
     kinesis.lookupValue("stream", stream);
     kinesis.lookupValue("partition", partition);
     // initialise the kinesis helper
-    _awsHelper.initKinesis(stream, partition, region);
+    _awsHelper.initKinesis(stream, partition, region, &_metrics);
 }
 
 #endif
@@ -264,95 +405,297 @@ void SimHubEventController::enableKinesis(void)
 void SimHubEventController::setConfigManager(ConfigManager *configManager)
 {
     _configManager = configManager;
+
+    // plugins are not loaded yet so nothing is producing into the
+    // lanes - safe to re-dimension them here
+    _eventLanes.configure(_configManager->eventLanes(), LaneSchedulingFromString(_configManager->eventLaneScheduling()));
+
+    // an evicted conflated update must not leave its element pending
+    // forever, otherwise all later updates would be coalesced into it
+    _eventLanes.setDropHandler([this](EventRecord &event) { _conflation.cancel(event.symbol); });
+
+    for (size_t lane = 0; lane < _eventLanes.laneCount(); lane++) {
+        LaneOptions &options = _eventLanes.options(lane);
+        logger.log(LOG_INFO, "Event lane %s: capacity %lu, weight %u", options.name.c_str(), _eventLanes.capacity(lane), options.weight);
+    }
+
+    for (std::pair<const std::string, std::string> &mapping : _configManager->mapManager()->lanes()) {
+        int lane = _eventLanes.laneIndex(mapping.second);
+
+        if (lane < 0) {
+            logger.log(LOG_ERROR, "Mapping | WARNING | No event lane %s for %s", mapping.second.c_str(), mapping.first.c_str());
+            continue;
+        }
+
+        _eventLanes.assign(_symbols.intern(mapping.first), lane);
+    }
+
+    _eventBatchSize = _configManager->eventBatchSize();
+    _eventBatchLinger = _configManager->eventBatchLinger();
+    logger.log(LOG_INFO, "Event loop batch size %lu, linger %lldus", _eventBatchSize, (long long)_eventBatchLinger.count());
 }
 
 void SimHubEventController::ceaseEventLoop(void)
 {
-    _eventQueue.unblock();
+    _eventLanes.unblock();
 }
 
-bool SimHubEventController::deliverValue(std::shared_ptr<Attribute> value)
+bool SimHubEventController::deliverValue(EventRecord value)
 {
-    assert(_pokeyMethods.simplug_deliver_value);
+    EventSpan events(&value, 1);
+    return deliverValues(events);
+}
+
+/**
+ * builds the routing table from the mapping configuration and the
+ * targets the loaded plugins declare - called once the plugins are up
+ * and before any of them commences eventing, routes() is read from the
+ * plugins' threads from then on
+ */
+void SimHubEventController::compileRoutes(void)
+{
+    _routing.clear();
+
+    // destinations are added in registry order, so a route's
+    // destinationIndex is also the index of its plugin
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        _routing.addDestination(&plugin->methods, plugin->descriptor.name);
+    }
 
-    GenericTLV *c_value = AttributeToCGeneric(value);
+    std::shared_ptr<MappingConfigManager> mapManager = _configManager->mapManager();
 
-    bool retVal = false;
+    for (std::pair<const std::string, std::vector<std::string>> &mapping : mapManager->targets()) {
+        std::vector<std::string> destinations;
+
+        if (mapContains(mapManager->destinations(), mapping.first)) {
+            destinations = mapManager->destinations()[mapping.first];
+        }
+
+        _routing.addMapping(mapping.first, mapping.second, destinations);
+    }
+
+    _routing.compile(&_symbols);
+
+    logger.log(LOG_INFO, "Routing | %lu route(s) to %lu plugin(s)", _routing.routeCount(), _routing.destinationCount());
+}
+
+/**
+ * delivers a batch of events - the sustain map is updated under a
+ * single lock and every event is fanned out along its precompiled
+ * routes onto the delivery queue of each destination plugin. The
+ * plugins are called from their own delivery workers, so a slow plugin
+ * only ever delays its own values.
+ *
+ * @return bool false once a plugin has reported a delivery error
+ */
+bool SimHubEventController::deliverValues(EventSpan &events)
+{
+    bool retVal = true;
 
 #if defined(_AWS_SDK)
-    if (mapContains(_configManager->mapManager()->sustainMap(), value->name())) {
-        // update the sustain value map entry
+    {
+        std::shared_ptr<MappingConfigManager> mapManager = _configManager->mapManager();
         std::lock_guard<std::mutex> sustainGuard(_sustainValuesMutex);
-        _sustainValues[value->name()].second = value;
-        _sustainValues[value->name()].first = std::chrono::milliseconds(_configManager->mapManager()->sustainMap()[value->name()]);
-    }
-#endif
 
-    // determine value destination from the source - very simple at the moment
-    // (just deliver to whatever instance is not the source) - may want more
-    // sophisticated logic here
+        for (EventRecord &value : events) {
+            unsigned int sustain = mapManager->sustain(value.symbol);
 
-    if (value->ownerPlugin() == _pokeyMethods.plugin_instance) {
-        retVal = !_prepare3dMethods.simplug_deliver_value(_prepare3dMethods.plugin_instance, c_value);
+            if (sustain > 0) {
+                // update the sustain value map entry
+                _sustainValues[value.symbol].second = value;
+                _sustainValues[value.symbol].first = std::chrono::milliseconds(sustain);
+            }
+        }
     }
-    else if (value->ownerPlugin() == _prepare3dMethods.plugin_instance) {
+#endif
 
+    for (EventRecord &value : events) {
 #if defined(_AWS_SDK)
-        if (value->name() == "N_ELEC_PANEL_LOWER_LEFT") {
-                  _awsHelper.polly()->say("dc volts %i", c_value->value);
+        if (_symbols.name(value.symbol) == "N_ELEC_PANEL_LOWER_LEFT" && value.type == INT_ATTRIBUTE) {
+            _awsHelper.polly()->say("dc volts %i", value.value.intValue);
         }
 #endif
 
-        retVal = !_pokeyMethods.simplug_deliver_value(_pokeyMethods.plugin_instance, c_value);
+        for (const Route &route : _routing.routes(value.symbol)) {
+            if (RoutingTable::IsEcho(route, value.symbol, value.ownerPlugin)) {
+                _echoedEvents->add();
+                continue;
+            }
+
+            SymbolId target = route.target == SYMBOL_UNRESOLVED ? value.symbol : route.target;
+            GenericTLV *c_value = EventRecordToCGeneric(value, _symbols.name(target).c_str());
+
+            c_value->symbol = target;
+            c_value->targetHandle = route.handle;
+
+            _plugins[route.destinationIndex].delivery->push(c_value);
+        }
+    }
+
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        retVal = !plugin->delivery->failed() && retVal;
+    }
+
+    return retVal;
+}
+
+//! private support method - hands values to the plugin, batched if it supports it (called on the plugin's delivery worker)
+bool SimHubEventController::deliverToPlugin(simplug_vtable &pluginMethods, std::vector<GenericTLV *> &values)
+{
+    bool retVal = true;
+
+    if (values.empty()) {
+        return retVal;
+    }
+
+    if (pluginMethods.simplug_deliver_values) {
+        retVal = !pluginMethods.simplug_deliver_values(pluginMethods.plugin_instance, values.data(), values.size());
+    }
+    else if (pluginMethods.simplug_deliver_value) {
+        for (GenericTLV *value : values) {
+            retVal = !pluginMethods.simplug_deliver_value(pluginMethods.plugin_instance, value) && retVal;
+        }
     }
 
     return retVal;
 }
 
-// these callbacks will be called from the thread of the event
-// generator which is assumed to not be the thread of the for loop
-// below
+// this callback will be called from the thread of the event
+// generator which is assumed to not be the thread of the event loop -
+// each plugin has its own context so the callback knows its source
 
-void SimHubEventController::prepare3dEventCallback(SPHANDLE eventSource, void *eventData)
+void SimHubEventController::pluginEventCallback(PluginContext &plugin, void *eventData)
 {
     // event source will pass through NULL in event of error
     if (eventData) {
         GenericTLV *data = static_cast<GenericTLV *>(eventData);
         assert(data != NULL);
 
-        std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(data);
-        MapEntry *mapEntry;
+        plugin.eventsReceived->add();
 
-        if (_configManager->mapManager()->find(data->name, &mapEntry)) {
-            _eventQueue.push(attribute);
+        // plugins that were bound to the symbol table tag their events,
+        // anything else gets interned here on first sight
+        if (data->symbol == SYMBOL_UNRESOLVED) {
+            data->symbol = _symbols.intern(data->name);
+        }
+
+        if (data->symbol == SYMBOL_UNRESOLVED) {
+            // records carry no name, only a symbol - happens only once the table is full
+            logger.log(LOG_ERROR, "No symbol for %s, event dropped", data->name);
+            _unresolvedEvents->add();
+        }
+        else {
+            // unmapped elements fall back to the default routes, only events no plugin takes are filtered
+            bool mapped = !_routing.routes(data->symbol).empty();
+
+            if (mapped || _recorder) {
+                EventRecord event;
+                EventRecordFromCGeneric(data, event);
+
+                if (_recorder) {
+                    _recorder->append(event, _symbols.name(data->symbol), plugin.descriptor.name);
+                }
+
+                if (mapped) {
+                    enqueueEvent(event, _eventLanes.laneFor(data->symbol, _symbols.name(data->symbol), plugin.lane));
+                }
+            }
+
+            if (!mapped) {
+                _unmappedEvents->add();
+            }
         }
 
         release_generic(data);
     }
     else {
+        logger.log(LOG_ERROR, "Plugin %s reported an error", plugin.descriptor.name.c_str());
         ceaseEventLoop();
     }
 }
 
-void SimHubEventController::pokeyEventCallback(SPHANDLE eventSource, void *eventData)
+/**
+ * injects an event played back from an event log - it enters the
+ * pipeline as if the plugin that recorded it (if loaded) had produced
+ * it, so lanes and echo suppression behave as they did live
+ */
+void SimHubEventController::replayEvent(EventRecord &event, const std::string &source)
 {
-    // event source will pass through NULL in event of error
-    if (eventData) {
-        GenericTLV *data = static_cast<GenericTLV *>(eventData);
-        assert(data != NULL);
+    PluginContext *plugin = _plugins.find(source);
+
+    event.ownerPlugin = plugin ? plugin->methods.plugin_instance : NULL;
+
+    if (plugin) {
+        plugin->eventsReceived->add();
+    }
+
+    if (!_routing.routes(event.symbol).empty()) {
+        enqueueEvent(event, _eventLanes.laneFor(event.symbol, _symbols.name(event.symbol), plugin ? plugin->lane : -1));
+    }
+    else {
+        _unmappedEvents->add();
+    }
+}
+
+bool SimHubEventController::recordTo(const std::string &path)
+{
+    std::unique_ptr<EventLogWriter> recorder(new EventLogWriter());
+
+    if (!recorder->open(path)) {
+        logger.log(LOG_ERROR, "Could not create event log %s", path.c_str());
+        return false;
+    }
 
-        std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(data);
-        MapEntry *mapEntry;
+    logger.log(LOG_INFO, "Recording events to %s", path.c_str());
+    _recorder = std::move(recorder);
 
-        if (_configManager->mapManager()->find(data->name, &mapEntry)) {
-            _eventQueue.push(attribute);
+    return true;
+}
+
+bool SimHubEventController::replayFrom(const std::string &path, double speed, bool loop)
+{
+    std::unique_ptr<EventReplay> replay(new EventReplay(&_symbols, speed, loop));
+
+    if (!replay->open(path)) {
+        logger.log(LOG_ERROR, "%s is not a readable event log", path.c_str());
+        return false;
+    }
+
+    if (speed > 0) {
+        logger.log(LOG_INFO, "Replaying events from %s at %.2fx%s", path.c_str(), speed, loop ? " (looping)" : "");
+    }
+    else {
+        logger.log(LOG_INFO, "Replaying events from %s as fast as possible%s", path.c_str(), loop ? " (looping)" : "");
+    }
+
+    _replay = std::move(replay);
+
+    return true;
+}
+
+//! queues the event on lane, routing conflated elements through the conflation stage first
+void SimHubEventController::enqueueEvent(EventRecord &event, size_t lane)
+{
+    int64_t ingestTime = event.ingestTime;
+
+    if (_configManager->mapManager()->shouldConflate(event.symbol, _symbols.name(event.symbol))) {
+        if (!_conflation.offer(event)) {
+            // coalesced into the update already waiting in the queue
+            _latency.record(LATENCY_STAGE_ENQUEUE, ingestTime);
+            return;
         }
 
-        release_generic(data);
+        SymbolId symbol = event.symbol;
+
+        if (!_eventLanes.push(lane, std::move(event))) {
+            _conflation.cancel(symbol);
+        }
     }
     else {
-        ceaseEventLoop();
+        _eventLanes.push(lane, std::move(event));
     }
+
+    _latency.record(LATENCY_STAGE_ENQUEUE, ingestTime);
 }
 
 void SimHubEventController::LoggerWrapper(const int category, const char *msg, ...)
@@ -367,64 +710,152 @@ void SimHubEventController::LoggerWrapper(const int category, const char *msg, .
     logger.log(category, buff);
 }
 
-simplug_vtable SimHubEventController::loadPlugin(std::string dylibName, libconfig::Config *pluginConfig, EnqueueEventHandler eventCallback)
+/**
+ * loads, configures and preflights one plugin - safe to run for
+ * several plugins at once, eventing is only commenced by loadPlugins
+ * once every plugin is up
+ */
+bool SimHubEventController::loadPlugin(PluginContext &plugin)
 {
     SPHANDLE pluginInstance = NULL;
-    simplug_vtable pluginMethods;
+    std::string fullPath = _configManager->pluginDirectory() + "/" + plugin.descriptor.library + LIB_EXT;
 
-    memset(&pluginMethods, sizeof(simplug_vtable), 0);
+    if (!plugin.descriptor.configFile.empty()) {
+        try {
+            plugin.config.readFile(plugin.descriptor.configFile.c_str());
+            logger.log(LOG_INFO, "Loading %s configuration from %s", plugin.descriptor.name.c_str(), plugin.descriptor.configFile.c_str());
+        }
+        catch (const libconfig::FileIOException &fioex) {
+            logger.log(LOG_ERROR, "Could not read %s configuration %s", plugin.descriptor.name.c_str(), plugin.descriptor.configFile.c_str());
+            return false;
+        }
+        catch (const libconfig::ParseException &pex) {
+            logger.log(LOG_ERROR, "Config file parse error at %s:%d  - %s", pex.getFile(), pex.getLine(), pex.getError());
+            return false;
+        }
+    }
 
-    // TODO: use correct path
-    std::string fullPath("plugins/");
-    fullPath += dylibName + LIB_EXT;
-    int err = simplug_bootstrap(fullPath.c_str(), &pluginMethods);
+    if (simplug_bootstrap(fullPath.c_str(), &plugin.methods) != 0) {
+        logger.log(LOG_ERROR, "Could not load plugin %s from %s", plugin.descriptor.name.c_str(), fullPath.c_str());
+        return false;
+    }
 
-    if (err == 0) {
-        err = pluginMethods.simplug_init(&pluginInstance, SimHubEventController::LoggerWrapper);
+    plugin.methods.simplug_init(&pluginInstance, SimHubEventController::LoggerWrapper);
 
-        pluginMethods.plugin_instance = pluginInstance;
+    // plugins that support it share the core's element symbol table
+    if (plugin.methods.simplug_bind_symbol_table) {
+        plugin.methods.simplug_bind_symbol_table(pluginInstance, &_symbols);
+    }
 
-        // -- temporary solution to the plugin configuration conundrom:
-        //    - iterate over the list of libconfig::Setting instances we've
-        //    - been given for this plugin and pass them through
+    // and record their own stages into the core's latency histograms
+    if (plugin.methods.simplug_bind_latency_tracer) {
+        plugin.methods.simplug_bind_latency_tracer(pluginInstance, &_latency);
+    }
 
-        pluginMethods.simplug_config_passthrough(pluginInstance, pluginConfig);
+    // and register their own metrics to be served on /metrics
+    if (plugin.methods.simplug_bind_metrics) {
+        plugin.methods.simplug_bind_metrics(pluginInstance, &_metrics);
+    }
 
-        // TODO: add error checking
+    // -- temporary solution to the plugin configuration conundrom:
+    //    - iterate over the list of libconfig::Setting instances we've
+    //    - been given for this plugin and pass them through
 
-        if (pluginMethods.simplug_preflight_complete(pluginInstance) == 0) {
-            // proxy the C style lambda call through to the member
-            // function above
-            pluginMethods.simplug_commence_eventing(pluginInstance, eventCallback, this);
-        }
-        else {
-            pluginMethods.simplug_release(pluginInstance);
-            pluginMethods.plugin_instance = NULL;
-        }
+    plugin.methods.simplug_config_passthrough(pluginInstance, &plugin.config);
+
+    // TODO: add error checking
+
+    if (plugin.methods.simplug_preflight_complete(pluginInstance) != 0) {
+        logger.log(LOG_ERROR, "Plugin %s failed its preflight checks", plugin.descriptor.name.c_str());
+        plugin.methods.simplug_release(pluginInstance);
+        return false;
     }
 
-    return pluginMethods;
+    plugin.methods.plugin_instance = pluginInstance;
+
+    return true;
 }
 
-bool SimHubEventController::loadPrepare3dPlugin(void)
+/**
+ * loads every plugin listed in the configuration - plugins are
+ * independent so they are loaded and preflighted in parallel, startup
+ * takes as long as the slowest plugin rather than the sum of them all
+ *
+ * @return bool true if every plugin loaded, otherwise none is left loaded
+ */
+bool SimHubEventController::loadPlugins(void)
 {
-    auto prepare3dCallback = [](SPHANDLE eventSource, void *eventData, void *arg) { static_cast<SimHubEventController *>(arg)->prepare3dEventCallback(eventSource, eventData); };
+    std::vector<std::thread> loaders;
+    bool retVal = true;
 
-    _prepare3dMethods = loadPlugin("libprepare3d", _prepare3dDeviceConfig, prepare3dCallback);
+    for (PluginDescriptor &descriptor : _configManager->pluginDescriptors()) {
+        PluginContext *plugin = _plugins.add(descriptor, this);
 
-    return _prepare3dMethods.plugin_instance != NULL;
-}
+        if (!plugin) {
+            logger.log(LOG_ERROR, "Plugin %s is listed more than once. Skipping....", descriptor.name.c_str());
+            continue;
+        }
 
-bool SimHubEventController::loadPokeyPlugin(void)
-{
-    auto pokeyCallback = [](SPHANDLE eventSource, void *eventData, void *arg) { static_cast<SimHubEventController *>(arg)->pokeyEventCallback(eventSource, eventData); };
+        plugin->eventsReceived = &_metrics.counter("simhub_events_ingested_total", "Events received from a plugin", "plugin=\"" + descriptor.name + "\"");
+
+        if (!descriptor.lane.empty()) {
+            plugin->lane = _eventLanes.laneIndex(descriptor.lane);
+
+            if (plugin->lane < 0) {
+                logger.log(LOG_ERROR, "No event lane %s for plugin %s", descriptor.lane.c_str(), descriptor.name.c_str());
+            }
+        }
+
+        loaders.push_back(std::thread([this, plugin] { loadPlugin(*plugin); }));
+    }
+
+    for (std::thread &loader : loaders) {
+        loader.join();
+    }
+
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        retVal = plugin->loaded() && retVal;
+    }
+
+    // a replay can stand in for the input plugins, but not for a failed plugin
+    if (!retVal || (_plugins.size() == 0 && !_replay)) {
+        for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+            if (plugin->loaded()) {
+                plugin->methods.simplug_release(plugin->methods.plugin_instance);
+                plugin->methods.plugin_instance = NULL;
+            }
+        }
+
+        return false;
+    }
 
-    _pokeyMethods = loadPlugin("libpokey", _pokeyDeviceConfig, pokeyCallback);
+    // proxy the C style callback through to the member function above,
+    // the plugin's context comes back as the callback argument
+    auto eventCallback = [](SPHANDLE eventSource, void *eventData, void *arg) {
+        PluginContext *plugin = static_cast<PluginContext *>(arg);
+        static_cast<SimHubEventController *>(plugin->host)->pluginEventCallback(*plugin, eventData);
+    };
 
-    return _pokeyMethods.plugin_instance != NULL;
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        PluginContext *context = plugin.get();
+
+        context->delivery.reset(new DeliveryWorker(context->descriptor.name, context->descriptor.delivery,
+            [this, context](std::vector<GenericTLV *> &values) { return deliverToPlugin(context->methods, values); }));
+        context->delivery->start();
+    }
+
+    // events are filtered against the routes as soon as the plugins produce them
+    compileRoutes();
+
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        plugin->methods.simplug_commence_eventing(plugin->methods.plugin_instance, eventCallback, plugin.get());
+        logger.log(LOG_INFO, "Plugin %s loaded (delivery queue %lu)", plugin->descriptor.name.c_str(), plugin->descriptor.delivery.queueDepth);
+    }
+
+    return true;
 }
 
-//! perform shutdown ceremonies on both plugins - this unloads both plugins
+//! perform shutdown ceremonies on every plugin - this unloads them all
 void SimHubEventController::terminate(void)
 {
     assert(_running);
@@ -433,13 +864,65 @@ void SimHubEventController::terminate(void)
     ceaseSustainThread();
 #endif
 
+    // stop the sources that are not plugins first
+    if (_replay) {
+        _replay->stop();
+        logger.log(LOG_INFO, "Replayed %llu event(s)%s", (unsigned long long)_replay->replayed(), _replay->finished() ? ", whole log" : "");
+    }
+
     // kill web configuration listener
     auto listenerCloseTask = _configurationHTTPListener->close();
     listenerCloseTask.wait();
 
-    shutdownPlugin(_prepare3dMethods);
-    shutdownPlugin(_pokeyMethods);
-    
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        // the worker may be inside the plugin, stop it before the plugin goes away
+        if (plugin->delivery) {
+            plugin->delivery->stop();
+        }
+
+        shutdownPlugin(plugin->methods);
+        logger.log(LOG_INFO, "Plugin %s: %llu event(s) received", plugin->descriptor.name.c_str(), (unsigned long long)plugin->eventsReceived->value());
+
+        if (plugin->delivery) {
+            DeliveryWorker &delivery = *plugin->delivery;
+
+            logger.log(LOG_INFO, " - delivered %llu value(s), dropped %llu, %llu failed batch(es)", (unsigned long long)delivery.delivered(),
+                (unsigned long long)delivery.dropped(), (unsigned long long)delivery.failedBatches());
+            logger.log(LOG_INFO, " - queue wait mean %lluus max %lluus, plugin call mean %lluus max %lluus", (unsigned long long)delivery.queueLatency().meanNanos() / 1000,
+                (unsigned long long)delivery.queueLatency().maxNanos() / 1000, (unsigned long long)delivery.deliveryLatency().meanNanos() / 1000,
+                (unsigned long long)delivery.deliveryLatency().maxNanos() / 1000);
+        }
+    }
+
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        HdrHistogram &histogram = _latency.histogram((LatencyStage)stage);
+
+        logger.log(LOG_INFO, "Latency %s: %llu event(s), p50 %lluus p99 %lluus p99.9 %lluus max %lluus", LatencyTracer::StageName((LatencyStage)stage),
+            (unsigned long long)histogram.count(), (unsigned long long)histogram.percentile(50.0) / 1000, (unsigned long long)histogram.percentile(99.0) / 1000,
+            (unsigned long long)histogram.percentile(99.9) / 1000, (unsigned long long)histogram.max() / 1000);
+    }
+
+    for (size_t lane = 0; lane < _eventLanes.laneCount(); lane++) {
+        LatencyStats &queueWait = _eventLanes.queueWait(lane);
+
+        logger.log(LOG_INFO, "Event lane %s: %llu event(s), queue wait mean %lluus max %lluus, %llu dropped on overflow", _eventLanes.options(lane).name.c_str(),
+            (unsigned long long)queueWait.count(), (unsigned long long)queueWait.meanNanos() / 1000, (unsigned long long)queueWait.maxNanos() / 1000,
+            (unsigned long long)_eventLanes.droppedCount(lane));
+    }
+
+    if (_conflation.coalescedCount() > 0) {
+        logger.log(LOG_INFO, "Conflation coalesced %llu update(s)", _conflation.coalescedCount());
+
+        for (std::pair<SymbolId, uint64_t> entry : _conflation.coalescedCounts()) {
+            logger.log(LOG_INFO, " - %s: %llu", _symbols.name(entry.first).c_str(), entry.second);
+        }
+    }
+
+    if (_recorder) {
+        logger.log(LOG_INFO, "Recorded %llu event(s), %lu byte(s)", (unsigned long long)_recorder->eventCount(), _recorder->size());
+        _recorder->close();
+    }
+
     _running = false;
 }
 
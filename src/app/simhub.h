@@ -7,14 +7,26 @@
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <type_traits>
+#include <vector>
 #include <sstream>
 #include <cpprest/http_listener.h>
 
 #include "plugins/common/utils.h"
 #include "elements/attributes/attribute.h"
 #include "plugins/common/simhubdeviceplugin.h"
+#include "plugins/common/latencytracer.h"
+#include "plugins/common/metrics.h"
+#include "plugins/common/symboltable.h"
 #include "common/support/threadmanager.h"
+#include "common/conflation/conflationStage.h"
+#include "common/lanes/eventLanes.h"
+#include "common/recorder/eventLog.h"
+#include "common/recorder/eventReplay.h"
+#include "common/registry/pluginRegistry.h"
+#include "common/routing/routingTable.h"
 #include "queue/concurrent_queue.h"
+#include "queue/ring_queue.h"
 
 #if defined(_AWS_SDK)
 #include "aws/aws.h"
@@ -22,6 +34,9 @@
 
 class ConfigManager; // forward reference
 
+//! converts a libconfig file into the JSON config handed to plugins
+std::string libconfigToJSON(std::string configFilename);
+
 /**
  * Base of the simhub app controller logic
  *
@@ -29,11 +44,44 @@ class ConfigManager; // forward reference
  *   (on a separate thread) when the plugin generates an event
  *
  * - the lambda callback then uses the final arg of the callback, a
- *   void * to 'this' that was passed to the plugin when it registered
- *   the callback stub, to call into the proper 'eventCallback' member
+ *   void * to the plugin's PluginContext that was passed to the plugin
+ *   when it registered the callback stub, to call into the
+ *   'pluginEventCallback' member of the context's host
  */
  
- typedef std::pair<std::chrono::milliseconds, std::shared_ptr<Attribute>> SustainMapEntry;
+ typedef std::pair<std::chrono::milliseconds, EventRecord> SustainMapEntry;
+
+#define DEFAULT_EVENT_BATCH_SIZE 1
+#define DEFAULT_EVENT_BATCH_LINGER 0
+
+/**
+ * non-owning view over a run of events drained from the event queue in
+ * one go - only valid for the duration of the processor call
+ */
+class EventSpan
+{
+protected:
+    EventRecord *_events;
+    size_t _size;
+
+public:
+    EventSpan(EventRecord *events, size_t size)
+        : _events(events)
+        , _size(size){};
+
+    EventRecord *begin(void) { return _events; }
+    EventRecord *end(void) { return _events + _size; }
+    EventRecord &operator[](size_t index) { return _events[index]; }
+    size_t size(void) { return _size; }
+    bool empty(void) { return _size == 0; }
+};
+
+//! true_type when F can be called with a whole EventSpan rather than a single event
+template <class F, class = void> struct IsBatchEventProcessor : std::false_type {
+};
+
+template <class F> struct IsBatchEventProcessor<F, decltype((void)std::declval<F &>()(std::declval<EventSpan &>()))> : std::true_type {
+};
 
 class SimHubEventController
 {
@@ -43,57 +91,75 @@ protected:
 protected:
     SimHubEventController(void);
 
-    void prepare3dEventCallback(SPHANDLE eventSource, void *eventData);
-    void pokeyEventCallback(SPHANDLE eventSource, void *eventData);
-    simplug_vtable loadPlugin(std::string dylibName, libconfig::Config *pluginConfigs, EnqueueEventHandler eventCallback);
+    void pluginEventCallback(PluginContext &plugin, void *eventData);
+    void enqueueEvent(EventRecord &event, size_t lane);
+    void replayEvent(EventRecord &event, const std::string &source);
+    bool loadPlugin(PluginContext &plugin);
     void terminate(void);
     void shutdownPlugin(simplug_vtable &pluginMethods);
     void startSustainThread(void);
     void ceaseSustainThread(void);
-
-    ConcurrentQueue<std::shared_ptr<Attribute>> _eventQueue;
-    simplug_vtable _prepare3dMethods;
-    simplug_vtable _pokeyMethods;
+    bool deliverToPlugin(simplug_vtable &pluginMethods, std::vector<GenericTLV *> &values);
+    void compileRoutes(void);
+    void registerMetrics(void);
+
+    //! batch-aware processors get the whole span
+    template <class F> bool processEvents(F &eventProcessorFunctor, EventSpan &events, std::true_type);
+    //! single-event processors are called once per event in the span
+    template <class F> bool processEvents(F &eventProcessorFunctor, EventSpan &events, std::false_type);
+
+    EventLanes _eventLanes;
+    ConflationStage _conflation;
+    SymbolTable _symbols;
+    LatencyTracer _latency;
+    MetricsRegistry _metrics;
+    MetricCounter *_unresolvedEvents;
+    MetricCounter *_unmappedEvents;
+    MetricCounter *_echoedEvents;
+    std::unique_ptr<EventLogWriter> _recorder;
+    std::unique_ptr<EventReplay> _replay;
+    PluginRegistry _plugins;
+    RoutingTable _routing;
     ConfigManager *_configManager;
+    size_t _eventBatchSize;
+    std::chrono::microseconds _eventBatchLinger;
 
 #if defined(_AWS_SDK)
     CancelableThreadManager _sustainThreadManager;
-    std::map<std::string, SustainMapEntry> _sustainValues;
+    std::map<SymbolId, SustainMapEntry> _sustainValues;
     std::mutex _sustainValuesMutex;
 #endif
 
     bool _running;
 
-    // -- temp solution to plugin device configuration conundrum
-    libconfig::Config *_pokeyDeviceConfig;
-    libconfig::Config *_prepare3dDeviceConfig;
-
     //! implements configuration server
     std::shared_ptr<web::http::experimental::listener::http_listener> _configurationHTTPListener;
     std::string _httpListenAddress;
     size_t _httpListenPort;
+    virtual void httpGETHandler(web::http::http_request request);
     virtual void httpGETConfigurationHandler(web::http::http_request request);
+    virtual void httpGETLatencyHandler(web::http::http_request request);
+    virtual void httpGETMetricsHandler(web::http::http_request request);
     virtual void startHTTPListener(void);
 
 public:
     virtual ~SimHubEventController(void);
-    bool loadPrepare3dPlugin(void);
-    bool loadPokeyPlugin(void);
-    bool deliverValue(std::shared_ptr<Attribute> value);
+    bool loadPlugins(void);
+    bool deliverValue(EventRecord value);
+    bool deliverValues(EventSpan &events);
     void setConfigManager(ConfigManager *configManager);
-
-    // -- temp solution to plugin device configuration conundrum
-    void setPrepare3dConfig(libconfig::Config *prepare3dConfig)
-    {
-        assert(prepare3dConfig != NULL);
-        _prepare3dDeviceConfig = prepare3dConfig;
-    };
-    
-    void setPokeyConfig(libconfig::Config *pokeyConfig)
-    {
-        assert(pokeyConfig != NULL);
-        _pokeyDeviceConfig = pokeyConfig;
-    };
+    //! records every event the plugins produce to the event log at path
+    bool recordTo(const std::string &path);
+    //! plays the event log at path into the event loop once it runs - speed 0 is as fast as possible
+    bool replayFrom(const std::string &path, double speed, bool loop);
+
+    //! process-wide element name table, shared with the plugins
+    SymbolTable *symbolTable(void) { return &_symbols; };
+    //! per stage end to end latency histograms, shared with the plugins
+    LatencyTracer *latencyTracer(void) { return &_latency; };
+    std::string latencyJSON(void);
+    //! counters, gauges and summaries served on /metrics, shared with the plugins
+    MetricsRegistry *metrics(void) { return &_metrics; };
 
     template <class F> void runEventLoop(F &&eventProcessorFunctor);
 
@@ -104,7 +170,8 @@ public:
 
     void enablePolly(void);
     void enableKinesis(void);
-    void deliverKinesisValue(std::shared_ptr<Attribute> value);
+    void deliverKinesisValue(const EventRecord &value);
+    void deliverKinesisValues(EventSpan &events);
 #endif
 
 public:
@@ -114,13 +181,22 @@ public:
 };
 
 //! TODO - add perpetual and cancelable loop
-// - currently just waits on the concurrent event queue
-//   -> when another thread pushes an event on the queue, this thread
-//      will awake and pop the event
+// - currently just waits on the event lanes
+//   -> when another thread pushes an event on a lane, this thread
+//      will awake and drain up to _eventBatchSize events (waiting at
+//      most _eventBatchLinger for the batch to fill) in one go, taking
+//      from the lanes in priority order
+//
+// - eventProcessorFunctor can either take an EventSpan & (batch mode)
+//   or a single EventRecord & - either way it returns
+//   false to stop the loop
 
 template <class F> void SimHubEventController::runEventLoop(F &&eventProcessorFunctor)
 {
     bool breakLoop = false;
+    std::vector<EventRecord> batch;
+
+    batch.reserve(_eventBatchSize);
 
     _running = true;
 
@@ -128,12 +204,26 @@ template <class F> void SimHubEventController::runEventLoop(F &&eventProcessorFu
     startSustainThread();
 #endif
 
+    registerMetrics();
     startHTTPListener();
 
+    if (_replay) {
+        _replay->start([this](EventRecord &event, const std::string &source) { replayEvent(event, source); });
+    }
+
     while (!breakLoop) {
         try {
-            std::shared_ptr<Attribute> data = _eventQueue.pop();
-            breakLoop = !eventProcessorFunctor(data);
+            batch.clear();
+            _eventLanes.popBatch(batch, _eventBatchSize, _eventBatchLinger);
+
+            // conflated elements deliver their latest pending value
+            for (EventRecord &event : batch) {
+                _conflation.claim(event);
+                _latency.record(LATENCY_STAGE_DEQUEUE, event.ingestTime);
+            }
+
+            EventSpan events(batch.data(), batch.size());
+            breakLoop = !processEvents(eventProcessorFunctor, events, IsBatchEventProcessor<F>());
         }
         catch (ConcurrentQueueInterrupted &queueException) {
             breakLoop = true;
@@ -143,4 +233,20 @@ template <class F> void SimHubEventController::runEventLoop(F &&eventProcessorFu
     terminate();
 }
 
+template <class F> bool SimHubEventController::processEvents(F &eventProcessorFunctor, EventSpan &events, std::true_type)
+{
+    return eventProcessorFunctor(events);
+}
+
+template <class F> bool SimHubEventController::processEvents(F &eventProcessorFunctor, EventSpan &events, std::false_type)
+{
+    for (EventRecord &event : events) {
+        if (!eventProcessorFunctor(event)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 #endif
@@ -0,0 +1,57 @@
+#include <atomic>
+#include <stddef.h>
+
+#include "alloc_counter.h"
+
+static std::atomic<uint64_t> Allocations(0);
+
+#if defined(build_linux)
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    Allocations.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+}
+
+bool AllocationCountingAvailable(void)
+{
+    return true;
+}
+
+#else
+
+bool AllocationCountingAvailable(void)
+{
+    return false;
+}
+
+#endif
+
+uint64_t AllocationCount(void)
+{
+    return Allocations.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,15 @@
+#ifndef __ALLOC_COUNTER_H
+#define __ALLOC_COUNTER_H
+
+#include <stdint.h>
+
+/**
+ * counts calls into the system allocator (malloc, calloc, realloc)
+ * made by the benchmark process - only available where the libc
+ * allocator can be interposed (glibc), elsewhere counting is reported
+ * as unavailable
+ */
+bool AllocationCountingAvailable(void);
+uint64_t AllocationCount(void);
+
+#endif
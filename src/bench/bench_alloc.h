@@ -0,0 +1,97 @@
+#ifndef __BENCH_ALLOC_H
+#define __BENCH_ALLOC_H
+
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench_harness.h"
+#include "elements/attributes/attribute.h"
+
+static int AllocBenchOwner;
+
+//! pre-pool make_generic - calloc for the struct and each string
+GenericTLV *LegacyMakeGeneric(const char *name, const char *description)
+{
+    GenericTLV *retVal = (GenericTLV *)calloc(sizeof(GenericTLV), 1);
+
+    dupe_string(&(retVal->name), name);
+    dupe_string(&(retVal->description), description);
+
+    return retVal;
+}
+
+void LegacyReleaseGeneric(GenericTLV *generic)
+{
+    free(generic->name);
+    free(generic->description);
+    free(generic);
+}
+
+/**
+ * one event through the pre-pool path: the plugin builds a generic, the
+ * core turns it into a new()ed Attribute and releases the generic, on
+ * delivery the Attribute is marshalled back into a generic for the
+ * destination plugin
+ */
+void LegacyEventCycle(const char *name, int value)
+{
+    GenericTLV *ingest = LegacyMakeGeneric(name, "-");
+    ingest->ownerPlugin = &AllocBenchOwner;
+    ingest->value.int_value = value;
+
+    std::shared_ptr<Attribute> attribute(new Attribute(ingest->ownerPlugin));
+    attribute->setValue<int>(ingest->value.int_value);
+    attribute->setType(INT_ATTRIBUTE);
+    attribute->setName(ingest->name);
+    LegacyReleaseGeneric(ingest);
+
+    GenericTLV *delivery = LegacyMakeGeneric(attribute->name().c_str(), "-");
+    delivery->value.int_value = attribute->value<int>();
+    LegacyReleaseGeneric(delivery);
+}
+
+//! the same event through the pooled helpers
+void PooledEventCycle(const char *name, int value)
+{
+    GenericTLV *ingest = make_generic(name, "-");
+    ingest->ownerPlugin = &AllocBenchOwner;
+    ingest->value.int_value = value;
+
+    std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(ingest);
+    release_generic(ingest);
+
+    GenericTLV *delivery = AttributeToCGeneric(attribute);
+    release_generic(delivery);
+}
+
+//! the same event as the core carries it - a fixed size record named by its symbol
+void RecordEventCycle(const char *name, int value)
+{
+    GenericTLV *ingest = make_generic(name, "-");
+    ingest->ownerPlugin = &AllocBenchOwner;
+    ingest->value.int_value = value;
+
+    EventRecord record;
+    EventRecordFromCGeneric(ingest, record);
+    release_generic(ingest);
+
+    GenericTLV *delivery = EventRecordToCGeneric(record, name);
+    release_generic(delivery);
+}
+
+//! system allocator calls (and time) per event before and after pooling
+void EventAllocationBenchmark(BenchReport &report)
+{
+    // short names fit std::string's small buffer, long ones do not
+    const char *names[] = {"G_GEAR", "N_ELEC_PANEL_LOWER_LEFT"};
+
+    for (const char *name : names) {
+        report.add(RunBenchmark("alloc", "legacy", name, [&](uint64_t i) { LegacyEventCycle(name, (int)i); }));
+        report.add(RunBenchmark("alloc", "pooled", name, [&](uint64_t i) { PooledEventCycle(name, (int)i); }));
+        report.add(RunBenchmark("alloc", "record", name, [&](uint64_t i) { RecordEventCycle(name, (int)i); }));
+    }
+}
+
+#endif
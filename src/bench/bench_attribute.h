@@ -0,0 +1,72 @@
+#ifndef __BENCH_ATTRIBUTE_H
+#define __BENCH_ATTRIBUTE_H
+
+#include <memory>
+#include <string>
+
+#include "bench_harness.h"
+#include "elements/attributes/attribute.h"
+
+static int AttributeBenchOwner;
+
+//! a generic as a plugin hands it to the core
+GenericTLV *AttributeBenchGeneric(const char *name, ConfigType type)
+{
+    GenericTLV *retVal = make_generic(name, "-");
+
+    retVal->ownerPlugin = &AttributeBenchOwner;
+    retVal->type = type;
+
+    switch (type) {
+    case CONFIG_FLOAT:
+        retVal->value.float_value = 1234.5f;
+        retVal->length = sizeof(float);
+        break;
+    case CONFIG_STRING:
+        generic_set_string(retVal, &(retVal->value.string_value), "ILS 109.50");
+        retVal->length = strlen(retVal->value.string_value);
+        break;
+    case CONFIG_BOOL:
+        retVal->value.bool_value = 1;
+        retVal->length = sizeof(uint8_t);
+        break;
+    default:
+        retVal->value.int_value = 4200;
+        retVal->length = sizeof(int);
+        break;
+    }
+
+    return retVal;
+}
+
+/**
+ * the C <-> C++ marshalling done for every event the core ingests and
+ * delivers, plus the value formatting the plugins use on delivery
+ */
+void AttributeMarshallingBenchmark(BenchReport &report)
+{
+    struct {
+        const char *name;
+        ConfigType type;
+        const char *variant;
+    } elements[] = {{"N_MIP_FLAPS", CONFIG_INT, "int"}, {"G_MIP_ALTITUDE", CONFIG_FLOAT, "float"}, {"B_OH_BATTERY", CONFIG_BOOL, "bool"}, {"V_FMC_LINE_1", CONFIG_STRING, "string"}};
+
+    for (auto &element : elements) {
+        GenericTLV *generic = AttributeBenchGeneric(element.name, element.type);
+        std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(generic);
+
+        report.add(RunBenchmark("attribute", "AttributeFromCGeneric", element.variant, [&](uint64_t) { BenchKeep(AttributeFromCGeneric(generic)); }));
+
+        report.add(RunBenchmark("attribute", "AttributeToCGeneric", element.variant, [&](uint64_t) {
+            GenericTLV *delivery = AttributeToCGeneric(attribute);
+            BenchKeep(delivery);
+            release_generic(delivery);
+        }));
+
+        report.add(RunBenchmark("attribute", "valueToString", element.variant, [&](uint64_t) { BenchKeep(attribute->valueToString()); }));
+
+        release_generic(generic);
+    }
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef __BENCH_CONFIG_H
+#define __BENCH_CONFIG_H
+
+#include <fstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_harness.h"
+#include "configmanager/mappingConfigManager/mappingConfigManager.h"
+#include "simhub.h"
+
+#define MAPPING_BENCH_ENTRIES 512
+
+//! writes a mapping file with count entries and returns its path, empty on failure
+std::string WriteBenchMappingFile(std::vector<std::string> &sources, int count)
+{
+    char path[] = "/tmp/simhub_bench_mappingXXXXXX";
+    int fd = mkstemp(path);
+
+    if (fd < 0) {
+        return "";
+    }
+
+    close(fd);
+
+    std::ofstream file(path);
+
+    file << "version=\"1.1\"\n\nmapping = (\n";
+
+    for (int i = 0; i < count; i++) {
+        char source[32];
+
+        snprintf(source, sizeof(source), "N_BENCH_ELEMENT_%04d", i);
+        sources.push_back(source);
+
+        file << (i ? ",\n" : "") << "    { source = \"" << source << "\", target = \"" << source << "_OUT\" }";
+    }
+
+    file << "\n)\n";
+
+    return path;
+}
+
+//! mapping lookups by name (as the http handlers do) and by symbol (as the event path does)
+void MappingFindBenchmark(BenchReport &report)
+{
+    std::vector<std::string> sources;
+    std::string path = WriteBenchMappingFile(sources, MAPPING_BENCH_ENTRIES);
+
+    if (path.empty()) {
+        printf("unable to write the benchmark mapping file\n");
+        return;
+    }
+
+    SymbolTable symbols;
+    MappingConfigManager mapping(path, &symbols);
+
+    mapping.init();
+    unlink(path.c_str());
+
+    std::vector<SymbolId> sourceSymbols;
+
+    for (std::string &source : sources) {
+        sourceSymbols.push_back(symbols.intern(source));
+    }
+
+    std::string variant = std::to_string(MAPPING_BENCH_ENTRIES) + " mappings";
+    MapEntry *entry = NULL;
+
+    report.add(RunBenchmark("mapping", "find(name)", variant, [&](uint64_t i) {
+        mapping.find(sources[i % sources.size()], &entry);
+        BenchKeep(entry);
+    }));
+
+    report.add(RunBenchmark("mapping", "find(name) unmapped", variant, [&](uint64_t) {
+        mapping.find("N_BENCH_UNMAPPED", &entry);
+        BenchKeep(entry);
+    }));
+
+    report.add(RunBenchmark("mapping", "find(symbol)", variant, [&](uint64_t i) {
+        mapping.find(sourceSymbols[i % sourceSymbols.size()], &entry);
+        BenchKeep(entry);
+    }));
+}
+
+//! the conversion run on every plugin's config file at load
+void LibconfigToJSONBenchmark(BenchReport &report)
+{
+    const char *configFiles[] = {"config/config.cfg", "config/pokey.cfg", "config/prepare3d.cfg"};
+
+    for (const char *configFile : configFiles) {
+        if (access(configFile, R_OK) != 0) {
+            printf("%s not found - run the benchmarks from the bin directory\n", configFile);
+            continue;
+        }
+
+        report.add(RunBenchmark("config", "libconfigToJSON", configFile, [&](uint64_t) { BenchKeep(libconfigToJSON(configFile)); }));
+    }
+}
+
+#endif
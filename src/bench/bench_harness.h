@@ -0,0 +1,193 @@
+#ifndef __BENCH_HARNESS_H
+#define __BENCH_HARNESS_H
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "alloc_counter.h"
+
+//! each timed benchmark runs for at least this long
+#define BENCH_MIN_DURATION std::chrono::milliseconds(250)
+#define BENCH_WARMUP_OPERATIONS 1000
+
+//! one measured run - a benchmark name plus the variant (producer count, element name, ...) it was run with
+struct BenchResult {
+    std::string suite;
+    std::string name;
+    std::string variant;
+    uint64_t operations;
+    double seconds;
+    double allocsPerOp; ///< negative when allocations were not counted
+    uint64_t bytesPerOp; ///< input consumed by each operation, 0 if it does not apply
+
+    BenchResult(void)
+        : operations(0)
+        , seconds(0)
+        , allocsPerOp(-1)
+        , bytesPerOp(0){};
+
+    double nsPerOp(void) const { return operations ? seconds * 1e9 / operations : 0; };
+    double opsPerSecond(void) const { return seconds > 0 ? operations / seconds : 0; };
+    double megabytesPerSecond(void) const { return opsPerSecond() * bytesPerOp / (1024 * 1024); };
+};
+
+/**
+ * collects the results of a bench run, prints them as they come in
+ * and writes them out as JSON so runs can be compared by tools
+ */
+class BenchReport
+{
+protected:
+    std::vector<BenchResult> _results;
+
+    static std::string JSONString(const std::string &value)
+    {
+        std::string retVal = "\"";
+
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                retVal += '\\';
+            }
+
+            retVal += c;
+        }
+
+        return retVal + "\"";
+    }
+
+public:
+    //! prints the heading of a suite's table
+    void begin(const std::string &suite)
+    {
+        std::cout << "-- " << suite << std::endl;
+        printf("%-28s %-28s %14s %16s %12s %10s\n", "benchmark", "variant", "ns/op", "ops/sec", "allocs/op", "MB/s");
+    }
+
+    void add(const BenchResult &result)
+    {
+        char allocs[32] = "-";
+        char throughput[32] = "-";
+
+        _results.push_back(result);
+
+        if (result.allocsPerOp >= 0) {
+            snprintf(allocs, sizeof(allocs), "%.2f", result.allocsPerOp);
+        }
+
+        if (result.bytesPerOp > 0) {
+            snprintf(throughput, sizeof(throughput), "%.1f", result.megabytesPerSecond());
+        }
+
+        printf("%-28s %-28s %14.1f %16.0f %12s %10s\n", result.name.c_str(), result.variant.c_str(), result.nsPerOp(), result.opsPerSecond(), allocs, throughput);
+    }
+
+    const std::vector<BenchResult> &results(void) const { return _results; };
+
+    std::string json(void) const
+    {
+        std::ostringstream oss;
+
+        oss << "{\"benchmarks\":[";
+
+        for (size_t i = 0; i < _results.size(); i++) {
+            const BenchResult &result = _results[i];
+
+            oss << (i ? "," : "") << "\n  {\"suite\":" << JSONString(result.suite) << ",\"name\":" << JSONString(result.name) << ",\"variant\":" << JSONString(result.variant)
+                << ",\"operations\":" << result.operations << ",\"seconds\":" << result.seconds << ",\"ns_per_op\":" << result.nsPerOp() << ",\"ops_per_sec\":" << result.opsPerSecond()
+                << ",\"allocs_per_op\":";
+
+            if (result.allocsPerOp < 0) {
+                oss << "null";
+            }
+            else {
+                oss << result.allocsPerOp;
+            }
+
+            if (result.bytesPerOp > 0) {
+                oss << ",\"bytes_per_op\":" << result.bytesPerOp << ",\"mb_per_sec\":" << result.megabytesPerSecond();
+            }
+
+            oss << "}";
+        }
+
+        oss << "\n]}\n";
+
+        return oss.str();
+    }
+
+    //! path "-" writes to stdout
+    bool writeJSON(const std::string &path) const
+    {
+        if (path == "-") {
+            std::cout << json();
+            return true;
+        }
+
+        std::ofstream file(path);
+
+        if (!file) {
+            return false;
+        }
+
+        file << json();
+
+        return file.good();
+    }
+};
+
+//! keeps the compiler from optimising away a benchmarked result
+template <typename T> inline void BenchKeep(const T &value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * calls op(iteration) in doubling batches until BENCH_MIN_DURATION has
+ * passed, after a short warm up so pools and caches are primed -
+ * allocations are counted over the measured batches where the platform
+ * allows it
+ */
+template <typename F> BenchResult RunBenchmark(const std::string &suite, const std::string &name, const std::string &variant, F op)
+{
+    BenchResult retVal;
+    uint64_t iteration = 0;
+    uint64_t batch = 1;
+
+    retVal.suite = suite;
+    retVal.name = name;
+    retVal.variant = variant;
+
+    for (; iteration < BENCH_WARMUP_OPERATIONS; iteration++) {
+        op(iteration);
+    }
+
+    uint64_t allocationsBefore = AllocationCount();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration elapsed(0);
+
+    while (elapsed < BENCH_MIN_DURATION) {
+        for (uint64_t i = 0; i < batch; i++, iteration++) {
+            op(iteration);
+        }
+
+        retVal.operations += batch;
+        batch *= 2;
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    retVal.seconds = std::chrono::duration<double>(elapsed).count();
+
+    if (AllocationCountingAvailable()) {
+        retVal.allocsPerOp = (double)(AllocationCount() - allocationsBefore) / retVal.operations;
+    }
+
+    return retVal;
+}
+
+#endif
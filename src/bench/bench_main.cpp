@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string.h>
+#include <vector>
+
+#include "bench_alloc.h"
+#include "bench_attribute.h"
+#include "bench_config.h"
+#include "bench_harness.h"
+#include "bench_plugins.h"
+#include "bench_queue.h"
+#include "bench_scanner.h"
+
+typedef void (*BenchSuite)(BenchReport &report);
+
+/**
+ * simhub micro benchmarks - run from the bin directory like the
+ * tests so relative config paths resolve
+ *
+ * simhub_bench [--json <file|->] [suite ...]
+ *
+ * runs every suite unless some are named, results are printed as a
+ * table and optionally written as JSON
+ */
+int main(int argc, char **argv)
+{
+    struct {
+        const char *name;
+        BenchSuite run;
+    } suites[] = {{"queue", QueueContentionBenchmark},       {"alloc", EventAllocationBenchmark},   {"attribute", AttributeMarshallingBenchmark},
+                  {"mapping", MappingFindBenchmark},         {"config", LibconfigToJSONBenchmark},  {"scanner", DelimiterScanBenchmark},
+                  {"prepare3d", Prepare3dParseBenchmark},    {"pokey", PokeyPinDiffBenchmark}};
+
+    std::string jsonPath;
+    std::vector<std::string> selected;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        }
+        else {
+            selected.push_back(argv[i]);
+        }
+    }
+
+    BenchReport report;
+
+    for (auto &suite : suites) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), suite.name) == selected.end()) {
+            continue;
+        }
+
+        report.begin(suite.name);
+        suite.run(report);
+    }
+
+    if (!jsonPath.empty() && !report.writeJSON(jsonPath)) {
+        std::cerr << "unable to write " << jsonPath << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
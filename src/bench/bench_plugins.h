@@ -0,0 +1,18 @@
+#ifndef __BENCH_PLUGINS_H
+#define __BENCH_PLUGINS_H
+
+#include "bench_harness.h"
+
+/*
+ * plugin side benchmarks live in their own translation units - the
+ * plugin support headers and the core's logger both define the log
+ * categories so they cannot share one
+ */
+
+//! prepare3d ProSim buffer parsing
+void Prepare3dParseBenchmark(BenchReport &report);
+
+//! PokeyDevice digital input diff against an in memory device
+void PokeyPinDiffBenchmark(BenchReport &report);
+
+#endif
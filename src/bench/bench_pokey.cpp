@@ -0,0 +1,54 @@
+#include <string.h>
+#include <vector>
+
+#include "bench_plugins.h"
+#include "pokey/pokeyPinState.h"
+
+#define POKEY_BENCH_PINS 55
+
+/**
+ * the pin scan of the digital input timer against an in memory device,
+ * the pin table mixes inputs and outputs like a configured panel does
+ */
+void PokeyPinDiffBenchmark(BenchReport &report)
+{
+    sPoKeysDevice device;
+    std::vector<sPoKeysPinData> devicePins(POKEY_BENCH_PINS);
+    device_port_t pins[POKEY_BENCH_PINS];
+    PokeyPinState pinState;
+    std::vector<int> changed;
+
+    memset(&device, 0, sizeof(device));
+    memset(devicePins.data(), 0, devicePins.size() * sizeof(sPoKeysPinData));
+    device.info.iPinCount = POKEY_BENCH_PINS;
+    device.Pins = devicePins.data();
+
+    for (int i = 0; i < POKEY_BENCH_PINS; i++) {
+        pins[i].pinName = "PIN_" + std::to_string(i + 1);
+        pins[i].pinNumber = i + 1;
+        pins[i].pinIndex = i;
+        pins[i].type = i % 4 == 3 ? PIN_TYPE_DIGITAL_OUTPUT : PIN_TYPE_DIGITAL_INPUT;
+        pins[i].defaultValue = 0;
+    }
+
+    pinState.configure(pins, POKEY_BENCH_PINS);
+
+    std::string variant = std::to_string(pinState.inputPinCount()) + " inputs";
+
+    report.add(RunBenchmark("pokey", "pin diff unchanged", variant, [&](uint64_t) {
+        changed.clear();
+        BenchKeep(pinState.diff(&device, changed));
+    }));
+
+    // every input differs from its last reported value - the worst case
+    for (sPoKeysPinData &pin : devicePins) {
+        pin.DigitalValueGet = 1;
+    }
+
+    report.add(RunBenchmark("pokey", "pin diff all changed", variant, [&](uint64_t) {
+        changed.clear();
+        BenchKeep(pinState.diff(&device, changed));
+    }));
+
+    report.add(RunBenchmark("pokey", "configure", std::to_string(POKEY_BENCH_PINS) + " pins", [&](uint64_t) { pinState.configure(pins, POKEY_BENCH_PINS); }));
+}
@@ -0,0 +1,233 @@
+#include <algorithm>
+#include <functional>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+
+#include "bench_plugins.h"
+#include "bench_prosim_stream.h"
+#include "common/simhubdeviceplugin.h"
+#include "elements/attributes/attribute.h"
+#include "prepare3d/main.h"
+
+#define PREPARE3D_BENCH_LEGACY_BUFFER_LEN 4096
+#define PREPARE3D_BENCH_LEGACY_MAX_ELEMENTS 1024
+
+//! the type lookup before the dispatch table
+static const char *LegacyElementDataType(char identifier)
+{
+    switch (identifier) {
+    case 'G':
+    case 'E':
+        return "float";
+    case 'N':
+        return "int";
+    case 'V':
+        return "uint";
+    case 'I':
+    case 'B':
+    case 'S':
+        return "bool";
+    default:
+        return "char";
+    }
+}
+
+//! the string transform before the TransformEngine
+static std::string LegacyBoolToString(std::string orginalValue, std::string transformResultOff, std::string transformResultOn)
+{
+    if (orginalValue == "0") {
+        return transformResultOff;
+    }
+    else if (orginalValue == "1") {
+        return transformResultOn;
+    }
+    return orginalValue;
+}
+
+static void BenchLogger(const int category, const char *msg, ...)
+{
+}
+
+//! counts and releases what processElement hands to the core
+static void CountingEnqueue(SPHANDLE eventSource, void *event, void *arg)
+{
+    (*(uint64_t *)arg)++;
+    release_generic((GenericTLV *)event);
+}
+
+/**
+ * drives the prepare3d parsing directly - the buffers are fed in as
+ * the socket read handler would without starting the libuv loop
+ */
+class Prepare3dParseBench : public SimSourcePluginStateManager
+{
+public:
+    uint64_t enqueued;
+
+    Prepare3dParseBench(void)
+        : SimSourcePluginStateManager(BenchLogger)
+        , enqueued(0)
+    {
+        _enqueueCallback = CountingEnqueue;
+        _callbackArg = &enqueued;
+    }
+
+    void parse(const char *data, int len) { processData(data, len); };
+
+    //! the read handler before the framer - copy, terminate, strtok
+    void legacyRead(const char *data, int len)
+    {
+        char *buffer = (char *)malloc(len);
+
+        memcpy(buffer, data, len);
+        buffer[len - 1] = '\0';
+        legacyProcessData(buffer, len);
+        free(buffer);
+    }
+
+    void legacyProcessData(char *data, int len)
+    {
+        if (len > 2) {
+            int elementCount = 0;
+            char *p = strtok(data, "\n");
+            char *array[PREPARE3D_BENCH_LEGACY_MAX_ELEMENTS];
+
+            while (p != NULL && elementCount < PREPARE3D_BENCH_LEGACY_MAX_ELEMENTS) {
+                size_t len = strlen(p);
+
+                if (len > 2) {
+                    char *buffer = (char *)malloc(PREPARE3D_BENCH_LEGACY_BUFFER_LEN);
+                    memset(buffer, 0, PREPARE3D_BENCH_LEGACY_BUFFER_LEN);
+                    strncpy(buffer, p, len);
+                    buffer[len - 1] = '\0';
+                    array[elementCount++] = buffer;
+                }
+
+                p = strtok(NULL, "\n");
+            }
+
+            for (int i = 0; i < elementCount; ++i) {
+                legacyProcessElement(array[i]);
+                free(array[i]);
+            }
+        }
+    }
+
+    void legacyProcessElement(char *element)
+    {
+        char *name = strtok(element, "=");
+        char *value = strtok(NULL, " =");
+
+        if (value == NULL) {
+            return;
+        }
+
+        name[strlen(name) - 1] = '\0';
+
+        if (strlen(name) == 0) {
+            return;
+        }
+
+        const char *type = LegacyElementDataType(name[0]);
+        GenericTLV *el = make_generic(name, "-");
+
+        el->ownerPlugin = this;
+        el->symbol = symbolFor(name);
+
+        if (strncmp(type, "float", sizeof(&type)) == 0) {
+            el->type = CONFIG_FLOAT;
+            el->value.float_value = atof(value);
+        }
+        else if (strncmp(type, "char", sizeof(&type)) == 0) {
+            el->type = CONFIG_STRING;
+            generic_set_string(el, &(el->value.string_value), value);
+        }
+        else if (strncmp(type, "int", sizeof(&type)) == 0 || strncmp(type, "uint", sizeof(&type)) == 0) {
+            el->type = CONFIG_INT;
+            el->value.int_value = atoi(value);
+        }
+        else {
+            el->type = CONFIG_BOOL;
+            el->value.bool_value = strncmp(value, "0", sizeof(el->value)) != 0;
+        }
+
+        _enqueueCallback(this, (void *)el, _callbackArg);
+    }
+};
+
+/**
+ * the socket ingest before and after the line framer over the same
+ * stream cut into socket sized reads - note the legacy path corrupts
+ * the lines split across reads
+ */
+void Prepare3dParseBenchmark(BenchReport &report)
+{
+    Prepare3dParseBench parser;
+
+    for (int lines : {16, PROSIM_BENCH_STREAM_LINES}) {
+        std::string stream = ProsimBenchStream(lines);
+        std::string variant = std::to_string(lines) + " lines";
+        BenchResult result;
+
+        result = RunBenchmark("prepare3d", "legacy read/strtok", variant, [&](uint64_t) {
+            for (size_t offset = 0; offset < stream.size(); offset += PROSIM_BENCH_READ_SIZE) {
+                size_t length = std::min((size_t)PROSIM_BENCH_READ_SIZE, stream.size() - offset);
+                parser.legacyRead(stream.data() + offset, (int)length);
+            }
+        });
+
+        result.bytesPerOp = stream.size();
+        report.add(result);
+
+        result = RunBenchmark("prepare3d", "line framer", variant, [&](uint64_t) {
+            for (size_t offset = 0; offset < stream.size(); offset += PROSIM_BENCH_READ_SIZE) {
+                size_t length = std::min((size_t)PROSIM_BENCH_READ_SIZE, stream.size() - offset);
+                parser.parse(stream.data() + offset, (int)length);
+            }
+        });
+
+        result.bytesPerOp = stream.size();
+        report.add(result);
+    }
+
+    const char *values[] = {"10250.5", "-0.000125", "42"};
+
+    for (const char *value : values) {
+        size_t length = strlen(value);
+        double parsed;
+
+        report.add(RunBenchmark("prepare3d", "atof", value, [&](uint64_t) { BenchKeep(atof(value)); }));
+        report.add(RunBenchmark("prepare3d", "ParseFloat", value, [&](uint64_t) { BenchKeep(ParseFloat(value, length, parsed)); }));
+    }
+
+    // transform of a bool switch value on its way out to the simulator
+    GenericTLV *switchValue = make_generic("S_OH_PROBE_HEAT_A", "-");
+    std::function<std::string(std::string, std::string, std::string)> legacyTransform = std::bind(LegacyBoolToString, std::placeholders::_1, "Off", "On");
+    TransformEngine transforms;
+    // symbols are bound in the hub, any id will do here
+    TransformId transformId = transforms.add(switchValue->name, 1, TransformChain().boolLabels("Off", "On"));
+
+    switchValue->symbol = 1;
+    switchValue->type = CONFIG_BOOL;
+    switchValue->value.bool_value = 1;
+    switchValue->length = sizeof(uint8_t);
+
+    report.add(RunBenchmark("prepare3d", "transform", "std::function", [&](uint64_t) {
+        std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(switchValue);
+        BenchKeep(legacyTransform(attribute->valueToString(), "NULL", "NULL").size());
+    }));
+
+    report.add(RunBenchmark("prepare3d", "transform", "TransformEngine", [&](uint64_t) {
+        TransformResult result;
+        double number;
+
+        PluginStateManager::GenericNumber(switchValue, number);
+        transforms.apply(transforms.find(switchValue->name, switchValue->symbol), number, result);
+        BenchKeep(result.labelLength);
+    }));
+
+    BenchKeep(transformId);
+    release_generic(switchValue);
+    BenchKeep(parser.enqueued);
+}
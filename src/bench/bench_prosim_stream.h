@@ -0,0 +1,37 @@
+#ifndef __BENCH_PROSIM_STREAM_H
+#define __BENCH_PROSIM_STREAM_H
+
+#include <string>
+
+//! ProSim sends reads of up to one segment
+#define PROSIM_BENCH_READ_SIZE 1460
+#define PROSIM_BENCH_STREAM_LINES 4096
+
+//! a few lines of every ProSim element type, as they arrive on the socket
+static const char *ProsimBenchLines[] = {"G_MIP_ALTITUDE = 10250.5\r\n", "G_MIP_AIRSPEED = 251.25\r\n", "N_MIP_FLAPS = 15\r\n", "N_OH_ELEC_DC_AMPS = 42\r\n",
+                                         "I_MIP_GEAR_LEFT_GREEN = 1\r\n", "I_OH_APU_FAULT = 0\r\n", "V_FMC_SCRATCHPAD = KJFK\r\n", "A_MIP_THROTTLE_1 = 512\r\n",
+                                         "R_OH_IRS_LEFT = 2\r\n", "B_OH_BATTERY = 1\r\n", "S_OH_APU = 0\r\n", "E_MCP_HEADING = 1\r\n"};
+
+/**
+ * a synthetic stream lines elements long, standing in for a recorded
+ * ProSim capture
+ *
+ * - no capture of a real ProSim session is checked in, and
+ *   tools/prosim-emulator sends random values of its own, so the
+ *   stream cycles through the lines above instead
+ * - framing and parsing cost follows line length and element type,
+ *   numbers from a real session will shift with its mix of both
+ */
+inline std::string ProsimBenchStream(int lines)
+{
+    std::string retVal;
+    int lineCount = sizeof(ProsimBenchLines) / sizeof(ProsimBenchLines[0]);
+
+    for (int i = 0; i < lines; i++) {
+        retVal += ProsimBenchLines[i % lineCount];
+    }
+
+    return retVal;
+}
+
+#endif
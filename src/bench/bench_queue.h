@@ -0,0 +1,80 @@
+#ifndef __BENCH_QUEUE_H
+#define __BENCH_QUEUE_H
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <stdio.h>
+#include <thread>
+#include <vector>
+
+#include "bench_harness.h"
+#include "queue/concurrent_queue.h"
+#include "queue/ring_queue.h"
+
+#define QUEUE_BENCH_EVENTS_PER_PRODUCER 200000
+#define QUEUE_BENCH_MAX_PRODUCERS 8
+
+typedef std::shared_ptr<int> QueueBenchEvent;
+
+/**
+ * pushes eventsPerProducer shared_ptr events from each of producerCount
+ * threads into the queue while one consumer drains it
+ */
+template <typename Q> BenchResult QueueContentionRun(Q &queue, const char *name, int producerCount, int eventsPerProducer)
+{
+    std::vector<std::thread> producers;
+    long expected = (long)producerCount * eventsPerProducer;
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::thread consumer([&] {
+        for (long i = 0; i < expected; i++) {
+            QueueBenchEvent event = queue.pop();
+        }
+    });
+
+    for (int p = 0; p < producerCount; p++) {
+        producers.push_back(std::thread([&] {
+            // one payload per producer so we measure the queue and not
+            // shared_ptr refcount contention
+            QueueBenchEvent payload = std::make_shared<int>(42);
+
+            for (int i = 0; i < eventsPerProducer; i++) {
+                queue.push(payload);
+            }
+        }));
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    consumer.join();
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    BenchResult retVal;
+
+    retVal.suite = "queue";
+    retVal.name = name;
+    retVal.variant = std::to_string(producerCount) + " producers";
+    retVal.operations = expected;
+    retVal.seconds = elapsed.count();
+
+    return retVal;
+}
+
+//! ConcurrentQueue (mutex + condvar) vs RingQueue under 1..N producers
+void QueueContentionBenchmark(BenchReport &report)
+{
+    for (int producers = 1; producers <= QUEUE_BENCH_MAX_PRODUCERS; producers *= 2) {
+        ConcurrentQueue<QueueBenchEvent> concurrentQueue;
+        report.add(QueueContentionRun(concurrentQueue, "ConcurrentQueue", producers, QUEUE_BENCH_EVENTS_PER_PRODUCER));
+
+        RingQueue<QueueBenchEvent> ringQueue(RING_QUEUE_DEFAULT_CAPACITY, OVERFLOW_BLOCK);
+        report.add(QueueContentionRun(ringQueue, "RingQueue", producers, QUEUE_BENCH_EVENTS_PER_PRODUCER));
+    }
+}
+
+#endif
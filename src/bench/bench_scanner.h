@@ -0,0 +1,52 @@
+#ifndef __BENCH_SCANNER_H
+#define __BENCH_SCANNER_H
+
+#include <algorithm>
+#include <string>
+
+#include "bench_harness.h"
+#include "bench_prosim_stream.h"
+#include "plugins/common/delimiterscanner.h"
+#include "plugins/common/lineframer.h"
+
+//! delimiter scanning and framing of a ProSim stream at every scan level the cpu supports
+void DelimiterScanBenchmark(BenchReport &report)
+{
+    std::string stream = ProsimBenchStream(PROSIM_BENCH_STREAM_LINES);
+    std::string variant;
+    BenchResult result;
+
+    for (ScanLevel level : {SCAN_SCALAR, SCAN_SSE2, SCAN_AVX2}) {
+        if (!DelimiterScanner::Supported(level)) {
+            continue;
+        }
+
+        DelimiterScanner scanner(level);
+        DelimiterIndex index;
+        LineFramer framer(LINE_FRAMER_DEFAULT_CAPACITY, level);
+        size_t lines = 0;
+
+        variant = std::string(DelimiterScanner::LevelName(level)) + " " + std::to_string(PROSIM_BENCH_STREAM_LINES) + " lines";
+
+        result = RunBenchmark("scanner", "scan", variant, [&](uint64_t) {
+            index.records.clear();
+            scanner.scan(stream.data(), stream.size(), 0, index);
+        });
+
+        result.bytesPerOp = stream.size();
+        report.add(result);
+
+        result = RunBenchmark("scanner", "frameRecords", variant, [&](uint64_t) {
+            for (size_t offset = 0; offset < stream.size(); offset += PROSIM_BENCH_READ_SIZE) {
+                size_t length = std::min((size_t)PROSIM_BENCH_READ_SIZE, stream.size() - offset);
+                framer.appendRecords(stream.data() + offset, length, [&](char *, size_t, char *) { lines++; });
+            }
+        });
+
+        result.bytesPerOp = stream.size();
+        report.add(result);
+        BenchKeep(lines);
+    }
+}
+
+#endif
@@ -31,10 +31,10 @@ void AWS::initPolly(void)
     _polly = std::make_shared<Polly>();
 }
 
-void AWS::initKinesis(std::string streamName, std::string partition, std::string region)
+void AWS::initKinesis(std::string streamName, std::string partition, std::string region, MetricsRegistry *metrics)
 {
     // TODO: Make this part of a config file
-    _kinesis = std::make_shared<Kinesis>(streamName, partition, region);
+    _kinesis = std::make_shared<Kinesis>(streamName, partition, region, metrics);
 }
 
 void AWS::init(void)
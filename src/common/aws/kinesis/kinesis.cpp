@@ -6,7 +6,7 @@
 #include "../aws.h"
 #endif
 
-Kinesis::Kinesis(std::string streamName, std::string partition, std::string region)
+Kinesis::Kinesis(std::string streamName, std::string partition, std::string region, MetricsRegistry *metrics)
     : _partition(partition)
     , _streamName(streamName)
     , _region(region)
@@ -16,6 +16,12 @@ Kinesis::Kinesis(std::string streamName, std::string partition, std::string regi
     config.region = Aws::String(_region.c_str());
     _kinesisClient = Aws::MakeShared<KinesisClient>(ALLOCATION_TAG, config);
     _recordCounter = 0;
+
+    MetricsRegistry &registry = metrics ? *metrics : _localMetrics;
+    std::string labels = "stream=\"" + _streamName + "\"";
+    _recordsQueued = &registry.counter("simhub_kinesis_records_queued_total", "Records queued for Kinesis", labels);
+    _recordsSent = &registry.counter("simhub_kinesis_records_sent_total", "Records Kinesis accepted", labels);
+    _recordsFailed = &registry.counter("simhub_kinesis_records_failed_total", "Records Kinesis rejected", labels);
       
     std::shared_ptr<std::thread> kinesisThread = std::make_shared<std::thread>([=] {
         _threadManager.setThreadRunning(true);
@@ -26,7 +32,8 @@ Kinesis::Kinesis(std::string streamName, std::string partition, std::string regi
                 Aws::Kinesis::Model::PutRecordRequest *request = new Aws::Kinesis::Model::PutRecordRequest();
                 request->SetStreamName(Aws::String(_streamName.c_str()));
                 request->WithData(data).WithPartitionKey(Aws::String(_partition.c_str()));
-                _kinesisClient->PutRecord(*request);
+                Aws::Kinesis::Model::PutRecordOutcome outcome = _kinesisClient->PutRecord(*request);
+                (outcome.IsSuccess() ? _recordsSent : _recordsFailed)->add();
                 _recordCounter++;
             }
             catch (ConcurrentQueueInterrupted &except) {
@@ -53,4 +60,11 @@ void Kinesis::shutdown(void)
 void Kinesis::putRecord(Aws::Utils::ByteBuffer data)
 {
     _queue.push(data);
+    _recordsQueued->add();
+}
+
+void Kinesis::putRecords(std::vector<Aws::Utils::ByteBuffer> &records)
+{
+    _queue.push(records.begin(), records.end());
+    _recordsQueued->add(records.size());
 }
@@ -13,8 +13,10 @@
 #include <iostream>
 #include <stdio.h>
 #include <string.h>
+#include <vector>
 
 #include "common/support/threadmanager.h"
+#include "plugins/common/metrics.h"
 
 typedef Aws::Kinesis::KinesisClient KinesisClient;
 
@@ -30,12 +32,19 @@ protected:
     CancelableThreadManager _threadManager;
     long _recordCounter;
 
+    //! series in the core's MetricsRegistry, or a private one if none was given
+    MetricsRegistry _localMetrics;
+    MetricCounter *_recordsQueued;
+    MetricCounter *_recordsSent;
+    MetricCounter *_recordsFailed;
+
 public:
     // Default constructor
-    Kinesis(std::string streamName, std::string partition, std::string region);
+    Kinesis(std::string streamName, std::string partition, std::string region, MetricsRegistry *metrics = NULL);
     // Destructor
     ~Kinesis(void);
     void putRecord(Aws::Utils::ByteBuffer data);
+    void putRecords(std::vector<Aws::Utils::ByteBuffer> &records);
     virtual void shutdown(void);
 };
 
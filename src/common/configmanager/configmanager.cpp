@@ -67,35 +67,76 @@ std::string ConfigManager::mappingConfigFilename(void)
     return _mappingConfigFilename;
 }
 
-std::string ConfigManager::loadPrepare3DConfiguration(void)
+/**
+ *   @brief the plugins the core hosts, in load order
+ *
+ *   @return std::vector<PluginDescriptor> one entry per item of the plugins
+ *           list (with its delivery queue settings), or the pokey and
+ *           prepare3d pair for older configurations that name their
+ *           config files directly
+ */
+std::vector<PluginDescriptor> ConfigManager::pluginDescriptors(void)
 {
-    if (_prepare3dConfigurationFilename.empty()) {
-        try {
-            _prepare3dConfigurationFilename = (const char *)_config.lookup("prepare3dConfigurationFile");
-            _prepare3dConfig.readFile(_prepare3dConfigurationFilename.c_str());
-            logger.log(LOG_INFO, "Loading prepare3d configuration from %s", _prepare3dConfigurationFilename.c_str());
-        }
-        catch (const libconfig::SettingNotFoundException &nfex) {
-            logger.log(LOG_ERROR, "No prepare3d configuration file set in config");
+    std::vector<PluginDescriptor> retVal;
+
+    try {
+        libconfig::Setting &plugins = _config.lookup("plugins");
+
+        for (int i = 0; i < plugins.getLength(); i++) {
+            PluginDescriptor descriptor;
+
+            if (!plugins[i].lookupValue("name", descriptor.name) || !plugins[i].lookupValue("library", descriptor.library)) {
+                logger.log(LOG_ERROR, "Plugin %d needs a name and a library. Skipping....", i);
+                continue;
+            }
+
+            plugins[i].lookupValue("config", descriptor.configFile);
+            plugins[i].lookupValue("lane", descriptor.lane);
+
+            if (plugins[i].exists("delivery")) {
+                libconfig::Setting &delivery = plugins[i]["delivery"];
+                int queueDepth = DEFAULT_DELIVERY_QUEUE_DEPTH;
+                int batchSize = DEFAULT_DELIVERY_BATCH_SIZE;
+                int blockTimeout = DEFAULT_DELIVERY_BLOCK_TIMEOUT;
+                std::string overflow("drop_oldest");
+
+                delivery.lookupValue("queueDepth", queueDepth);
+                delivery.lookupValue("batchSize", batchSize);
+                delivery.lookupValue("overflow", overflow);
+                delivery.lookupValue("blockTimeout", blockTimeout);
+
+                descriptor.delivery.queueDepth = queueDepth > 0 ? queueDepth : DEFAULT_DELIVERY_QUEUE_DEPTH;
+                descriptor.delivery.batchSize = batchSize > 0 ? batchSize : DEFAULT_DELIVERY_BATCH_SIZE;
+                descriptor.delivery.overflowPolicy = QueueOverflowPolicyFromString(overflow);
+                descriptor.delivery.blockTimeout = blockTimeout > 0 ? blockTimeout : DEFAULT_DELIVERY_BLOCK_TIMEOUT;
+            }
+
+            retVal.push_back(descriptor);
         }
     }
-    return _prepare3dConfigurationFilename;
-}
+    catch (const libconfig::SettingNotFoundException &nfex) {
+        std::string configFile;
 
-std::string ConfigManager::loadPokeyConfiguration(void)
-{
-    if (_pokeyConfigurationFilename.empty()) {
-        try {
-            _pokeyConfigurationFilename = (const char *)_config.lookup("pokeyConfigurationFile");
-            _pokeyConfig.readFile(_pokeyConfigurationFilename.c_str());
-            logger.log(LOG_INFO, "Loading pokey configuration from %s", _pokeyConfigurationFilename.c_str());
+        if (_config.lookupValue("pokeyConfigurationFile", configFile)) {
+            retVal.push_back({"pokey", "libpokey", configFile});
         }
-        catch (const libconfig::SettingNotFoundException &nfex) {
-            logger.log(LOG_ERROR, "No pokey configuration file set in config");
+
+        if (_config.lookupValue("prepare3dConfigurationFile", configFile)) {
+            retVal.push_back({"prepare3d", "libprepare3d", configFile});
         }
     }
+    catch (const libconfig::SettingTypeException &stex) {
+        logger.log(LOG_ERROR, "Setting type error for %s", stex.getPath());
+    }
 
-    return _pokeyConfigurationFilename;
+    return retVal;
+}
+
+std::string ConfigManager::pluginDirectory(void)
+{
+    std::string retVal("plugins");
+    config()->lookupValue("pluginDir", retVal);
+    return retVal;
 }
 
 int ConfigManager::init(std::shared_ptr<SimHubEventController> simhubController)
@@ -123,13 +164,7 @@ int ConfigManager::init(std::shared_ptr<SimHubEventController> simhubController)
 
     /** load the various config files **/
     try {
-        loadPrepare3DConfiguration();
-        simhubController->setPrepare3dConfig(&_prepare3dConfig);
-
-        loadPokeyConfiguration();
-        simhubController->setPokeyConfig(&_pokeyConfig);
-
-        _mappingConfigManager.reset(new MappingConfigManager(mappingConfigFilename()));
+        _mappingConfigManager.reset(new MappingConfigManager(mappingConfigFilename(), simhubController->symbolTable()));
     }
     catch (const libconfig::ParseException &pex) {
         logger.log(LOG_INFO, "Config file parse error at %s:%d  - %s", pex.getFile(), pex.getLine(), pex.getError());
@@ -199,3 +234,112 @@ size_t ConfigManager::httpListenPort(void)
     config()->lookupValue("httpListenPort", port);
     return port;
 }
+
+size_t ConfigManager::eventQueueCapacity(void)
+{
+    int capacity = RING_QUEUE_DEFAULT_CAPACITY;
+    config()->lookupValue("eventQueue.capacity", capacity);
+    return capacity > 0 ? capacity : RING_QUEUE_DEFAULT_CAPACITY;
+}
+
+std::string ConfigManager::eventQueueOverflowPolicy(void)
+{
+    std::string retVal("block");
+    config()->lookupValue("eventQueue.overflow", retVal);
+    return retVal;
+}
+
+unsigned int ConfigManager::eventQueueBlockTimeout(void)
+{
+    int blockTimeout = DEFAULT_LANE_BLOCK_TIMEOUT;
+    config()->lookupValue("eventQueue.blockTimeout", blockTimeout);
+    return blockTimeout > 0 ? blockTimeout : DEFAULT_LANE_BLOCK_TIMEOUT;
+}
+
+/**
+ *   @brief the priority lanes of the event queue, highest priority first
+ *
+ *   @return std::vector<LaneOptions> one entry per item of eventLanes.lanes,
+ *           or a single lane sized by the eventQueue settings if no lanes
+ *           are configured
+ */
+std::vector<LaneOptions> ConfigManager::eventLanes(void)
+{
+    std::vector<LaneOptions> retVal;
+
+    try {
+        libconfig::Setting &lanes = _config.lookup("eventLanes.lanes");
+
+        for (int i = 0; i < lanes.getLength(); i++) {
+            LaneOptions options;
+            int capacity = eventQueueCapacity();
+            int weight = 1;
+            int blockTimeout = eventQueueBlockTimeout();
+            std::string overflow = eventQueueOverflowPolicy();
+
+            if (!lanes[i].lookupValue("name", options.name)) {
+                logger.log(LOG_ERROR, "Event lane %d needs a name. Skipping....", i);
+                continue;
+            }
+
+            lanes[i].lookupValue("capacity", capacity);
+            lanes[i].lookupValue("overflow", overflow);
+            lanes[i].lookupValue("blockTimeout", blockTimeout);
+            lanes[i].lookupValue("weight", weight);
+
+            if (lanes[i].exists("prefixes")) {
+                libconfig::Setting &prefixes = lanes[i]["prefixes"];
+
+                for (int j = 0; j < prefixes.getLength(); j++) {
+                    options.prefixes.push_back((const char *)prefixes[j]);
+                }
+            }
+
+            options.capacity = capacity > 0 ? capacity : RING_QUEUE_DEFAULT_CAPACITY;
+            options.overflowPolicy = QueueOverflowPolicyFromString(overflow);
+            options.blockTimeout = blockTimeout > 0 ? blockTimeout : DEFAULT_LANE_BLOCK_TIMEOUT;
+            options.weight = weight > 0 ? weight : 1;
+            retVal.push_back(options);
+        }
+    }
+    catch (const libconfig::SettingNotFoundException &nfex) {
+        // lanes are optional
+    }
+    catch (const libconfig::SettingTypeException &stex) {
+        logger.log(LOG_ERROR, "Setting type error for %s", stex.getPath());
+        retVal.clear();
+    }
+
+    if (retVal.empty()) {
+        LaneOptions options;
+
+        options.name = "default";
+        options.capacity = eventQueueCapacity();
+        options.overflowPolicy = QueueOverflowPolicyFromString(eventQueueOverflowPolicy());
+        options.blockTimeout = eventQueueBlockTimeout();
+        retVal.push_back(options);
+    }
+
+    return retVal;
+}
+
+std::string ConfigManager::eventLaneScheduling(void)
+{
+    std::string retVal("strict");
+    config()->lookupValue("eventLanes.scheduling", retVal);
+    return retVal;
+}
+
+size_t ConfigManager::eventBatchSize(void)
+{
+    int batchSize = DEFAULT_EVENT_BATCH_SIZE;
+    config()->lookupValue("eventLoop.batchSize", batchSize);
+    return batchSize > 0 ? batchSize : DEFAULT_EVENT_BATCH_SIZE;
+}
+
+std::chrono::microseconds ConfigManager::eventBatchLinger(void)
+{
+    int linger = DEFAULT_EVENT_BATCH_LINGER;
+    config()->lookupValue("eventLoop.lingerMicroseconds", linger);
+    return std::chrono::microseconds(linger > 0 ? linger : DEFAULT_EVENT_BATCH_LINGER);
+}
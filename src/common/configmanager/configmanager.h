@@ -8,6 +8,7 @@
 #include <unistd.h>
 #endif
 
+#include <chrono>
 #include <exception>
 #include <iostream>
 #include <libconfig.h++>
@@ -19,8 +20,10 @@
 #include "aws/aws.h"
 #endif
 
+#include "lanes/eventLanes.h"
 #include "log/clog.h"
 #include "mappingConfigManager/mappingConfigManager.h"
+#include "registry/pluginRegistry.h"
 #include "simhub.h"
 
 #ifndef RETURN_OK
@@ -44,12 +47,6 @@ protected:
     std::string _mappingConfigFilename;
     std::shared_ptr<MappingConfigManager> _mappingConfigManager;
 
-    libconfig::Config _prepare3dConfig;
-    std::string _prepare3dConfigurationFilename;
-
-    libconfig::Config _pokeyConfig;
-    std::string _pokeyConfigurationFilename;
-
     libconfig::Setting *_root;
 
     bool fileExists(std::string filename);
@@ -61,13 +58,19 @@ public:
     int init(std::shared_ptr<SimHubEventController> simhubController);
     std::string configFilename(void);
     std::string mappingConfigFilename(void);
-    std::string loadPrepare3DConfiguration(void);
-    std::string loadPokeyConfiguration(void);
+    std::vector<PluginDescriptor> pluginDescriptors(void);
+    std::string pluginDirectory(void);
     std::string version(void);
     std::string name(void);
     std::string httpListenAddress(void);
     size_t httpListenPort(void);
-    std::string pokeyConfigurationFilename(void) { return _pokeyConfigurationFilename; };
+    size_t eventQueueCapacity(void);
+    std::string eventQueueOverflowPolicy(void);
+    unsigned int eventQueueBlockTimeout(void);
+    std::vector<LaneOptions> eventLanes(void);
+    std::string eventLaneScheduling(void);
+    size_t eventBatchSize(void);
+    std::chrono::microseconds eventBatchLinger(void);
     std::shared_ptr<MappingConfigManager> mapManager(void);
     libconfig::Config *config() { return &_config; }
 };
@@ -5,7 +5,8 @@
  *
  *   @return nothing
  */
-MappingConfigManager::MappingConfigManager(std::string filename)
+MappingConfigManager::MappingConfigManager(std::string filename, SymbolTable *symbols)
+    : _symbols(symbols)
 {
     if (fileExists(filename)) {
         _configFilename = filename;
@@ -43,6 +44,19 @@ std::string MappingConfigManager::configFilename(void)
     return _configFilename;
 }
 
+//! reads a setting that holds either a single string or a list of strings
+void MappingConfigManager::ReadStringList(const libconfig::Setting &setting, std::vector<std::string> &values)
+{
+    if (setting.isAggregate()) {
+        for (int i = 0; i < setting.getLength(); i++) {
+            values.push_back((const char *)setting[i]);
+        }
+    }
+    else {
+        values.push_back((const char *)setting);
+    }
+}
+
 int MappingConfigManager::init(void)
 {
     // read the config file and handle any errors
@@ -62,6 +76,8 @@ int MappingConfigManager::init(void)
 
     _root = &_config.getRoot();
 
+    loadConflation();
+
     try {
         _mappingConfig = &_config.lookup("mapping");
         logger.log(LOG_INFO, "Mapping | %d mapping(s)", _mappingConfig->getLength());
@@ -73,13 +89,27 @@ int MappingConfigManager::init(void)
 
         for (int i = 0; i <= _mappingConfig->getLength() - 1; i++) {
             std::string source;
-            std::string target;
+            std::vector<std::string> targets;
+            std::vector<std::string> destinations;
+            std::string lane;
             unsigned int sustain = 0;
+            bool conflate = false;
+            bool conflateSet = false;
 
             try {
                 source = (const char *)(*_mappingConfig)[i].lookup("source");
-                target = (const char *)(*_mappingConfig)[i].lookup("target");
+
+                // target is either a single element name or a list of them
+                ReadStringList((*_mappingConfig)[i].lookup("target"), targets);
+
+                // as are the optional destination plugin names
+                if ((*_mappingConfig)[i].exists("destination")) {
+                    ReadStringList((*_mappingConfig)[i].lookup("destination"), destinations);
+                }
+
                 (*_mappingConfig)[i].lookupValue("sustain", sustain);
+                (*_mappingConfig)[i].lookupValue("lane", lane);
+                conflateSet = (*_mappingConfig)[i].lookupValue("conflate", conflate);
             }
             catch (const libconfig::SettingNotFoundException &nfex) {
                 logger.log(LOG_ERROR, "Mapping | WARNING | Config file parse error at %s. Skipping....", nfex.getPath());
@@ -90,20 +120,43 @@ int MappingConfigManager::init(void)
                 continue;
             }
 
+            if (targets.empty()) {
+                logger.log(LOG_ERROR, "Mapping | WARNING | No target for %s. Skipping....", source.c_str());
+                continue;
+            }
+
             if (mapContains(_mapping, source)) {
                 logger.log(LOG_INFO, "Mapping | WARNING | Skipping duplicate source %s ", source.c_str());
                 continue;
             }
             else {
-                _mapping[source] = std::make_pair(source, target);
-                logger.log(LOG_INFO, "Mapping | %s to %s", source.c_str(), target.c_str());
+                _mapping[source] = std::make_pair(source, targets[0]);
+                _targets[source] = targets;
+
+                if (!destinations.empty()) {
+                    _destinations[source] = destinations;
+                }
+
+                if (!lane.empty()) {
+                    _lanes[source] = lane;
+                }
+
+                for (std::string &target : targets) {
+                    logger.log(LOG_INFO, "Mapping | %s to %s", source.c_str(), target.c_str());
+                }
             }
 
             if (sustain > 0 && !mapContains(_sustainMap, source)) {
                 _sustainMap[source] = sustain;
             }
+
+            if (conflateSet) {
+                _conflateOverrides[source] = conflate;
+            }
         }
         logger.log(LOG_INFO, "Mapping | %i Mappings", _mapping.size());
+
+        indexSymbols();
     }
     catch (std::exception &e) {
         logger.log(LOG_ERROR, "Mapping | %s", e.what());
@@ -113,6 +166,110 @@ int MappingConfigManager::init(void)
     return RETURN_OK;
 }
 
+/**
+ *   @brief intern every mapped element name and build the symbol indexed
+ *          lookups used on the event path
+ */
+void MappingConfigManager::indexSymbols(void)
+{
+    if (!_symbols) {
+        return;
+    }
+
+    for (ElementMap::iterator it = _mapping.begin(); it != _mapping.end(); it++) {
+        SymbolId source = _symbols->intern(it->first);
+
+        for (std::string &target : _targets[it->first]) {
+            _symbols->intern(target);
+        }
+
+        _mappingBySymbol.set(source, &(it->second));
+
+        if (mapContains(_sustainMap, it->first)) {
+            _sustainBySymbol.set(source, _sustainMap[it->first]);
+        }
+
+        _conflateBySymbol.set(source, shouldConflate(it->first));
+    }
+
+    logger.log(LOG_INFO, "Mapping | %u symbol(s) interned", _symbols->bound() - 1);
+}
+
+/**
+ *   @brief read the optional conflation block - a list of element name
+ *          prefixes whose updates are conflated (latest value wins)
+ */
+void MappingConfigManager::loadConflation(void)
+{
+    try {
+        libconfig::Setting &prefixes = _config.lookup("conflation.prefixes");
+
+        for (int i = 0; i < prefixes.getLength(); i++) {
+            std::string prefix = (const char *)prefixes[i];
+            _conflatePrefixes.push_back(prefix);
+            logger.log(LOG_INFO, "Mapping | conflating elements with prefix %s", prefix.c_str());
+        }
+    }
+    catch (const libconfig::SettingNotFoundException &nfex) {
+        // conflation is optional
+    }
+    catch (const libconfig::SettingTypeException &nfex) {
+        logger.log(LOG_ERROR, "Mapping | WARNING | Setting type error for %s. Conflation disabled....", nfex.getPath());
+        _conflatePrefixes.clear();
+    }
+}
+
+/**
+ *   @brief check if updates of the named element should be conflated
+ *
+ *   @param  std::string name of the source element
+ *
+ *   @return bool true if a per-mapping conflate setting says so or, failing that,
+ *           if the name starts with one of the configured prefixes
+ */
+bool MappingConfigManager::shouldConflate(const std::string &name)
+{
+    if (!_conflateOverrides.empty()) {
+        std::map<std::string, bool>::iterator it = _conflateOverrides.find(name);
+
+        if (it != _conflateOverrides.end()) {
+            return it->second;
+        }
+    }
+
+    for (std::string &prefix : _conflatePrefixes) {
+        if (name.compare(0, prefix.length(), prefix) == 0) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *   @brief symbol indexed variant of shouldConflate(name) - names that
+ *          were not known at configuration time fall back to the prefixes
+ */
+bool MappingConfigManager::shouldConflate(SymbolId symbol, const std::string &name)
+{
+    bool *conflate = _conflateBySymbol.find(symbol);
+
+    if (conflate) {
+        return *conflate;
+    }
+
+    return shouldConflate(name);
+}
+
+/**
+ *   @brief sustain period (ms) of the given source element, 0 for none
+ */
+unsigned int MappingConfigManager::sustain(SymbolId symbol)
+{
+    unsigned int *sustain = _sustainBySymbol.find(symbol);
+    return sustain ? *sustain : 0;
+}
+
 std::string MappingConfigManager::version(void)
 {
     if (_mappingConfigFileVersion.empty()) {
@@ -133,17 +290,38 @@ std::string MappingConfigManager::version(void)
  *   @param  std::string A string representing the name of the source element
  *   @param  MapEntry MapEntry to return into
  *
- *   @return bool true if file exists, otherwise false
+ *   @return bool true if key is mapped, otherwise false - unmapped
+ *          elements are delivered along the default routes
  */
 bool MappingConfigManager::find(std::string key, MapEntry **retMapEntry)
 {
     ElementMap::iterator ret = _mapping.find(key);
+
     if (ret != _mapping.end()) {
         *retMapEntry = &(ret->second);
         return true;
     }
-    else {
-        // provide a default mapping
+
+    return false;
+}
+
+/**
+ *   @brief symbol indexed variant of find(key) - flat array lookup
+ *
+ *   @param  SymbolId interned id of the source element
+ *   @param  MapEntry MapEntry to return into
+ *
+ *   @return bool true if symbol is mapped, otherwise false - unmapped
+ *          elements are delivered along the default routes
+ */
+bool MappingConfigManager::find(SymbolId symbol, MapEntry **retMapEntry)
+{
+    MapEntry **entry = _mappingBySymbol.find(symbol);
+
+    if (entry) {
+        *retMapEntry = *entry;
         return true;
     }
+
+    return false;
 }
@@ -16,6 +16,7 @@
 #include <sys/stat.h>
 #include <vector>
 
+#include "plugins/common/symboltable.h"
 #include "plugins/common/utils.h"
 
 #define RETURN_OK 1
@@ -23,6 +24,7 @@
 
 typedef std::pair<std::string, std::string> MapEntry;
 typedef std::map<std::string, MapEntry> ElementMap;
+typedef std::map<std::string, std::vector<std::string>> ElementTargetMap;
 
 class MappingConfigManager
 {
@@ -34,11 +36,32 @@ protected:
     std::string _configName;
     libconfig::Setting *_root;
     ElementMap _mapping;
+    //! every target of each source, mappings can fan out to several
+    ElementTargetMap _targets;
+    //! sources whose delivery is limited to the named plugins
+    ElementTargetMap _destinations;
+    //! sources pinned to a named event lane
+    std::map<std::string, std::string> _lanes;
 
     std::map<std::string, unsigned int> _sustainMap;
 
+    //! flat, symbol indexed copies of the maps above for the event path
+    SymbolTable *_symbols;
+    SymbolIndex<MapEntry *> _mappingBySymbol;
+    SymbolIndex<unsigned int> _sustainBySymbol;
+    SymbolIndex<bool> _conflateBySymbol;
+
+    //! element name prefixes whose updates are conflated (latest value wins)
+    std::vector<std::string> _conflatePrefixes;
+    //! per-mapping conflation settings, these win over the prefixes
+    std::map<std::string, bool> _conflateOverrides;
+
+    void loadConflation(void);
+    static void ReadStringList(const libconfig::Setting &setting, std::vector<std::string> &values);
+    void indexSymbols(void);
+
 public:
-    MappingConfigManager(std::string);
+    MappingConfigManager(std::string, SymbolTable *symbols);
     ~MappingConfigManager(void);
     const libconfig::Setting *config(void);
     int init(void);
@@ -46,7 +69,14 @@ public:
     std::string configFilename(void);
     std::string version(void);
     bool find(std::string key, MapEntry **retMapEntry);
+    bool find(SymbolId symbol, MapEntry **retMapEntry);
     std::map<std::string, unsigned int> &sustainMap(void) { return _sustainMap; };
+    ElementTargetMap &targets(void) { return _targets; };
+    ElementTargetMap &destinations(void) { return _destinations; };
+    std::map<std::string, std::string> &lanes(void) { return _lanes; };
+    unsigned int sustain(SymbolId symbol);
+    bool shouldConflate(const std::string &name);
+    bool shouldConflate(SymbolId symbol, const std::string &name);
 };
 
 #endif
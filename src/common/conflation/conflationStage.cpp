@@ -0,0 +1,85 @@
+#include "conflationStage.h"
+
+ConflationStage::ConflationStage(void)
+    : _pendingCount(0)
+    , _coalescedCount(0)
+{
+}
+
+ConflationStage::~ConflationStage(void)
+{
+}
+
+bool ConflationStage::offer(const EventRecord &value)
+{
+    SymbolId symbol = value.symbol;
+
+    if (symbol == SYMBOL_UNRESOLVED) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> pendingGuard(_pendingMutex);
+
+    if (symbol >= _pending.size()) {
+        _pending.resize(symbol + 1);
+        _isPending.resize(symbol + 1, 0);
+        _coalescedBySymbol.resize(symbol + 1, 0);
+    }
+
+    _pending[symbol] = value;
+
+    if (_isPending[symbol]) {
+        // an update for this element is still waiting in the event
+        // queue - newer value wins, nothing new gets queued
+        _coalescedBySymbol[symbol]++;
+        _coalescedCount++;
+        return false;
+    }
+
+    _isPending[symbol] = 1;
+    _pendingCount++;
+
+    return true;
+}
+
+void ConflationStage::claim(EventRecord &event)
+{
+    SymbolId symbol = event.symbol;
+
+    // cheap early out for the common case of nothing being conflated
+    if (_pendingCount == 0 || symbol == SYMBOL_UNRESOLVED) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> pendingGuard(_pendingMutex);
+
+    if (symbol < _isPending.size() && _isPending[symbol]) {
+        event = std::move(_pending[symbol]);
+        _isPending[symbol] = 0;
+        _pendingCount--;
+    }
+}
+
+void ConflationStage::cancel(SymbolId symbol)
+{
+    std::lock_guard<std::mutex> pendingGuard(_pendingMutex);
+
+    if (symbol < _isPending.size() && _isPending[symbol]) {
+        _isPending[symbol] = 0;
+        _pendingCount--;
+    }
+}
+
+std::map<SymbolId, uint64_t> ConflationStage::coalescedCounts(void)
+{
+    std::map<SymbolId, uint64_t> retVal;
+    std::lock_guard<std::mutex> pendingGuard(_pendingMutex);
+
+    for (SymbolId symbol = 0; symbol < _coalescedBySymbol.size(); symbol++) {
+        if (_coalescedBySymbol[symbol] > 0) {
+            retVal[symbol] = _coalescedBySymbol[symbol];
+        }
+    }
+
+    return retVal;
+}
@@ -0,0 +1,59 @@
+#ifndef __CONFLATIONSTAGE_H
+#define __CONFLATIONSTAGE_H
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "elements/attributes/eventRecord.h"
+
+/**
+ * Latest-value-wins stage that sits in front of the event queue for
+ * elements that only ever need their most recent value delivered
+ * (gauges, numeric readouts) - pending updates are kept in a flat
+ * array indexed by element symbol
+ *
+ * - the first update for an element is queued as normal and remembered
+ *   as the pending update for that element name
+ * - further updates arriving before the consumer gets to the queued
+ *   one overwrite the pending update in place and are not queued
+ * - the consumer claims the pending update when it pops the queued
+ *   one, so it always delivers the newest value at the position of
+ *   the oldest undelivered one
+ *
+ * Elements that are not routed through the stage (switches,
+ * indicators) keep the strict ordering of the event queue, as do
+ * events without a resolved symbol.
+ */
+class ConflationStage
+{
+protected:
+    std::mutex _pendingMutex;
+    std::vector<EventRecord> _pending;
+    std::vector<uint8_t> _isPending;
+    std::vector<uint64_t> _coalescedBySymbol;
+    std::atomic<size_t> _pendingCount;
+    std::atomic<uint64_t> _coalescedCount;
+
+public:
+    ConflationStage(void);
+    virtual ~ConflationStage(void);
+
+    //! producer side - returns true if value must be queued, false if it replaced a pending update
+    bool offer(const EventRecord &value);
+
+    //! consumer side - swaps event for the latest pending update of the same element
+    void claim(EventRecord &event);
+
+    //! forget the pending update for symbol, used when its queued placeholder was dropped
+    void cancel(SymbolId symbol);
+
+    size_t pendingCount(void) { return _pendingCount; };
+    uint64_t coalescedCount(void) { return _coalescedCount; };
+    std::map<SymbolId, uint64_t> coalescedCounts(void);
+};
+
+#endif
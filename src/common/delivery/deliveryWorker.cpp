@@ -0,0 +1,106 @@
+#include "deliveryWorker.h"
+
+DeliveryWorker::DeliveryWorker(const std::string &name, const DeliveryOptions &options, DeliverFunction deliver)
+    : _name(name)
+    , _options(options)
+    , _deliver(deliver)
+    , _queue(options.queueDepth, options.overflowPolicy)
+    , _delivered(0)
+    , _failedBatches(0)
+    , _failed(false)
+{
+    if (_options.batchSize == 0) {
+        _options.batchSize = 1;
+    }
+
+    // a full queue never holds up the event loop, and with it every other destination, for longer than this
+    _queue.setBlockTimeout(std::chrono::milliseconds(_options.blockTimeout > 0 ? _options.blockTimeout : DEFAULT_DELIVERY_BLOCK_TIMEOUT));
+
+    // values evicted to make room are never delivered
+    _queue.setDropHandler([](DeliveryItem &item) { release_generic(item.value); });
+}
+
+DeliveryWorker::~DeliveryWorker(void)
+{
+    stop();
+}
+
+void DeliveryWorker::start(void)
+{
+    if (!_thread.joinable()) {
+        _thread = std::thread(&DeliveryWorker::run, this);
+    }
+}
+
+void DeliveryWorker::stop(void)
+{
+    _queue.unblock();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+
+    DeliveryItem item;
+
+    while (_queue.tryPop(item)) {
+        release_generic(item.value);
+    }
+}
+
+bool DeliveryWorker::push(GenericTLV *value)
+{
+    if (!_queue.push(DeliveryItem(value))) {
+        // dropped as the newest value, timed out blocking or the worker is stopping
+        release_generic(value);
+        return false;
+    }
+
+    return true;
+}
+
+void DeliveryWorker::run(void)
+{
+    std::vector<DeliveryItem> batch;
+    std::vector<GenericTLV *> values;
+
+    batch.reserve(_options.batchSize);
+    values.reserve(_options.batchSize);
+
+    for (;;) {
+        try {
+            batch.clear();
+            _queue.popBatch(batch, _options.batchSize, std::chrono::microseconds(0));
+        }
+        catch (ConcurrentQueueInterrupted &queueException) {
+            break;
+        }
+
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+        values.clear();
+
+        for (DeliveryItem &item : batch) {
+            std::chrono::nanoseconds waited = start - item.queued;
+
+            _queueLatency.record(waited);
+            _queueLatencyHistogram.record(waited.count() > 0 ? waited.count() : 0);
+            values.push_back(item.value);
+        }
+
+        if (!_deliver(values)) {
+            _failedBatches++;
+            _failed = true;
+        }
+
+        std::chrono::nanoseconds took = std::chrono::steady_clock::now() - start;
+
+        _deliveryLatency.record(took);
+        _deliveryLatencyHistogram.record(took.count());
+        _delivered += values.size();
+
+        // plugins do not hold on to delivered values
+        for (GenericTLV *value : values) {
+            release_generic(value);
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#ifndef __DELIVERYWORKER_H
+#define __DELIVERYWORKER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "metrics/latencyStats.h"
+#include "plugins/common/alignedallocation.h"
+#include "plugins/common/hdrhistogram.h"
+#include "plugins/common/simhubdeviceplugin.h"
+#include "queue/ring_queue.h"
+
+#define DEFAULT_DELIVERY_QUEUE_DEPTH 1024
+#define DEFAULT_DELIVERY_BATCH_SIZE 64
+#define DEFAULT_DELIVERY_BLOCK_TIMEOUT 50
+
+//! per destination delivery settings, the delivery group of a plugins entry in config.cfg
+struct DeliveryOptions {
+    size_t queueDepth;
+    QueueOverflowPolicy overflowPolicy; ///< values are state, dropping the oldest loses nothing the next update does not restore
+    unsigned int blockTimeout; ///< ms the event loop waits under OVERFLOW_BLOCK before the value is dropped
+    size_t batchSize; ///< most values handed to the plugin in one call
+
+    DeliveryOptions(void)
+        : queueDepth(DEFAULT_DELIVERY_QUEUE_DEPTH)
+        , overflowPolicy(OVERFLOW_DROP_OLDEST)
+        , blockTimeout(DEFAULT_DELIVERY_BLOCK_TIMEOUT)
+        , batchSize(DEFAULT_DELIVERY_BATCH_SIZE){};
+};
+
+//! a value waiting for delivery and when it was queued
+struct DeliveryItem {
+    GenericTLV *value;
+    std::chrono::steady_clock::time_point queued;
+
+    DeliveryItem(void)
+        : value(NULL){};
+
+    DeliveryItem(GenericTLV *deliveryValue)
+        : value(deliveryValue)
+        , queued(std::chrono::steady_clock::now()){};
+};
+
+/**
+ * Dedicated delivery thread and queue for one destination plugin
+ *
+ * - the event loop only marshals and queues values, the (possibly slow,
+ *   blocking) plugin call happens on the worker thread so one slow sink
+ *   never holds up delivery to the others
+ * - values keep their order within a destination, there is no ordering
+ *   between destinations
+ * - the worker drains up to batchSize queued values per plugin call and
+ *   releases them once delivered, whatever is still queued at stop() is
+ *   released undelivered
+ * - what happens when the queue is full is the configured overflow
+ *   policy of the destination, dropped values are released by the worker
+ */
+class DeliveryWorker : public AlignedAllocation<RING_QUEUE_CACHE_LINE>
+{
+public:
+    //! hands a batch to the plugin, returns false if the plugin reported an error
+    typedef std::function<bool(std::vector<GenericTLV *> &)> DeliverFunction;
+
+protected:
+    std::string _name;
+    DeliveryOptions _options;
+    DeliverFunction _deliver;
+    RingQueue<DeliveryItem> _queue;
+    std::thread _thread;
+
+    std::atomic<uint64_t> _delivered;
+    std::atomic<uint64_t> _failedBatches;
+    std::atomic<bool> _failed;
+
+    LatencyStats _queueLatency; ///< queued to handed to the plugin
+    LatencyStats _deliveryLatency; ///< duration of the plugin call
+    HdrHistogram _queueLatencyHistogram; ///< ns, the distributions behind the two above, served on /metrics
+    HdrHistogram _deliveryLatencyHistogram;
+
+    void run(void);
+
+public:
+    DeliveryWorker(const std::string &name, const DeliveryOptions &options, DeliverFunction deliver);
+    virtual ~DeliveryWorker(void);
+
+    DeliveryWorker(const DeliveryWorker &) = delete; // disable copying
+    DeliveryWorker &operator=(const DeliveryWorker &) = delete; // disable assignment
+
+    void start(void);
+    //! stops accepting values, waits for the in-flight batch and releases anything still queued
+    void stop(void);
+
+    //! queues value for delivery, the worker owns it from here on (even if it is not queued)
+    bool push(GenericTLV *value);
+
+    std::string name(void) { return _name; };
+    DeliveryOptions &options(void) { return _options; };
+    size_t depth(void) { return _queue.size(); };
+    uint64_t delivered(void) { return _delivered; };
+    //! evicted, timed out or refused values
+    uint64_t dropped(void) { return _queue.droppedCount(); };
+    uint64_t failedBatches(void) { return _failedBatches; };
+    //! true once the plugin has reported a delivery error
+    bool failed(void) { return _failed; };
+    LatencyStats &queueLatency(void) { return _queueLatency; };
+    LatencyStats &deliveryLatency(void) { return _deliveryLatency; };
+    HdrHistogram &queueLatencyHistogram(void) { return _queueLatencyHistogram; };
+    HdrHistogram &deliveryLatencyHistogram(void) { return _deliveryLatencyHistogram; };
+};
+
+#endif
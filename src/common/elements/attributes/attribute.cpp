@@ -4,38 +4,65 @@
 #include "attribute.h"
 #include "plugins/common/simhubdeviceplugin.h"
 
-//! marshals C++ Attribute instance to C generic struct
-GenericTLV *AttributeToCGeneric(std::shared_ptr<Attribute> value)
+void EventRecordFromCGeneric(GenericTLV *generic, EventRecord &record)
 {
-    GenericTLV *retVal = make_generic(value->name().c_str(), (const char *)"-");
+    switch (generic->type) {
+    case CONFIG_BOOL:
+        record.setBool(generic->value.bool_value);
+        break;
+    case CONFIG_FLOAT:
+        record.setFloat(generic->value.float_value);
+        break;
+    case CONFIG_INT:
+        record.setInt(generic->value.int_value);
+        break;
+    case CONFIG_UINT:
+        record.setInt(generic->value.int_value);
+        break;
+    case CONFIG_STRING:
+        record.setString(generic->value.string_value, strlen(generic->value.string_value));
+        break;
+    default:
+        assert(false);
+        break;
+    }
 
-    // strncpy(retVal->description, value->description().c_str(), value->description().size());
-    // strncpy(retVal->units, value->units().c_str(), value->units().size());
+    record.symbol = generic->symbol;
+    record.ownerPlugin = generic->ownerPlugin;
+    record.resetTimestamp();
 
-    switch (value->type()) {
+    // plugins that do not trace their input are traced from here on
+    record.ingestTime = generic->ingestTime ? generic->ingestTime : monotonic_nanos();
+}
+
+GenericTLV *EventRecordToCGeneric(const EventRecord &record, const char *name)
+{
+    GenericTLV *retVal = make_generic(name, (const char *)"-");
+
+    switch (record.type) {
     case BOOL_ATTRIBUTE:
         retVal->type = CONFIG_BOOL;
-        retVal->value.bool_value = value->value<bool>();
+        retVal->value.bool_value = record.value.boolValue;
         break;
 
     case FLOAT_ATTRIBUTE:
         retVal->type = CONFIG_FLOAT;
-        retVal->value.float_value = value->value<float>();
+        retVal->value.float_value = record.value.floatValue;
         break;
 
     case INT_ATTRIBUTE:
         retVal->type = CONFIG_INT;
-        retVal->value.int_value = value->value<int>();
+        retVal->value.int_value = record.value.intValue;
         break;
 
     case UINT_ATTRIBUTE:
         retVal->type = CONFIG_INT;
-        retVal->value.int_value = value->value<int>();
+        retVal->value.int_value = record.value.intValue;
         break;
 
     case STRING_ATTRIBUTE:
-        free(retVal);
-        retVal = make_string_generic(value->name().c_str(), (const char *)"-", value->value<std::string>().c_str());
+        retVal->type = CONFIG_STRING;
+        generic_set_string(retVal, &(retVal->value.string_value), record.string());
         break;
 
     default:
@@ -43,44 +70,32 @@ GenericTLV *AttributeToCGeneric(std::shared_ptr<Attribute> value)
         break;
     }
 
-    retVal->ownerPlugin = value->ownerPlugin();
+    retVal->ownerPlugin = record.ownerPlugin;
+    retVal->symbol = record.symbol;
+    retVal->ingestTime = record.ingestTime;
 
     return retVal;
 }
 
+//! marshals C++ Attribute instance to C generic struct
+GenericTLV *AttributeToCGeneric(std::shared_ptr<Attribute> value)
+{
+    // strncpy(retVal->description, value->description().c_str(), value->description().size());
+    // strncpy(retVal->units, value->units().c_str(), value->units().size());
+
+    return EventRecordToCGeneric(value->record(), value->name().c_str());
+}
+
 //! marshals the C generic struct instance into an Attribute C++ generic container
 std::shared_ptr<Attribute> AttributeFromCGeneric(GenericTLV *generic)
 {
     assert(generic->ownerPlugin);
-    std::shared_ptr<Attribute> retVal(new Attribute(generic->ownerPlugin));
 
-    switch (generic->type) {
-    case CONFIG_BOOL:
-        retVal->setValue<bool>(generic->value.bool_value);
-        retVal->setType(BOOL_ATTRIBUTE);
-        break;
-    case CONFIG_FLOAT:
-        retVal->setValue<float>(generic->value.float_value);
-        retVal->setType(FLOAT_ATTRIBUTE);
-        break;
-    case CONFIG_INT:
-        retVal->setValue<int>(generic->value.int_value);
-        retVal->setType(INT_ATTRIBUTE);
-        break;
-    case CONFIG_UINT:
-        retVal->setValue<int>(generic->value.int_value);
-        retVal->setType(INT_ATTRIBUTE);
-        break;
-    case CONFIG_STRING:
-        retVal->setValue<std::string>(generic->value.string_value);
-        retVal->setType(STRING_ATTRIBUTE);
-        break;
-    default:
-        assert(false);
-        break;
-    }
+    // object and control block share a single pooled allocation
+    std::shared_ptr<Attribute> retVal = std::allocate_shared<Attribute>(PoolAllocator<Attribute>(), generic->ownerPlugin);
 
     retVal->setName(generic->name);
+    EventRecordFromCGeneric(generic, retVal->_record);
     // retVal->setDescription(generic->description);
     // retVal->setUnits(generic->units);
 
@@ -90,7 +105,13 @@ std::shared_ptr<Attribute> AttributeFromCGeneric(GenericTLV *generic)
 // -- instance methods
 
 Attribute::Attribute(SPHANDLE ownerPlugin)
-    : _ownerPlugin(ownerPlugin)
+{
+    _record.ownerPlugin = ownerPlugin;
+}
+
+Attribute::Attribute(const EventRecord &record, const std::string &name)
+    : _record(record)
+    , _name(name)
 {
 }
 
@@ -2,34 +2,42 @@
 #define __ATTRIBUTE_H
 
 #include "../../../libs/tz/tz.h" // https://github.com/HowardHinnant/date
+#include "eventRecord.h"
 #include "plugins/common/simhubdeviceplugin.h"
+#include "plugins/common/symboltable.h"
 #include <chrono>
+#include <memory>
 #include <sstream>
 #include <string>
-#include <variant.hpp>
-
-typedef enum { INT_ATTRIBUTE = 0, FLOAT_ATTRIBUTE, STRING_ATTRIBUTE, BOOL_ATTRIBUTE, UINT_ATTRIBUTE } eAttribute_t;
 
+/**
+ * Richer view over an EventRecord - adds the element name, description
+ * and units and the string conversions used by the plugins, the value,
+ * type, symbol, owner and timestamp all live in the wrapped record
+ */
 class Attribute
 {
 protected:
-    mpark::variant<int64_t, int, float, double, bool, std::string> _value;
-    mpark::variant<int64_t, int, float, double, bool, std::string> _defaultValue;
-
+    EventRecord _record;
     std::string _name;
     std::string _description;
     std::string _units;
-    std::chrono::milliseconds _timestamp;
-    eAttribute_t _type;
-    SPHANDLE _ownerPlugin;
+
+    friend std::shared_ptr<Attribute> AttributeFromCGeneric(GenericTLV *generic);
 
 public:
     Attribute(SPHANDLE ownerPlugin);
+    Attribute(const EventRecord &record, const std::string &name);
 
-    std::string name(void) const { return _name; };
+    const EventRecord &record(void) const { return _record; };
+
+    const std::string &name(void) const { return _name; };
     void setName(std::string name) { _name = name; };
 
-    SPHANDLE ownerPlugin(void) { return _ownerPlugin; };
+    SymbolId symbol(void) const { return _record.symbol; };
+    void setSymbol(SymbolId symbol) { _record.symbol = symbol; };
+
+    SPHANDLE ownerPlugin(void) { return _record.ownerPlugin; };
 
     std::string description(void) { return _description.empty() ? "none" : _description; };
     std::string units(void) { return _units.empty() ? "none" : _units; }
@@ -37,44 +45,38 @@ public:
     void setDescription(std::string description) { _description = description; };
     // void setUnits(std::string units) { _units = units; };
 
-    eAttribute_t type(void) { return _type; };
-    void setType(eAttribute_t type) { _type = type; };
+    eAttribute_t type(void) { return (eAttribute_t)_record.type; };
+    void setType(eAttribute_t type) { _record.type = type; };
 
-    std::chrono::milliseconds timestamp() { return _timestamp; };
-    std::string timestampAsString() { return std::to_string(_timestamp.count()); };
+    std::chrono::milliseconds timestamp() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::nanoseconds(_record.timestamp)); };
+    std::string timestampAsString() { return std::to_string(timestamp().count()); };
 
-    template <typename T> void setValue(T value)
-    {
-        _value = value;
-        resetTimestamp();
-    };
+    //! stores value and sets the matching type, supported for int, float, bool and std::string
+    template <typename T> void setValue(T value);
 
-    void resetTimestamp(void)
-    {
-        _timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
-    };
+    void resetTimestamp(void) { _record.resetTimestamp(); };
 
-    template <typename T> T value(void) { return mpark::get<T>(_value); };
+    template <typename T> T value(void);
 
     std::string valueToString(void)
     {
         std::ostringstream oss; // create a stream
 
-        switch (_type) {
+        switch (_record.type) {
         case INT_ATTRIBUTE:
-            oss << mpark::get<int>(_value); // insert value to stream
+            oss << _record.value.intValue; // insert value to stream
             break;
         case FLOAT_ATTRIBUTE:
-            oss << mpark::get<float>(_value); // insert value to stream
+            oss << _record.value.floatValue; // insert value to stream
             break;
         case STRING_ATTRIBUTE:
-            oss << mpark::get<std::string>(_value); // insert value to stream
+            oss << _record.string(); // insert value to stream
             break;
         case UINT_ATTRIBUTE:
-            oss << mpark::get<int>(_value); // insert value to stream
+            oss << _record.value.intValue; // insert value to stream
             break;
         case BOOL_ATTRIBUTE:
-            oss << mpark::get<bool>(_value); // insert value to stream
+            oss << (bool)_record.value.boolValue; // insert value to stream
             break;
         default:
             assert(false);
@@ -86,6 +88,50 @@ public:
     std::string timestampString();
 };
 
+template <> inline void Attribute::setValue<int>(int value)
+{
+    _record.setInt(value);
+    resetTimestamp();
+}
+
+template <> inline void Attribute::setValue<float>(float value)
+{
+    _record.setFloat(value);
+    resetTimestamp();
+}
+
+template <> inline void Attribute::setValue<bool>(bool value)
+{
+    _record.setBool(value);
+    resetTimestamp();
+}
+
+template <> inline void Attribute::setValue<std::string>(std::string value)
+{
+    _record.setString(value);
+    resetTimestamp();
+}
+
+template <> inline int Attribute::value<int>(void)
+{
+    return _record.value.intValue;
+}
+
+template <> inline float Attribute::value<float>(void)
+{
+    return _record.value.floatValue;
+}
+
+template <> inline bool Attribute::value<bool>(void)
+{
+    return _record.value.boolValue;
+}
+
+template <> inline std::string Attribute::value<std::string>(void)
+{
+    return _record.string();
+}
+
 GenericTLV *AttributeToCGeneric(std::shared_ptr<Attribute> value);
 //! marshals the C generic struct instance into an Attribute C++ generic container
 std::shared_ptr<Attribute> AttributeFromCGeneric(GenericTLV *generic);
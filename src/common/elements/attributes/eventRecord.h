@@ -0,0 +1,173 @@
+#ifndef __EVENTRECORD_H
+#define __EVENTRECORD_H
+
+#include <chrono>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <utility>
+
+#include "plugins/common/latencytracer.h"
+#include "plugins/common/simhubdeviceplugin.h"
+#include "plugins/common/symboltable.h"
+
+typedef enum { INT_ATTRIBUTE = 0, FLOAT_ATTRIBUTE, STRING_ATTRIBUTE, BOOL_ATTRIBUTE, UINT_ATTRIBUTE } eAttribute_t;
+
+#define EVENT_RECORD_SIZE 64
+#define EVENT_RECORD_INLINE_STRING 32
+
+//! set when the string payload did not fit inline and lives on the heap
+#define EVENT_RECORD_HEAP_STRING 0x01
+
+/**
+ * Compact, fixed size event as it travels through the core - one cache
+ * line holding the element symbol, a type tag, the owning plugin, a
+ * nanosecond timestamp, the monotonic ingest time used for latency
+ * tracing and the value itself
+ *
+ * - numeric and bool values are stored inline
+ * - strings shorter than EVENT_RECORD_INLINE_STRING are stored inline,
+ *   longer ones spill to a heap copy owned by the record
+ * - the element name is not carried, it is the SymbolTable entry of
+ *   symbol
+ *
+ * Attribute wraps a record where the richer (name, description,
+ * to string conversion) API is needed.
+ */
+struct EventRecord {
+    SymbolId symbol;
+    uint8_t type; ///< eAttribute_t
+    uint8_t flags;
+    uint16_t length; ///< string length, excluding the terminator
+    SPHANDLE ownerPlugin;
+    int64_t timestamp; ///< nanoseconds since the epoch (system clock)
+    int64_t ingestTime; ///< monotonic_nanos() when the event entered simhub, 0 if not traced
+
+    union {
+        int intValue;
+        float floatValue;
+        int boolValue;
+        char inlineString[EVENT_RECORD_INLINE_STRING];
+        char *heapString;
+    } value;
+
+    EventRecord(void)
+        : symbol(SYMBOL_UNRESOLVED)
+        , type(INT_ATTRIBUTE)
+        , flags(0)
+        , length(0)
+        , ownerPlugin(NULL)
+        , timestamp(0)
+        , ingestTime(0)
+    {
+        memset(&value, 0, sizeof(value));
+    };
+
+    EventRecord(const EventRecord &other)
+        : EventRecord()
+    {
+        *this = other;
+    };
+
+    EventRecord(EventRecord &&other)
+        : EventRecord()
+    {
+        *this = std::move(other);
+    };
+
+    ~EventRecord(void) { releaseString(); };
+
+    EventRecord &operator=(const EventRecord &other)
+    {
+        if (this != &other) {
+            releaseString();
+            memcpy((void *)this, (const void *)&other, sizeof(EventRecord));
+
+            if (flags & EVENT_RECORD_HEAP_STRING) {
+                value.heapString = (char *)malloc(length + 1);
+                memcpy(value.heapString, other.value.heapString, length + 1);
+            }
+        }
+
+        return *this;
+    };
+
+    EventRecord &operator=(EventRecord &&other)
+    {
+        if (this != &other) {
+            releaseString();
+            memcpy((void *)this, (const void *)&other, sizeof(EventRecord));
+
+            // ownership of any heap string moves with the record
+            other.flags &= ~EVENT_RECORD_HEAP_STRING;
+        }
+
+        return *this;
+    };
+
+    void setInt(int intValue, eAttribute_t intType = INT_ATTRIBUTE)
+    {
+        releaseString();
+        type = intType;
+        value.intValue = intValue;
+    };
+
+    void setFloat(float floatValue)
+    {
+        releaseString();
+        type = FLOAT_ATTRIBUTE;
+        value.floatValue = floatValue;
+    };
+
+    void setBool(bool boolValue)
+    {
+        releaseString();
+        type = BOOL_ATTRIBUTE;
+        value.boolValue = boolValue;
+    };
+
+    void setString(const char *stringValue, size_t stringLength)
+    {
+        releaseString();
+        type = STRING_ATTRIBUTE;
+        length = stringLength > UINT16_MAX ? UINT16_MAX : stringLength;
+
+        char *storage = value.inlineString;
+
+        if (length >= EVENT_RECORD_INLINE_STRING) {
+            storage = value.heapString = (char *)malloc(length + 1);
+            flags |= EVENT_RECORD_HEAP_STRING;
+        }
+
+        memcpy(storage, stringValue, length);
+        storage[length] = '\0';
+    };
+
+    void setString(const std::string &stringValue) { setString(stringValue.c_str(), stringValue.size()); };
+
+    //! NUL terminated string payload, only meaningful for STRING_ATTRIBUTE records
+    const char *string(void) const { return (flags & EVENT_RECORD_HEAP_STRING) ? value.heapString : value.inlineString; };
+
+    void resetTimestamp(void) { timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count(); };
+
+protected:
+    void releaseString(void)
+    {
+        if (flags & EVENT_RECORD_HEAP_STRING) {
+            free(value.heapString);
+            flags &= ~EVENT_RECORD_HEAP_STRING;
+        }
+
+        length = 0;
+    };
+};
+
+static_assert(sizeof(EventRecord) == EVENT_RECORD_SIZE, "EventRecord must stay the size of a cache line");
+
+//! fills record from the C generic struct - the record takes its own copy of any string value
+void EventRecordFromCGeneric(GenericTLV *generic, EventRecord &record);
+//! marshals record into a (pooled) C generic struct named name
+GenericTLV *EventRecordToCGeneric(const EventRecord &record, const char *name);
+
+#endif
@@ -0,0 +1,246 @@
+#include "eventLanes.h"
+
+EventLanes::EventLanes(void)
+    : _waiter(std::make_shared<QueueWaiter>())
+    , _scheduling(LANE_SCHEDULING_STRICT)
+    , _terminated(false)
+    , _cursor(0)
+    , _credit(1)
+{
+    // a single default lane until configured
+    configure(std::vector<LaneOptions>(1), LANE_SCHEDULING_STRICT);
+}
+
+EventLanes::~EventLanes(void)
+{
+}
+
+void EventLanes::configure(const std::vector<LaneOptions> &lanes, LaneScheduling scheduling)
+{
+    _lanes.clear();
+    _laneBySymbol.clear();
+    _scheduling = scheduling;
+
+    for (const LaneOptions &options : lanes) {
+        _lanes.emplace_back(new Lane(options, _waiter));
+
+        if (_lanes.back()->options.weight == 0) {
+            _lanes.back()->options.weight = 1;
+        }
+    }
+
+    if (_lanes.empty()) {
+        _lanes.emplace_back(new Lane(LaneOptions(), _waiter));
+    }
+
+    _cursor = 0;
+    _credit = _lanes[0]->options.weight;
+
+    setDropHandler(_dropHandler);
+}
+
+void EventLanes::setDropHandler(std::function<void(EventRecord &)> dropHandler)
+{
+    _dropHandler = dropHandler;
+
+    if (!dropHandler) {
+        return;
+    }
+
+    for (std::unique_ptr<Lane> &lane : _lanes) {
+        lane->queue.setDropHandler([dropHandler](LaneEntry &entry) { dropHandler(entry.event); });
+    }
+}
+
+void EventLanes::assign(SymbolId symbol, size_t lane)
+{
+    if (lane < _lanes.size()) {
+        _laneBySymbol.set(symbol, lane);
+    }
+}
+
+int EventLanes::laneIndex(const std::string &name)
+{
+    for (size_t i = 0; i < _lanes.size(); i++) {
+        if (_lanes[i]->options.name == name) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+size_t EventLanes::laneFor(SymbolId symbol, const std::string &name, int pluginLane)
+{
+    size_t *assigned = _laneBySymbol.find(symbol);
+
+    if (assigned) {
+        return *assigned;
+    }
+
+    if (pluginLane >= 0 && (size_t)pluginLane < _lanes.size()) {
+        return pluginLane;
+    }
+
+    for (size_t i = 0; i < _lanes.size(); i++) {
+        for (std::string &prefix : _lanes[i]->options.prefixes) {
+            if (name.compare(0, prefix.length(), prefix) == 0) {
+                return i;
+            }
+        }
+    }
+
+    return _lanes.size() - 1;
+}
+
+bool EventLanes::push(size_t lane, EventRecord &&event)
+{
+    if (lane >= _lanes.size()) {
+        lane = _lanes.size() - 1;
+    }
+
+    Lane &target = *_lanes[lane];
+
+    if (!target.queue.push(LaneEntry(std::move(event), monotonic_nanos()))) {
+        return false;
+    }
+
+    // only ever raised, so a relaxed compare and swap loop is enough
+    uint64_t depth = target.queue.size();
+    uint64_t highWater = target.highWater.load(std::memory_order_relaxed);
+
+    while (depth > highWater && !target.highWater.compare_exchange_weak(highWater, depth, std::memory_order_relaxed)) {
+    }
+
+    return true;
+}
+
+bool EventLanes::ready(void)
+{
+    if (_terminated) {
+        return true;
+    }
+
+    for (std::unique_ptr<Lane> &lane : _lanes) {
+        if (!lane->queue.empty()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//! pops one event from lane, recording how long it waited
+bool EventLanes::popFrom(Lane &lane, EventRecord &event, int64_t now)
+{
+    if (!lane.queue.tryPop(_popped)) {
+        return false;
+    }
+
+    lane.queueWait.record(std::chrono::nanoseconds(now - _popped.enqueueTime));
+    event = std::move(_popped.event);
+
+    return true;
+}
+
+//! takes up to budget events from the lanes according to the scheduling mode
+size_t EventLanes::drain(std::vector<EventRecord> &batch, size_t budget)
+{
+    int64_t now = monotonic_nanos();
+    size_t retVal = 0;
+    EventRecord event;
+
+    if (_scheduling == LANE_SCHEDULING_STRICT) {
+        for (std::unique_ptr<Lane> &lane : _lanes) {
+            while (retVal < budget && popFrom(*lane, event, now)) {
+                batch.push_back(std::move(event));
+                retVal++;
+            }
+        }
+
+        return retVal;
+    }
+
+    // weighted - the current lane keeps its turn until it runs out of
+    // credit or events, the turn carries over between calls
+    size_t idle = 0;
+
+    while (retVal < budget && idle <= _lanes.size()) {
+        if (_credit > 0 && popFrom(*_lanes[_cursor], event, now)) {
+            batch.push_back(std::move(event));
+            retVal++;
+            _credit--;
+            idle = 0;
+            continue;
+        }
+
+        _cursor = (_cursor + 1) % _lanes.size();
+        _credit = _lanes[_cursor]->options.weight;
+        idle++;
+    }
+
+    return retVal;
+}
+
+size_t EventLanes::popBatch(std::vector<EventRecord> &batch, size_t maxItems, std::chrono::microseconds linger)
+{
+    size_t count = 0;
+    std::chrono::steady_clock::time_point deadline;
+
+    for (;;) {
+        if (_terminated) {
+            if (count > 0) {
+                break;
+            }
+
+            throw ConcurrentQueueInterrupted();
+        }
+
+        bool first = count == 0;
+
+        count += drain(batch, maxItems - count);
+
+        if (count >= maxItems) {
+            break;
+        }
+
+        if (count == 0) {
+            _waiter->wait([this] { return ready(); });
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (first) {
+            deadline = now + linger;
+        }
+
+        if (now >= deadline) {
+            break;
+        }
+
+        _waiter->waitFor([this] { return ready(); }, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+    }
+
+    return count;
+}
+
+void EventLanes::unblock(void)
+{
+    _terminated = true;
+
+    for (std::unique_ptr<Lane> &lane : _lanes) {
+        lane->queue.unblock();
+    }
+}
+
+uint64_t EventLanes::droppedCount(void)
+{
+    uint64_t retVal = 0;
+
+    for (std::unique_ptr<Lane> &lane : _lanes) {
+        retVal += lane->queue.droppedCount();
+    }
+
+    return retVal;
+}
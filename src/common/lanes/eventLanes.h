@@ -0,0 +1,162 @@
+#ifndef __EVENTLANES_H
+#define __EVENTLANES_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "elements/attributes/eventRecord.h"
+#include "metrics/latencyStats.h"
+#include "plugins/common/alignedallocation.h"
+#include "plugins/common/symboltable.h"
+#include "queue/ring_queue.h"
+
+//! ms a producer waits on a full blocking lane before the lane's oldest events are evicted
+#define DEFAULT_LANE_BLOCK_TIMEOUT 50
+
+//! how the event loop picks between lanes that all have events waiting
+typedef enum { LANE_SCHEDULING_STRICT = 0, LANE_SCHEDULING_WEIGHTED } LaneScheduling;
+
+//! parses the config file spelling of a scheduling mode, falls back to LANE_SCHEDULING_STRICT
+inline LaneScheduling LaneSchedulingFromString(std::string scheduling)
+{
+    return scheduling == "weighted" ? LANE_SCHEDULING_WEIGHTED : LANE_SCHEDULING_STRICT;
+}
+
+//! one entry of the eventLanes.lanes list in config.cfg
+struct LaneOptions {
+    std::string name;
+    size_t capacity;
+    QueueOverflowPolicy overflowPolicy;
+    unsigned int blockTimeout; ///< ms, bounds OVERFLOW_BLOCK - plugin threads (and their connections) are never held longer
+    unsigned int weight; ///< events taken per turn under weighted scheduling
+    std::vector<std::string> prefixes; ///< element name prefixes assigned to the lane
+
+    LaneOptions(void)
+        : capacity(RING_QUEUE_DEFAULT_CAPACITY)
+        , overflowPolicy(OVERFLOW_BLOCK)
+        , blockTimeout(DEFAULT_LANE_BLOCK_TIMEOUT)
+        , weight(1){};
+};
+
+/**
+ * Priority lanes in front of the event loop - one ring queue per lane,
+ * all sharing a single QueueWaiter so the consumer sleeps on (and is
+ * woken by) any of them
+ *
+ * - lanes are listed highest priority first, strict scheduling always
+ *   drains the higher lanes before looking at the lower ones, weighted
+ *   scheduling takes up to weight events from each lane in turn
+ * - an event goes to the lane of its mapping entry, failing that to the
+ *   lane of the plugin that produced it, failing that to the lane of the
+ *   first matching name prefix, and otherwise to the last (lowest) lane
+ * - each event is stamped with monotonic_nanos() as it is pushed onto its
+ *   lane, the time it waited there is measured against that stamp when
+ *   it is popped - not against the event's wall clock timestamp, which
+ *   predates conflation - and each lane remembers the deepest it has
+ *   been (high-water mark)
+ *
+ * A single lane behaves exactly like the plain event queue.
+ */
+class EventLanes
+{
+protected:
+    //! an event and when it was pushed onto its lane
+    struct LaneEntry {
+        EventRecord event;
+        int64_t enqueueTime; ///< monotonic_nanos()
+
+        LaneEntry(void)
+            : enqueueTime(0){};
+
+        LaneEntry(EventRecord &&laneEvent, int64_t now)
+            : event(std::move(laneEvent))
+            , enqueueTime(now){};
+    };
+
+    //! heap allocated, the queue's indices are padded to their own cache lines
+    struct Lane : public AlignedAllocation<RING_QUEUE_CACHE_LINE> {
+        LaneOptions options;
+        RingQueue<LaneEntry> queue;
+        LatencyStats queueWait;
+        std::atomic<uint64_t> highWater; ///< deepest the queue has been after a push
+
+        Lane(const LaneOptions &laneOptions, std::shared_ptr<QueueWaiter> waiter)
+            : options(laneOptions)
+            , queue(laneOptions.capacity, laneOptions.overflowPolicy, waiter)
+            , highWater(0)
+        {
+            // a stalled event loop must not stall the producers, the newest events win
+            queue.setBlockTimeout(std::chrono::milliseconds(options.blockTimeout > 0 ? options.blockTimeout : DEFAULT_LANE_BLOCK_TIMEOUT), OVERFLOW_DROP_OLDEST);
+        };
+    };
+
+    std::vector<std::unique_ptr<Lane>> _lanes;
+    std::shared_ptr<QueueWaiter> _waiter;
+    LaneScheduling _scheduling;
+    SymbolIndex<size_t> _laneBySymbol;
+    std::function<void(EventRecord &)> _dropHandler;
+    std::atomic<bool> _terminated;
+
+    //! weighted scheduling position, only touched by the consumer
+    size_t _cursor;
+    unsigned int _credit;
+
+    bool ready(void);
+    size_t drain(std::vector<EventRecord> &batch, size_t budget);
+    bool popFrom(Lane &lane, EventRecord &event, int64_t now);
+    LaneEntry _popped; ///< scratch for popFrom, only touched by the consumer
+
+public:
+    EventLanes(void);
+    virtual ~EventLanes(void);
+
+    EventLanes(const EventLanes &) = delete; // disable copying
+    EventLanes &operator=(const EventLanes &) = delete; // disable assignment
+
+    /**
+     * replaces the lanes - only valid before any producer or consumer
+     * has started using them (e.g. straight after config load)
+     */
+    void configure(const std::vector<LaneOptions> &lanes, LaneScheduling scheduling);
+
+    //! called with every event evicted from any lane under OVERFLOW_DROP_OLDEST
+    void setDropHandler(std::function<void(EventRecord &)> dropHandler);
+
+    //! pins symbol to lane, wins over plugin and prefix assignment
+    void assign(SymbolId symbol, size_t lane);
+
+    //! index of the named lane, -1 if there is no such lane
+    int laneIndex(const std::string &name);
+
+    //! lane an event of symbol (named name) from a plugin assigned to pluginLane (-1 for none) goes to
+    size_t laneFor(SymbolId symbol, const std::string &name, int pluginLane = -1);
+
+    //! returns false if the event was not queued (drop-newest overflow or shutdown), event is consumed either way
+    bool push(size_t lane, EventRecord &&event);
+
+    /**
+     * batched pop across the lanes - same contract as
+     * RingQueue::popBatch, throws ConcurrentQueueInterrupted once
+     * unblock() was called
+     */
+    size_t popBatch(std::vector<EventRecord> &batch, size_t maxItems, std::chrono::microseconds linger);
+
+    void unblock(void);
+
+    size_t laneCount(void) { return _lanes.size(); };
+    LaneScheduling scheduling(void) { return _scheduling; };
+    LaneOptions &options(size_t lane) { return _lanes[lane]->options; };
+    size_t size(size_t lane) { return _lanes[lane]->queue.size(); };
+    size_t capacity(size_t lane) { return _lanes[lane]->queue.capacity(); };
+    uint64_t highWater(size_t lane) { return _lanes[lane]->highWater.load(std::memory_order_relaxed); };
+    uint64_t droppedCount(size_t lane) { return _lanes[lane]->queue.droppedCount(); };
+    uint64_t droppedCount(void);
+    LatencyStats &queueWait(size_t lane) { return _lanes[lane]->queueWait; };
+};
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef __LATENCYSTATS_H
+#define __LATENCYSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+
+//! running count/total/max of a duration, safe to read while it is being updated
+class LatencyStats
+{
+protected:
+    std::atomic<uint64_t> _count;
+    std::atomic<uint64_t> _totalNanos;
+    std::atomic<uint64_t> _maxNanos;
+
+public:
+    LatencyStats(void)
+        : _count(0)
+        , _totalNanos(0)
+        , _maxNanos(0){};
+
+    //! single writer only - max is not updated atomically with the rest
+    void record(std::chrono::nanoseconds latency)
+    {
+        uint64_t nanos = latency.count() > 0 ? latency.count() : 0;
+
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+
+        if (nanos > _maxNanos.load(std::memory_order_relaxed)) {
+            _maxNanos.store(nanos, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t count(void) { return _count; };
+    uint64_t maxNanos(void) { return _maxNanos; };
+    uint64_t meanNanos(void) { return _count ? _totalNanos / _count : 0; };
+};
+
+#endif
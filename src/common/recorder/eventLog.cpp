@@ -0,0 +1,332 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "eventLog.h"
+
+//! entries start on 8 byte boundaries
+static size_t EntrySize(size_t length)
+{
+    return (sizeof(EventLogPrefix) + length + 7) & ~(size_t)7;
+}
+
+EventLogWriter::EventLogWriter(void)
+    : _fd(-1)
+    , _mapping(NULL)
+    , _mappedSize(0)
+    , _tail(0)
+    , _eventCount(0)
+{
+}
+
+EventLogWriter::~EventLogWriter(void)
+{
+    close();
+}
+
+bool EventLogWriter::open(const std::string &path)
+{
+    close();
+
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (_fd < 0) {
+        return false;
+    }
+
+    if (!ensureCapacity(sizeof(EventLogHeader))) {
+        close();
+        return false;
+    }
+
+    EventLogHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, EVENT_LOG_MAGIC, sizeof(header.magic));
+    header.version = EVENT_LOG_VERSION;
+    header.wallClockStart = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    memcpy(_mapping, &header, sizeof(header));
+    _tail = sizeof(header);
+    _eventCount = 0;
+    _symbolWritten.clear();
+    _sources.clear();
+
+    return true;
+}
+
+void EventLogWriter::close(void)
+{
+    std::lock_guard<std::mutex> appendGuard(_appendMutex);
+
+    if (_mapping) {
+        munmap(_mapping, _mappedSize);
+        _mapping = NULL;
+        _mappedSize = 0;
+    }
+
+    if (_fd >= 0) {
+        // drop the unused part of the last growth step
+        if (ftruncate(_fd, _tail) != 0) {
+            perror("EventLogWriter: ftruncate");
+        }
+
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+//! grows file and mapping so bytes more bytes fit after the tail - call with the append lock held (or before any append)
+bool EventLogWriter::ensureCapacity(size_t bytes)
+{
+    if (_tail + bytes <= _mappedSize) {
+        return true;
+    }
+
+    size_t newSize = _mappedSize;
+
+    while (_tail + bytes > newSize) {
+        newSize += EVENT_LOG_GROWTH;
+    }
+
+    if (_mapping) {
+        munmap(_mapping, _mappedSize);
+        _mapping = NULL;
+    }
+
+    if (ftruncate(_fd, newSize) != 0) {
+        return false;
+    }
+
+    void *mapping = mmap(NULL, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    _mapping = static_cast<char *>(mapping);
+    _mappedSize = newSize;
+
+    return true;
+}
+
+//! call with the append lock held
+void EventLogWriter::writeEntry(EventLogEntryKind kind, const void *fixed, size_t fixedLength, const void *payload, size_t payloadLength)
+{
+    EventLogPrefix prefix;
+
+    memset(&prefix, 0, sizeof(prefix));
+    prefix.length = fixedLength + payloadLength;
+    prefix.kind = kind;
+
+    char *entry = _mapping + _tail;
+
+    memcpy(entry, &prefix, sizeof(prefix));
+    memcpy(entry + sizeof(prefix), fixed, fixedLength);
+
+    if (payloadLength > 0) {
+        memcpy(entry + sizeof(prefix) + fixedLength, payload, payloadLength);
+    }
+
+    _tail += EntrySize(prefix.length);
+}
+
+bool EventLogWriter::append(const EventRecord &event, const std::string &name, const std::string &source)
+{
+    std::lock_guard<std::mutex> appendGuard(_appendMutex);
+
+    if (!_mapping || event.symbol == SYMBOL_UNRESOLVED) {
+        return false;
+    }
+
+    const char *payload = event.type == STRING_ATTRIBUTE ? event.string() : NULL;
+    size_t payloadLength = event.type == STRING_ATTRIBUTE ? event.length : 0;
+
+    // worst case: symbol, source and the event itself
+    size_t needed = EntrySize(sizeof(uint32_t) + name.size()) + EntrySize(sizeof(uint32_t) + source.size()) + EntrySize(sizeof(EventLogEvent) + payloadLength);
+
+    if (!ensureCapacity(needed)) {
+        return false;
+    }
+
+    if (event.symbol >= _symbolWritten.size()) {
+        _symbolWritten.resize(event.symbol + 1, false);
+    }
+
+    if (!_symbolWritten[event.symbol]) {
+        uint32_t symbol = event.symbol;
+        writeEntry(EVENT_LOG_SYMBOL, &symbol, sizeof(symbol), name.c_str(), name.size());
+        _symbolWritten[event.symbol] = true;
+    }
+
+    std::unordered_map<std::string, uint16_t>::iterator sourceEntry = _sources.find(source);
+
+    if (sourceEntry == _sources.end()) {
+        uint32_t sourceId = _sources.size();
+        writeEntry(EVENT_LOG_SOURCE, &sourceId, sizeof(sourceId), source.c_str(), source.size());
+        sourceEntry = _sources.emplace(source, sourceId).first;
+    }
+
+    EventLogEvent logEvent;
+
+    memset(&logEvent, 0, sizeof(logEvent));
+    logEvent.timestamp = event.timestamp;
+    logEvent.ingestTime = event.ingestTime;
+    logEvent.symbol = event.symbol;
+    logEvent.source = sourceEntry->second;
+    logEvent.type = event.type;
+
+    if (event.type != STRING_ATTRIBUTE) {
+        memcpy(&logEvent.value, &event.value, sizeof(logEvent.value));
+    }
+
+    writeEntry(EVENT_LOG_EVENT, &logEvent, sizeof(logEvent), payload, payloadLength);
+    _eventCount++;
+
+    return true;
+}
+
+EventLogReader::EventLogReader(SymbolTable *symbols)
+    : _fd(-1)
+    , _mapping(NULL)
+    , _size(0)
+    , _position(0)
+    , _symbols(symbols)
+{
+    memset(&_header, 0, sizeof(_header));
+}
+
+EventLogReader::~EventLogReader(void)
+{
+    close();
+}
+
+bool EventLogReader::open(const std::string &path)
+{
+    struct stat fileStat;
+
+    close();
+
+    _fd = ::open(path.c_str(), O_RDONLY);
+
+    if (_fd < 0 || fstat(_fd, &fileStat) != 0 || (size_t)fileStat.st_size < sizeof(EventLogHeader)) {
+        close();
+        return false;
+    }
+
+    void *mapping = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, _fd, 0);
+
+    if (mapping == MAP_FAILED) {
+        close();
+        return false;
+    }
+
+    _mapping = static_cast<const char *>(mapping);
+    _size = fileStat.st_size;
+
+    memcpy(&_header, _mapping, sizeof(_header));
+
+    if (memcmp(_header.magic, EVENT_LOG_MAGIC, sizeof(_header.magic)) != 0 || _header.version != EVENT_LOG_VERSION) {
+        close();
+        return false;
+    }
+
+    rewind();
+
+    return true;
+}
+
+void EventLogReader::close(void)
+{
+    if (_mapping) {
+        munmap((void *)_mapping, _size);
+        _mapping = NULL;
+    }
+
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    _size = 0;
+    _position = 0;
+}
+
+void EventLogReader::rewind(void)
+{
+    _position = sizeof(EventLogHeader);
+}
+
+void EventLogReader::readSymbol(const char *entry, size_t length)
+{
+    uint32_t symbol;
+
+    memcpy(&symbol, entry, sizeof(symbol));
+
+    if (symbol >= _symbolMap.size()) {
+        _symbolMap.resize(symbol + 1, SYMBOL_UNRESOLVED);
+    }
+
+    _symbolMap[symbol] = _symbols->intern(std::string(entry + sizeof(symbol), length - sizeof(symbol)));
+}
+
+void EventLogReader::readSource(const char *entry, size_t length)
+{
+    uint32_t source;
+
+    memcpy(&source, entry, sizeof(source));
+
+    if (source >= _sourceNames.size()) {
+        _sourceNames.resize(source + 1);
+    }
+
+    _sourceNames[source] = std::string(entry + sizeof(source), length - sizeof(source));
+}
+
+bool EventLogReader::next(EventRecord &event, std::string &source)
+{
+    while (_mapping && _position + sizeof(EventLogPrefix) <= _size) {
+        EventLogPrefix prefix;
+
+        memcpy(&prefix, _mapping + _position, sizeof(prefix));
+
+        // zero length is the unwritten tail of a log that was not closed
+        if (prefix.length == 0 || _position + sizeof(prefix) + prefix.length > _size) {
+            break;
+        }
+
+        const char *entry = _mapping + _position + sizeof(prefix);
+        _position += EntrySize(prefix.length);
+
+        if (prefix.kind == EVENT_LOG_SYMBOL && prefix.length >= sizeof(uint32_t)) {
+            readSymbol(entry, prefix.length);
+        }
+        else if (prefix.kind == EVENT_LOG_SOURCE && prefix.length >= sizeof(uint32_t)) {
+            readSource(entry, prefix.length);
+        }
+        else if (prefix.kind == EVENT_LOG_EVENT && prefix.length >= sizeof(EventLogEvent)) {
+            EventLogEvent logEvent;
+
+            memcpy(&logEvent, entry, sizeof(logEvent));
+
+            if (logEvent.type == STRING_ATTRIBUTE) {
+                event.setString(entry + sizeof(logEvent), prefix.length - sizeof(logEvent));
+            }
+            else {
+                event.setInt(0, (eAttribute_t)logEvent.type);
+                memcpy(&event.value, &logEvent.value, sizeof(logEvent.value));
+            }
+
+            event.symbol = logEvent.symbol < _symbolMap.size() ? _symbolMap[logEvent.symbol] : SYMBOL_UNRESOLVED;
+            event.timestamp = logEvent.timestamp;
+            event.ingestTime = logEvent.ingestTime;
+            event.ownerPlugin = NULL;
+            source = logEvent.source < _sourceNames.size() ? _sourceNames[logEvent.source] : "";
+
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,144 @@
+#ifndef __EVENTLOG_H
+#define __EVENTLOG_H
+
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "elements/attributes/eventRecord.h"
+#include "plugins/common/symboltable.h"
+
+#define EVENT_LOG_MAGIC "SIMHUBEL"
+#define EVENT_LOG_VERSION 1
+//! the log file grows (and is remapped) in steps of this many bytes
+#define EVENT_LOG_GROWTH (16 * 1024 * 1024)
+
+//! kind of each length prefixed entry in an event log
+typedef enum { EVENT_LOG_SYMBOL = 1, EVENT_LOG_SOURCE, EVENT_LOG_EVENT } EventLogEntryKind;
+
+//! start of every event log file
+struct EventLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t wallClockStart; ///< nanoseconds since the epoch when recording started
+};
+
+//! precedes every entry - length counts the bytes after the prefix, 0 marks the end of the log
+struct EventLogPrefix {
+    uint32_t length;
+    uint8_t kind; ///< EventLogEntryKind
+    uint8_t reserved[3];
+};
+
+/**
+ * fixed part of an EVENT_LOG_EVENT entry, followed by the string
+ * payload for string events. Symbols and sources are the ids of the
+ * EVENT_LOG_SYMBOL / EVENT_LOG_SOURCE entries written before the
+ * first event that uses them, so a log is self contained.
+ */
+struct EventLogEvent {
+    int64_t timestamp; ///< EventRecord::timestamp
+    int64_t ingestTime; ///< EventRecord::ingestTime, replay paces on the gaps between these
+    uint32_t symbol;
+    uint16_t source;
+    uint8_t type; ///< eAttribute_t
+    uint8_t reserved;
+    int32_t value; ///< int, bool or float bits - unused for strings
+};
+
+/**
+ * Append only binary log of events written through a shared memory
+ * mapping of the log file
+ *
+ * - an append is one length prefixed entry copied into the mapping,
+ *   the element name and source plugin name are only written the first
+ *   time they are seen
+ * - the file grows in EVENT_LOG_GROWTH steps and is cut back to what
+ *   was written on close - a log left by a crash ends at the first zero
+ *   length prefix and is still readable
+ * - appends are serialised by a mutex, recording is opt in and the
+ *   critical section is a memcpy
+ */
+class EventLogWriter
+{
+protected:
+    std::mutex _appendMutex;
+    int _fd;
+    char *_mapping;
+    size_t _mappedSize;
+    size_t _tail;
+    uint64_t _eventCount;
+    std::vector<bool> _symbolWritten;
+    std::unordered_map<std::string, uint16_t> _sources;
+
+    bool ensureCapacity(size_t bytes);
+    void writeEntry(EventLogEntryKind kind, const void *fixed, size_t fixedLength, const void *payload, size_t payloadLength);
+
+public:
+    EventLogWriter(void);
+    virtual ~EventLogWriter(void);
+
+    EventLogWriter(const EventLogWriter &) = delete; // disable copying
+    EventLogWriter &operator=(const EventLogWriter &) = delete; // disable assignment
+
+    //! creates (or truncates) the log at path, returns false if it cannot be created
+    bool open(const std::string &path);
+    void close(void);
+
+    //! appends event, as produced by the plugin called source - name is the element name of event.symbol
+    bool append(const EventRecord &event, const std::string &name, const std::string &source);
+
+    bool isOpen(void) { return _mapping != NULL; };
+    uint64_t eventCount(void) { return _eventCount; };
+    size_t size(void) { return _tail; };
+};
+
+/**
+ * Reads an event log back - the log is mapped read only and walked
+ * entry by entry, recorded symbols are interned into the given table
+ * so the events carry ids of the running process
+ */
+class EventLogReader
+{
+protected:
+    int _fd;
+    const char *_mapping;
+    size_t _size;
+    size_t _position;
+    EventLogHeader _header;
+    SymbolTable *_symbols;
+    std::vector<SymbolId> _symbolMap;
+    std::vector<std::string> _sourceNames;
+
+    void readSymbol(const char *entry, size_t length);
+    void readSource(const char *entry, size_t length);
+
+public:
+    EventLogReader(SymbolTable *symbols);
+    virtual ~EventLogReader(void);
+
+    EventLogReader(const EventLogReader &) = delete; // disable copying
+    EventLogReader &operator=(const EventLogReader &) = delete; // disable assignment
+
+    //! returns false if path is not a readable event log
+    bool open(const std::string &path);
+    void close(void);
+
+    /**
+     * reads the next event - source is set to the name of the plugin
+     * that produced it
+     *
+     * @return bool false at the end of the log
+     */
+    bool next(EventRecord &event, std::string &source);
+
+    //! back to the first event
+    void rewind(void);
+
+    int64_t wallClockStart(void) { return _header.wallClockStart; };
+};
+
+#endif
@@ -0,0 +1,94 @@
+#include "eventReplay.h"
+
+EventReplay::EventReplay(SymbolTable *symbols, double speed, bool loop)
+    : _reader(symbols)
+    , _speed(speed > 0 ? speed : 0)
+    , _loop(loop)
+    , _stopping(false)
+    , _replayed(0)
+    , _finished(false)
+{
+}
+
+EventReplay::~EventReplay(void)
+{
+    stop();
+}
+
+bool EventReplay::open(const std::string &path)
+{
+    return _reader.open(path);
+}
+
+void EventReplay::start(ReplaySink sink)
+{
+    if (!_thread.joinable()) {
+        _sink = sink;
+        _stopping = false;
+        _thread = std::thread(&EventReplay::run, this);
+    }
+}
+
+void EventReplay::stop(void)
+{
+    {
+        std::lock_guard<std::mutex> stopGuard(_stopMutex);
+        _stopping = true;
+    }
+
+    _stopCondition.notify_all();
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+bool EventReplay::waitUntil(std::chrono::steady_clock::time_point deadline)
+{
+    std::unique_lock<std::mutex> stopLock(_stopMutex);
+    return !_stopCondition.wait_until(stopLock, deadline, [this] { return _stopping.load(); });
+}
+
+void EventReplay::run(void)
+{
+    EventRecord event;
+    std::string source;
+    uint64_t replayedBefore;
+
+    do {
+        replayedBefore = _replayed;
+        std::chrono::steady_clock::time_point replayStart = std::chrono::steady_clock::now();
+        int64_t recordingStart = -1;
+
+        _reader.rewind();
+
+        while (_reader.next(event, source)) {
+            if (_speed > 0) {
+                if (recordingStart < 0) {
+                    recordingStart = event.ingestTime;
+                }
+
+                std::chrono::nanoseconds offset((int64_t)((event.ingestTime - recordingStart) / _speed));
+
+                if (!waitUntil(replayStart + offset)) {
+                    return;
+                }
+            }
+            else if (_stopping) {
+                return;
+            }
+
+            if (event.symbol == SYMBOL_UNRESOLVED) {
+                continue;
+            }
+
+            event.resetTimestamp();
+            event.ingestTime = monotonic_nanos();
+
+            _sink(event, source);
+            _replayed++;
+        }
+    } while (_loop && _replayed > replayedBefore);
+
+    _finished = true;
+}
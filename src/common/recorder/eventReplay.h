@@ -0,0 +1,59 @@
+#ifndef __EVENTREPLAY_H
+#define __EVENTREPLAY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+
+#include "eventLog.h"
+
+//! called with every replayed event and the name of the plugin that originally produced it
+typedef std::function<void(EventRecord &, const std::string &)> ReplaySink;
+
+/**
+ * Built in event source that plays an event log back into the core
+ *
+ * - speed 1.0 keeps the recorded gaps between events, 2.0 halves them
+ *   and so on, speed 0 injects as fast as the sink takes them
+ * - replayed events are stamped with a fresh ingest time, so latency
+ *   is measured from the moment of replay
+ * - events run on the replay's own thread, like a plugin's would
+ */
+class EventReplay
+{
+protected:
+    EventLogReader _reader;
+    double _speed;
+    bool _loop;
+    ReplaySink _sink;
+    std::thread _thread;
+    std::mutex _stopMutex;
+    std::condition_variable _stopCondition;
+    std::atomic<bool> _stopping;
+    std::atomic<uint64_t> _replayed;
+    std::atomic<bool> _finished;
+
+    void run(void);
+    //! returns false if the replay was stopped while waiting
+    bool waitUntil(std::chrono::steady_clock::time_point deadline);
+
+public:
+    EventReplay(SymbolTable *symbols, double speed, bool loop);
+    virtual ~EventReplay(void);
+
+    //! returns false if path is not a readable event log
+    bool open(const std::string &path);
+    void start(ReplaySink sink);
+    void stop(void);
+
+    uint64_t replayed(void) { return _replayed; };
+    //! true once the whole log was played (never when looping)
+    bool finished(void) { return _finished; };
+    double speed(void) { return _speed; };
+};
+
+#endif
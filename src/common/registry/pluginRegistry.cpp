@@ -0,0 +1,38 @@
+#include "pluginRegistry.h"
+
+PluginContext *PluginRegistry::add(const PluginDescriptor &descriptor, void *host)
+{
+    if (find(descriptor.name)) {
+        return NULL;
+    }
+
+    _plugins.emplace_back(new PluginContext(descriptor, host));
+
+    return _plugins.back().get();
+}
+
+PluginContext *PluginRegistry::find(const std::string &name)
+{
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        if (plugin->descriptor.name == name) {
+            return plugin.get();
+        }
+    }
+
+    return NULL;
+}
+
+PluginContext *PluginRegistry::ownerOf(SPHANDLE pluginInstance)
+{
+    if (!pluginInstance) {
+        return NULL;
+    }
+
+    for (std::unique_ptr<PluginContext> &plugin : _plugins) {
+        if (plugin->methods.plugin_instance == pluginInstance) {
+            return plugin.get();
+        }
+    }
+
+    return NULL;
+}
@@ -0,0 +1,79 @@
+#ifndef __PLUGINREGISTRY_H
+#define __PLUGINREGISTRY_H
+
+#include <atomic>
+#include <libconfig.h++>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "delivery/deliveryWorker.h"
+#include "plugins/common/metrics.h"
+#include "plugins/common/simhubdeviceplugin.h"
+
+//! one entry of the plugins list in config.cfg
+struct PluginDescriptor {
+    std::string name; ///< unique, used by mappings and logging
+    std::string library; ///< shared library name without extension, e.g. libpokey
+    std::string configFile; ///< plugin configuration, may be empty
+    std::string lane; ///< event lane of everything the plugin produces, may be empty
+    DeliveryOptions delivery;
+};
+
+/**
+ * Everything the core keeps per loaded plugin - a pointer to the
+ * context is also the argument of the plugin's event callback so every
+ * plugin has its own callback state
+ */
+struct PluginContext {
+    PluginDescriptor descriptor;
+    libconfig::Config config;
+    simplug_vtable methods;
+    void *host; ///< the controller that loaded the plugin
+    int lane; ///< index of the descriptor's event lane, -1 for none
+
+    //! values routed to this plugin are queued here and delivered on the worker's thread
+    std::unique_ptr<DeliveryWorker> delivery;
+
+    //! series of simhub_events_ingested_total for this plugin, set when the plugin is registered
+    MetricCounter *eventsReceived;
+
+    PluginContext(const PluginDescriptor &pluginDescriptor, void *pluginHost)
+        : descriptor(pluginDescriptor)
+        , host(pluginHost)
+        , lane(-1)
+        , eventsReceived(NULL)
+    {
+        memset(&methods, 0, sizeof(simplug_vtable));
+    };
+
+    bool loaded(void) { return methods.plugin_instance != NULL; };
+};
+
+typedef std::vector<std::unique_ptr<PluginContext>> PluginList;
+
+/**
+ * Ordered set of plugins the core hosts, built from the plugins list
+ * in config.cfg - contexts never move once added, so their addresses
+ * can be handed out as callback arguments
+ */
+class PluginRegistry
+{
+protected:
+    PluginList _plugins;
+
+public:
+    //! returns NULL if a plugin of the same name is already registered
+    PluginContext *add(const PluginDescriptor &descriptor, void *host);
+    PluginContext *find(const std::string &name);
+    //! returns the context of the plugin instance, NULL if not one of ours
+    PluginContext *ownerOf(SPHANDLE pluginInstance);
+
+    PluginList::iterator begin(void) { return _plugins.begin(); };
+    PluginList::iterator end(void) { return _plugins.end(); };
+    PluginContext &operator[](size_t index) { return *_plugins[index]; };
+    size_t size(void) { return _plugins.size(); };
+    void clear(void) { _plugins.clear(); };
+};
+
+#endif
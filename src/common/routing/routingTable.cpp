@@ -0,0 +1,116 @@
+#include <algorithm>
+
+#include "routingTable.h"
+
+RoutingTable::RoutingTable(void)
+    : _routeCount(0)
+{
+}
+
+RoutingTable::~RoutingTable(void)
+{
+}
+
+void RoutingTable::addDestination(simplug_vtable *destination, const std::string &name)
+{
+    assert(destination);
+
+    _destinations.push_back({destination, name, destination->simplug_enumerate_targets == NULL, {}});
+
+    if (destination->simplug_enumerate_targets) {
+        auto targetCallback = [](void *arg, const char *name, void *handle) { static_cast<RoutingTable *>(arg)->declareTarget(name, handle); };
+        destination->simplug_enumerate_targets(destination->plugin_instance, targetCallback, this);
+    }
+}
+
+void RoutingTable::declareTarget(const std::string &target, void *handle)
+{
+    assert(!_destinations.empty());
+
+    Destination &destination = _destinations.back();
+
+    destination.acceptsAll = false;
+    destination.targets[target] = handle;
+}
+
+void RoutingTable::addMapping(const std::string &source, const std::vector<std::string> &targets, const std::vector<std::string> &destinations)
+{
+    _mappings[source] = {targets, destinations};
+}
+
+//! appends a route to target for every destination that will take it
+void RoutingTable::resolveTarget(SymbolTable *symbols, const std::string &source, const std::string &target, const std::vector<std::string> &destinations, RouteList &routes)
+{
+    SymbolId targetSymbol = target == source ? SYMBOL_UNRESOLVED : symbols->intern(target);
+
+    for (size_t index = 0; index < _destinations.size(); index++) {
+        Destination &destination = _destinations[index];
+
+        if (!destinations.empty() && std::find(destinations.begin(), destinations.end(), destination.name) == destinations.end()) {
+            continue;
+        }
+
+        std::map<std::string, void *>::iterator declared = destination.targets.find(target);
+
+        if (declared != destination.targets.end()) {
+            routes.push_back({destination.plugin, index, targetSymbol, declared->second});
+        }
+        else if (destination.acceptsAll) {
+            routes.push_back({destination.plugin, index, targetSymbol, NULL});
+        }
+    }
+}
+
+void RoutingTable::compile(SymbolTable *symbols)
+{
+    assert(symbols);
+
+    _routes.clear();
+    _defaultRoutes.clear();
+    _routeCount = 0;
+
+    // mapped sources go to their targets only
+    for (std::pair<const std::string, Mapping> &mapping : _mappings) {
+        RouteList routes;
+
+        for (std::string &target : mapping.second.targets) {
+            resolveTarget(symbols, mapping.first, target, mapping.second.destinations, routes);
+        }
+
+        _routeCount += routes.size();
+        _routes.set(symbols->intern(mapping.first), routes);
+    }
+
+    // declared targets that are not mapped sources are delivered under their own name
+    for (Destination &destination : _destinations) {
+        for (std::pair<const std::string, void *> &target : destination.targets) {
+            SymbolId source = symbols->intern(target.first);
+
+            if (_mappings.count(target.first) || _routes.contains(source)) {
+                continue;
+            }
+
+            RouteList routes;
+            resolveTarget(symbols, target.first, target.first, std::vector<std::string>(), routes);
+
+            _routeCount += routes.size();
+            _routes.set(source, routes);
+        }
+    }
+
+    // anything else goes to the destinations that accept all elements
+    for (size_t index = 0; index < _destinations.size(); index++) {
+        if (_destinations[index].acceptsAll) {
+            _defaultRoutes.push_back({_destinations[index].plugin, index, SYMBOL_UNRESOLVED, NULL});
+        }
+    }
+}
+
+void RoutingTable::clear(void)
+{
+    _destinations.clear();
+    _mappings.clear();
+    _routes.clear();
+    _defaultRoutes.clear();
+    _routeCount = 0;
+}
@@ -0,0 +1,93 @@
+#ifndef __ROUTINGTABLE_H
+#define __ROUTINGTABLE_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "plugins/common/simhubdeviceplugin.h"
+#include "plugins/common/symboltable.h"
+
+//! one pre-resolved delivery of a source element
+struct Route {
+    simplug_vtable *destination;
+    size_t destinationIndex; ///< position of destination in the table, for per destination batching
+    SymbolId target; ///< name the value is delivered under, SYMBOL_UNRESOLVED for the source's own name
+    void *handle; ///< what the destination declared for target, NULL if it did not declare it
+};
+
+typedef std::vector<Route> RouteList;
+
+/**
+ * Source element to destination lookup, compiled once at startup from
+ * the mapping configuration and the targets the plugins declare through
+ * simplug_enumerate_targets
+ *
+ * - a mapped source is delivered to each of its targets (fan-out),
+ *   under the target's name (renaming)
+ * - an unmapped source is delivered under its own name
+ * - a target goes to every destination that declared it, and to every
+ *   destination that does not declare targets at all (accepts anything)
+ * - a mapping can name the destinations it is limited to
+ *
+ * Compiled routes are a flat symbol indexed array, so the event path
+ * does a single lookup per event. routes() is read only and can be
+ * called from any thread once compile() has returned.
+ */
+class RoutingTable
+{
+protected:
+    struct Destination {
+        simplug_vtable *plugin;
+        std::string name;
+        bool acceptsAll;
+        std::map<std::string, void *> targets;
+    };
+
+    struct Mapping {
+        std::vector<std::string> targets;
+        std::vector<std::string> destinations; ///< empty for any destination
+    };
+
+    std::vector<Destination> _destinations;
+    std::map<std::string, Mapping> _mappings;
+    SymbolIndex<RouteList> _routes;
+    RouteList _defaultRoutes;
+    size_t _routeCount;
+
+    void resolveTarget(SymbolTable *symbols, const std::string &source, const std::string &target, const std::vector<std::string> &destinations, RouteList &routes);
+
+public:
+    RoutingTable(void);
+    virtual ~RoutingTable(void);
+
+    //! registers a delivery destination, asking it for its targets if it can enumerate them
+    void addDestination(simplug_vtable *destination, const std::string &name = "");
+    //! declares that the most recently added destination accepts target
+    void declareTarget(const std::string &target, void *handle);
+    //! source is delivered as each of targets instead of under its own name, optionally only to the named destinations
+    void addMapping(const std::string &source, const std::vector<std::string> &targets, const std::vector<std::string> &destinations = std::vector<std::string>());
+
+    //! resolves every mapping and declared target into flat route lists
+    void compile(SymbolTable *symbols);
+    void clear(void);
+
+    //! routes for source - skip the ones IsEcho() flags
+    const RouteList &routes(SymbolId source)
+    {
+        RouteList *retVal = _routes.find(source);
+        return retVal ? *retVal : _defaultRoutes;
+    }
+
+    //! true if delivering route would hand an event straight back to the plugin it came from
+    static bool IsEcho(const Route &route, SymbolId source, SPHANDLE ownerPlugin)
+    {
+        return route.destination->plugin_instance == ownerPlugin && (route.target == SYMBOL_UNRESOLVED || route.target == source);
+    }
+
+    size_t routeCount(void) { return _routeCount; };
+    size_t destinationCount(void) { return _destinations.size(); };
+    simplug_vtable *destination(size_t index) { return _destinations[index].plugin; };
+};
+
+#endif
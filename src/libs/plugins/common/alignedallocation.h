@@ -0,0 +1,35 @@
+#ifndef __ALIGNEDALLOCATION_H
+#define __ALIGNEDALLOCATION_H
+
+#include <new>
+#include <stddef.h>
+#include <stdlib.h>
+
+/**
+ * Class scope operator new and delete for types aligned beyond what
+ * ::operator new guarantees
+ *
+ * - before C++17 (the tree builds with --std=c++14) new ignores
+ *   alignas on the type, a heap allocated object whose members are
+ *   padded to their own cache lines would still share lines with its
+ *   neighbours
+ * - derive from AlignedAllocation<Alignment> to have new and delete of
+ *   the type go through posix_memalign - make_shared does not use them,
+ *   allocate such types with new
+ */
+template <size_t Alignment> struct AlignedAllocation {
+    static void *operator new(size_t size)
+    {
+        void *retVal = NULL;
+
+        if (posix_memalign(&retVal, Alignment, size) != 0) {
+            throw std::bad_alloc();
+        }
+
+        return retVal;
+    }
+
+    static void operator delete(void *pointer) { free(pointer); }
+};
+
+#endif
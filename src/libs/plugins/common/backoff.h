@@ -0,0 +1,76 @@
+#ifndef __BACKOFF_H
+#define __BACKOFF_H
+
+#include <algorithm>
+#include <random>
+#include <stdint.h>
+
+#define BACKOFF_DEFAULT_INITIAL 250
+#define BACKOFF_DEFAULT_MAXIMUM 30000
+#define BACKOFF_DEFAULT_MULTIPLIER 2.0
+#define BACKOFF_DEFAULT_JITTER 0.5
+
+/**
+ * Jittered exponential backoff for reconnect attempts
+ *
+ * - the ceiling starts at initial ms and grows by multiplier per
+ *   attempt up to maximum ms
+ * - each delay is drawn uniformly from [ceiling * (1 - jitter), ceiling]
+ *   so peers that lost the same server do not retry in lockstep
+ * - reset() once a connection is up again
+ */
+class Backoff
+{
+protected:
+    uint64_t _initial;
+    uint64_t _maximum;
+    double _multiplier;
+    double _jitter;
+    double _ceiling;
+    uint64_t _attempts;
+    std::mt19937 _random;
+
+public:
+    Backoff(uint64_t initial = BACKOFF_DEFAULT_INITIAL, uint64_t maximum = BACKOFF_DEFAULT_MAXIMUM, double multiplier = BACKOFF_DEFAULT_MULTIPLIER, double jitter = BACKOFF_DEFAULT_JITTER)
+        : _random(std::random_device()())
+    {
+        configure(initial, maximum, multiplier, jitter);
+    };
+
+    void configure(uint64_t initial, uint64_t maximum, double multiplier, double jitter)
+    {
+        _initial = std::max<uint64_t>(initial, 1);
+        _maximum = std::max(maximum, _initial);
+        _multiplier = std::max(multiplier, 1.0);
+        _jitter = std::min(std::max(jitter, 0.0), 1.0);
+        reset();
+    }
+
+    //! makes the jitter reproducible
+    void seed(uint32_t seed) { _random.seed(seed); }
+
+    //! ms to wait before the next attempt
+    uint64_t next(void)
+    {
+        double low = _ceiling * (1.0 - _jitter);
+        uint64_t retVal = (uint64_t)std::uniform_real_distribution<double>(low, _ceiling)(_random);
+
+        _attempts++;
+        _ceiling = std::min(_ceiling * _multiplier, (double)_maximum);
+
+        return std::max<uint64_t>(retVal, 1);
+    }
+
+    void reset(void)
+    {
+        _ceiling = (double)_initial;
+        _attempts = 0;
+    }
+
+    //! attempts since the last reset
+    uint64_t attempts(void) const { return _attempts; };
+    uint64_t initial(void) const { return _initial; };
+    uint64_t maximum(void) const { return _maximum; };
+};
+
+#endif
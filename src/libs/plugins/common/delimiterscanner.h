@@ -0,0 +1,205 @@
+#ifndef __DELIMITERSCANNER_H
+#define __DELIMITERSCANNER_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DELIMITER_SCANNER_X86
+#endif
+
+//! offset of a record without an '='
+#define DELIMITER_NONE UINT32_MAX
+
+//! where the fields of one "NAME = value\n" record end - offsets are relative to the scanned buffer
+struct FieldOffsets {
+    uint32_t assign; ///< first '=' of the record, DELIMITER_NONE if it has none
+    uint32_t end; ///< the record's '\n'
+};
+
+/**
+ * The records found by a scan, in order, plus the first '=' of a
+ * record whose '\n' has not been scanned yet - scanning the rest of
+ * the buffer later completes that record
+ */
+struct DelimiterIndex {
+    std::vector<FieldOffsets> records;
+    uint32_t pendingAssign;
+
+    DelimiterIndex(void)
+        : pendingAssign(DELIMITER_NONE){};
+
+    //! appends the records of one block given its '\n' and '=' bit masks (bit n is offset + n)
+    void consume(uint32_t offset, uint64_t newlines, uint64_t assigns)
+    {
+        uint64_t delimiters = newlines | assigns;
+
+        while (delimiters) {
+            int bit = __builtin_ctzll(delimiters);
+            uint64_t mask = (uint64_t)1 << bit;
+
+            if (newlines & mask) {
+                records.push_back({pendingAssign, offset + bit});
+                pendingAssign = DELIMITER_NONE;
+            }
+            else if (pendingAssign == DELIMITER_NONE) {
+                pendingAssign = offset + bit;
+            }
+
+            delimiters &= delimiters - 1;
+        }
+    }
+
+    //! the buffer moved down by bytes, see LineFramer::compact
+    void shift(uint32_t bytes)
+    {
+        if (pendingAssign != DELIMITER_NONE) {
+            pendingAssign -= bytes;
+        }
+    }
+
+    void reset(void)
+    {
+        records.clear();
+        pendingAssign = DELIMITER_NONE;
+    }
+};
+
+typedef enum { SCAN_SCALAR = 0, SCAN_SSE2, SCAN_AVX2 } ScanLevel;
+
+//! byte at a time, also finishes the tail the vector paths leave
+inline void ScanDelimitersScalar(const char *data, size_t length, uint32_t base, DelimiterIndex &index)
+{
+    for (size_t i = 0; i < length; i++) {
+        if (data[i] == '\n') {
+            index.records.push_back({index.pendingAssign, base + (uint32_t)i});
+            index.pendingAssign = DELIMITER_NONE;
+        }
+        else if (data[i] == '=' && index.pendingAssign == DELIMITER_NONE) {
+            index.pendingAssign = base + (uint32_t)i;
+        }
+    }
+}
+
+#if defined(DELIMITER_SCANNER_X86)
+
+__attribute__((target("sse2"))) inline void ScanDelimitersSSE2(const char *data, size_t length, uint32_t base, DelimiterIndex &index)
+{
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i assign = _mm_set1_epi8('=');
+    size_t i = 0;
+
+    // two blocks per step so each consume sees 32 bytes of masks
+    for (; i + 32 <= length; i += 32) {
+        __m128i low = _mm_loadu_si128((const __m128i *)(data + i));
+        __m128i high = _mm_loadu_si128((const __m128i *)(data + i + 16));
+
+        uint64_t newlines = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(low, newline)) | ((uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(high, newline)) << 16);
+        uint64_t assigns = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(low, assign)) | ((uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(high, assign)) << 16);
+
+        if (newlines | assigns) {
+            index.consume(base + (uint32_t)i, newlines, assigns);
+        }
+    }
+
+    ScanDelimitersScalar(data + i, length - i, base + (uint32_t)i, index);
+}
+
+__attribute__((target("avx2"))) inline void ScanDelimitersAVX2(const char *data, size_t length, uint32_t base, DelimiterIndex &index)
+{
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i assign = _mm256_set1_epi8('=');
+    size_t i = 0;
+
+    for (; i + 64 <= length; i += 64) {
+        __m256i low = _mm256_loadu_si256((const __m256i *)(data + i));
+        __m256i high = _mm256_loadu_si256((const __m256i *)(data + i + 32));
+
+        uint64_t newlines = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline)) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)) << 32);
+        uint64_t assigns = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, assign)) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, assign)) << 32);
+
+        if (newlines | assigns) {
+            index.consume(base + (uint32_t)i, newlines, assigns);
+        }
+    }
+
+    ScanDelimitersSSE2(data + i, length - i, base + (uint32_t)i, index);
+}
+
+#endif
+
+/**
+ * Locates every '\n' and '=' of a buffer in one pass and appends a
+ * FieldOffsets per complete record to an index
+ *
+ * - the widest vector path the cpu supports (AVX2, SSE2) is picked at
+ *   runtime, everything else scans byte at a time
+ * - a buffer can be scanned in pieces, the index carries the state of
+ *   the record the previous piece ended in
+ */
+class DelimiterScanner
+{
+protected:
+    typedef void (*ScanFunction)(const char *, size_t, uint32_t, DelimiterIndex &);
+
+    ScanLevel _level;
+    ScanFunction _scan;
+
+public:
+    //! level is clamped to what the cpu supports
+    DelimiterScanner(ScanLevel level = BestLevel())
+    {
+        _level = Supported(level) ? level : BestLevel();
+
+        switch (_level) {
+#if defined(DELIMITER_SCANNER_X86)
+        case SCAN_AVX2:
+            _scan = ScanDelimitersAVX2;
+            break;
+        case SCAN_SSE2:
+            _scan = ScanDelimitersSSE2;
+            break;
+#endif
+        default:
+            _scan = ScanDelimitersScalar;
+            break;
+        }
+    }
+
+    //! scans length bytes, offsets in the index are base + the offset into data
+    void scan(const char *data, size_t length, uint32_t base, DelimiterIndex &index) const { _scan(data, length, base, index); }
+
+    ScanLevel level(void) const { return _level; };
+
+    static bool Supported(ScanLevel level)
+    {
+#if defined(DELIMITER_SCANNER_X86)
+        switch (level) {
+        case SCAN_AVX2:
+            return __builtin_cpu_supports("avx2");
+        case SCAN_SSE2:
+            return __builtin_cpu_supports("sse2");
+        default:
+            return true;
+        }
+#else
+        return level == SCAN_SCALAR;
+#endif
+    }
+
+    static ScanLevel BestLevel(void)
+    {
+        static const ScanLevel best = Supported(SCAN_AVX2) ? SCAN_AVX2 : (Supported(SCAN_SSE2) ? SCAN_SSE2 : SCAN_SCALAR);
+        return best;
+    }
+
+    static const char *LevelName(ScanLevel level)
+    {
+        static const char *names[] = {"scalar", "sse2", "avx2"};
+        return names[level];
+    }
+};
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef __HDRHISTOGRAM_H
+#define __HDRHISTOGRAM_H
+
+#include <atomic>
+#include <math.h>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+//! sub-buckets per power of two are 2^(HDR_SUB_BUCKET_HALF_MAGNITUDE + 1), ~0.4% resolution
+#define HDR_SUB_BUCKET_HALF_MAGNITUDE 7
+//! largest trackable value is 2^HDR_MAX_MAGNITUDE - 1, anything above is clamped (~18 minutes in ns)
+#define HDR_MAX_MAGNITUDE 40
+
+/**
+ * Lock-free high dynamic range histogram (after Gil Tene's
+ * HdrHistogram) for latencies in nanoseconds
+ *
+ * - values are bucketed by power of two, each power of two is split
+ *   into linear sub-buckets so every recorded value is kept with a
+ *   fixed relative precision regardless of its magnitude
+ * - record() is one relaxed fetch_add on the bucket plus the totals, so
+ *   any number of threads can record while another one reads
+ * - percentiles are computed from a racy (but per bucket consistent)
+ *   walk over the counts - good enough for monitoring
+ *
+ * Header only so the core and the plugins can record into the same
+ * instance across the plugin boundary.
+ */
+class HdrHistogram
+{
+protected:
+    static const int _subBucketHalfCount = 1 << HDR_SUB_BUCKET_HALF_MAGNITUDE;
+    static const uint64_t _subBucketMask = (uint64_t)(2 * _subBucketHalfCount) - 1;
+    static const int _bucketCount = HDR_MAX_MAGNITUDE - HDR_SUB_BUCKET_HALF_MAGNITUDE;
+    static const size_t _countsLength = (size_t)(_bucketCount + 1) * _subBucketHalfCount;
+    static const uint64_t _highestTrackable = (1ULL << HDR_MAX_MAGNITUDE) - 1;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> _counts;
+    std::atomic<uint64_t> _totalCount;
+    std::atomic<uint64_t> _sum;
+    std::atomic<uint64_t> _min;
+    std::atomic<uint64_t> _max;
+
+    static int BucketIndex(uint64_t value) { return (63 - __builtin_clzll(value | _subBucketMask)) - HDR_SUB_BUCKET_HALF_MAGNITUDE; }
+
+    static size_t CountsIndex(uint64_t value)
+    {
+        int bucketIndex = BucketIndex(value);
+        uint64_t subBucketIndex = value >> bucketIndex;
+
+        return ((size_t)(bucketIndex + 1) << HDR_SUB_BUCKET_HALF_MAGNITUDE) + (subBucketIndex - _subBucketHalfCount);
+    }
+
+    //! largest value that lands in the same bucket as the one at index
+    static uint64_t HighestEquivalentValue(size_t index)
+    {
+        int bucketIndex = (int)(index >> HDR_SUB_BUCKET_HALF_MAGNITUDE) - 1;
+        uint64_t subBucketIndex = (index & (_subBucketHalfCount - 1)) + _subBucketHalfCount;
+
+        if (bucketIndex < 0) {
+            subBucketIndex -= _subBucketHalfCount;
+            bucketIndex = 0;
+        }
+
+        return (subBucketIndex << bucketIndex) + ((1ULL << bucketIndex) - 1);
+    }
+
+public:
+    HdrHistogram(void)
+        : _counts(new std::atomic<uint64_t>[_countsLength])
+    {
+        reset();
+    };
+
+    HdrHistogram(const HdrHistogram &) = delete; // disable copying
+    HdrHistogram &operator=(const HdrHistogram &) = delete; // disable assignment
+
+    void record(uint64_t value)
+    {
+        if (value > _highestTrackable) {
+            value = _highestTrackable;
+        }
+
+        _counts[CountsIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        _totalCount.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(value, std::memory_order_relaxed);
+
+        uint64_t current = _max.load(std::memory_order_relaxed);
+
+        while (value > current && !_max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+
+        current = _min.load(std::memory_order_relaxed);
+
+        while (value < current && !_min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    //! value at or below which percentile (0.0 - 100.0) percent of the recorded values fall
+    uint64_t percentile(double percentile)
+    {
+        uint64_t total = _totalCount.load(std::memory_order_relaxed);
+
+        if (total == 0) {
+            return 0;
+        }
+
+        uint64_t target = (uint64_t)ceil((percentile / 100.0) * total);
+        uint64_t seen = 0;
+
+        target = target == 0 ? 1 : target;
+
+        for (size_t i = 0; i < _countsLength; i++) {
+            seen += _counts[i].load(std::memory_order_relaxed);
+
+            if (seen >= target) {
+                uint64_t retVal = HighestEquivalentValue(i);
+                uint64_t max = _max.load(std::memory_order_relaxed);
+
+                return retVal < max ? retVal : max;
+            }
+        }
+
+        return _max.load(std::memory_order_relaxed);
+    }
+
+    void reset(void)
+    {
+        for (size_t i = 0; i < _countsLength; i++) {
+            _counts[i].store(0, std::memory_order_relaxed);
+        }
+
+        _totalCount.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _min.store(UINT64_MAX, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count(void) { return _totalCount.load(std::memory_order_relaxed); }
+    //! sum of all recorded (clamped) values
+    uint64_t sum(void) { return _sum.load(std::memory_order_relaxed); }
+    uint64_t min(void) { return count() ? _min.load(std::memory_order_relaxed) : 0; }
+    uint64_t max(void) { return _max.load(std::memory_order_relaxed); }
+};
+
+#endif
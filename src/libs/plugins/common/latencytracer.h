@@ -0,0 +1,65 @@
+#ifndef __LATENCYTRACER_H
+#define __LATENCYTRACER_H
+
+#include <chrono>
+#include <stdint.h>
+
+#include "hdrhistogram.h"
+
+//! points on an event's way through simhub, in order - each is timed from the ingest of the event
+typedef enum {
+    LATENCY_STAGE_PARSE = 0, ///< plugin has turned the raw input into a generic
+    LATENCY_STAGE_ENQUEUE, ///< core has queued the event
+    LATENCY_STAGE_DEQUEUE, ///< event loop has taken the event off its lane
+    LATENCY_STAGE_DELIVER, ///< destination plugin's deliver entry point
+    LATENCY_STAGE_COMPLETE, ///< hardware or socket write has completed
+    LATENCY_STAGE_COUNT
+} LatencyStage;
+
+//! monotonic clock used for all ingest times, nanoseconds
+inline int64_t monotonic_nanos(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * End to end latency of events from ingest (socket read, pin scan) to
+ * each later stage, one HdrHistogram per stage
+ *
+ * - the ingest time travels with the event (GenericTLV::ingestTime,
+ *   EventRecord::ingestTime), events without one are not traced
+ * - owned by the core and handed to plugins with
+ *   simplug_bind_latency_tracer so both sides record into it
+ */
+class LatencyTracer
+{
+protected:
+    HdrHistogram _stages[LATENCY_STAGE_COUNT];
+
+public:
+    //! records the time from ingestTime to now against stage
+    void record(LatencyStage stage, int64_t ingestTime)
+    {
+        if (ingestTime > 0) {
+            int64_t elapsed = monotonic_nanos() - ingestTime;
+            _stages[stage].record(elapsed > 0 ? elapsed : 0);
+        }
+    }
+
+    HdrHistogram &histogram(LatencyStage stage) { return _stages[stage]; }
+
+    void reset(void)
+    {
+        for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+            _stages[stage].reset();
+        }
+    }
+
+    static const char *StageName(LatencyStage stage)
+    {
+        static const char *names[LATENCY_STAGE_COUNT] = {"parse", "enqueue", "dequeue", "deliver", "complete"};
+        return stage < LATENCY_STAGE_COUNT ? names[stage] : "unknown";
+    }
+};
+
+#endif
@@ -0,0 +1,258 @@
+#ifndef __LINEFRAMER_H
+#define __LINEFRAMER_H
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+
+#include "delimiterscanner.h"
+
+#define LINE_FRAMER_DEFAULT_CAPACITY (64 * 1024)
+
+//! non owning view of text inside a framer's buffer - data[length] is always '\0'
+struct TextView {
+    char *data;
+    size_t length;
+
+    TextView(void)
+        : data(NULL)
+        , length(0){};
+
+    TextView(char *text, size_t textLength)
+        : data(text)
+        , length(textLength){};
+
+    bool empty(void) const { return length == 0; };
+    std::string str(void) const { return std::string(data, length); };
+};
+
+/**
+ * splits a "NAME = value" record at its first '=' (assign, already
+ * located by the caller) in place - surrounding blanks are trimmed and
+ * both halves '\0' terminated so they can be used as C strings,
+ * returns false if there is no '=' or the name is empty
+ */
+inline bool SplitRecord(char *line, size_t length, char *assign, TextView &name, TextView &value)
+{
+    if (!assign || assign >= line + length) {
+        return false;
+    }
+
+    char *nameEnd = assign;
+    char *valueStart = assign + 1;
+    char *valueEnd = line + length;
+
+    while (nameEnd > line && (nameEnd[-1] == ' ' || nameEnd[-1] == '\t')) {
+        nameEnd--;
+    }
+
+    while (valueStart < valueEnd && (*valueStart == ' ' || *valueStart == '\t')) {
+        valueStart++;
+    }
+
+    while (valueEnd > valueStart && (valueEnd[-1] == ' ' || valueEnd[-1] == '\t')) {
+        valueEnd--;
+    }
+
+    if (nameEnd == line) {
+        return false;
+    }
+
+    *nameEnd = '\0';
+    *valueEnd = '\0';
+
+    name = TextView(line, nameEnd - line);
+    value = TextView(valueStart, valueEnd - valueStart);
+
+    return true;
+}
+
+inline bool SplitRecord(char *line, size_t length, TextView &name, TextView &value)
+{
+    return SplitRecord(line, length, (char *)memchr(line, '=', length), name, value);
+}
+
+/**
+ * Streaming '\n' framer over one reusable buffer
+ *
+ * - socket reads land straight in the buffer (writeSpace()/commit()),
+ *   or are copied in with append() where the caller owns the bytes
+ * - frame() hands every complete line to the handler in place, the
+ *   line end ("\n" or "\r\n") replaced by '\0' - nothing is allocated
+ *   per line
+ * - new bytes are indexed once by a DelimiterScanner, so frameRecords()
+ *   can also hand out where each line's first '=' is
+ * - a line split across reads stays in the buffer until the rest of
+ *   it arrives, it is moved to the front when space runs out
+ * - a line longer than the buffer is dropped (up to its line end) and
+ *   counted, it cannot be framed without growing the buffer
+ */
+class LineFramer
+{
+protected:
+    char *_buffer;
+    size_t _capacity;
+    size_t _start; ///< first byte of the oldest unframed line
+    size_t _scanned; ///< bytes before this are indexed
+    size_t _end; ///< one past the last received byte
+    bool _discarding; ///< dropping the rest of an overlong line
+    std::atomic<uint64_t> _overlongLines; ///< read by the metrics scrape
+    DelimiterScanner _scanner;
+    DelimiterIndex _index;
+
+    //! moves the partial line to the front of the buffer
+    void compact(void)
+    {
+        if (_start > 0) {
+            memmove(_buffer, _buffer + _start, _end - _start);
+            _index.shift(_start);
+            _scanned -= _start;
+            _end -= _start;
+            _start = 0;
+        }
+
+        if (_end == _capacity) {
+            // one line fills the whole buffer - drop it and skip to its end
+            if (!_discarding) {
+                _overlongLines.fetch_add(1, std::memory_order_relaxed);
+                _discarding = true;
+            }
+
+            _start = _scanned = _end = 0;
+            _index.reset();
+        }
+    }
+
+public:
+    LineFramer(size_t capacity = LINE_FRAMER_DEFAULT_CAPACITY, ScanLevel scanLevel = DelimiterScanner::BestLevel())
+        : _buffer((char *)malloc(capacity))
+        , _capacity(_buffer ? capacity : 0)
+        , _start(0)
+        , _scanned(0)
+        , _end(0)
+        , _discarding(false)
+        , _overlongLines(0)
+        , _scanner(scanLevel){};
+
+    ~LineFramer(void) { free(_buffer); };
+
+    LineFramer(const LineFramer &) = delete; // disable copying
+    LineFramer &operator=(const LineFramer &) = delete; // disable assignment
+
+    //! where the next read should land, never empty for a framer with capacity
+    char *writeSpace(void)
+    {
+        if (_end == _capacity) {
+            compact();
+        }
+
+        return _buffer + _end;
+    }
+
+    size_t writeSpaceSize(void)
+    {
+        if (_end == _capacity) {
+            compact();
+        }
+
+        return _capacity - _end;
+    }
+
+    //! accounts for bytes written into writeSpace()
+    void commit(size_t bytes) { _end += bytes < _capacity - _end ? bytes : _capacity - _end; };
+
+    //! copies length bytes in, framing as the buffer fills, see frameRecords - returns the number of lines framed
+    template <typename F> size_t appendRecords(const char *data, size_t length, F handler)
+    {
+        size_t retVal = 0;
+
+        while (length > 0) {
+            size_t space = writeSpaceSize();
+            size_t chunk = length < space ? length : space;
+
+            memcpy(writeSpace(), data, chunk);
+            commit(chunk);
+            retVal += frameRecords(handler);
+
+            data += chunk;
+            length -= chunk;
+        }
+
+        return retVal;
+    }
+
+    //! as appendRecords for a handler(char *line, size_t length)
+    template <typename F> size_t append(const char *data, size_t length, F handler)
+    {
+        return appendRecords(data, length, [&handler](char *line, size_t lineLength, char *) { handler(line, lineLength); });
+    }
+
+    /**
+     * calls handler(char *line, size_t length, char *assign) for every
+     * complete line received, assign is the line's first '=' or NULL -
+     * the line is only valid during the call
+     *
+     * @return size_t the number of lines handed out
+     */
+    template <typename F> size_t frameRecords(F handler)
+    {
+        size_t retVal = 0;
+
+        if (_scanned < _end) {
+            _scanner.scan(_buffer + _scanned, _end - _scanned, (uint32_t)_scanned, _index);
+            _scanned = _end;
+        }
+
+        for (const FieldOffsets &record : _index.records) {
+            char *line = _buffer + _start;
+            size_t length = record.end - _start;
+
+            _start = record.end + 1;
+
+            if (_discarding) {
+                _discarding = false;
+                continue;
+            }
+
+            if (length > 0 && line[length - 1] == '\r') {
+                length--;
+            }
+
+            line[length] = '\0';
+            handler(line, length, record.assign == DELIMITER_NONE ? NULL : _buffer + record.assign);
+            retVal++;
+        }
+
+        _index.records.clear();
+
+        if (_start == _end) {
+            _start = _scanned = _end = 0;
+        }
+
+        return retVal;
+    }
+
+    //! calls handler(char *line, size_t length) for every complete line, see frameRecords
+    template <typename F> size_t frame(F handler)
+    {
+        return frameRecords([&handler](char *line, size_t length, char *) { handler(line, length); });
+    }
+
+    //! bytes of an incomplete line waiting for the rest of it
+    size_t pending(void) const { return _end - _start; };
+    size_t capacity(void) const { return _capacity; };
+    uint64_t overlongLines(void) const { return _overlongLines.load(std::memory_order_relaxed); };
+
+    ScanLevel scanLevel(void) const { return _scanner.level(); };
+
+    void reset(void)
+    {
+        _start = _scanned = _end = 0;
+        _discarding = false;
+        _index.reset();
+    }
+};
+
+#endif
@@ -0,0 +1,312 @@
+#ifndef __METRICS_H
+#define __METRICS_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "alignedallocation.h"
+#include "hdrhistogram.h"
+
+#define METRIC_COUNTER_SHARDS 8
+#define METRIC_CACHE_LINE 64
+
+//! shard of the calling thread - threads are spread over the shards round robin
+inline size_t MetricShardIndex(void)
+{
+    static std::atomic<size_t> nextShard(0);
+    static thread_local size_t shard = nextShard.fetch_add(1, std::memory_order_relaxed) % METRIC_COUNTER_SHARDS;
+    return shard;
+}
+
+/**
+ * Monotonic counter sharded per thread - each thread adds to its own
+ * cache line so producers on different threads never contend, value()
+ * sums the shards
+ */
+class MetricCounter : public AlignedAllocation<METRIC_CACHE_LINE>
+{
+protected:
+    struct alignas(METRIC_CACHE_LINE) Shard {
+        std::atomic<uint64_t> value;
+    };
+
+    Shard _shards[METRIC_COUNTER_SHARDS];
+
+public:
+    MetricCounter(void)
+    {
+        for (Shard &shard : _shards) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    void add(uint64_t amount = 1) { _shards[MetricShardIndex()].value.fetch_add(amount, std::memory_order_relaxed); }
+
+    uint64_t value(void)
+    {
+        uint64_t retVal = 0;
+
+        for (Shard &shard : _shards) {
+            retVal += shard.value.load(std::memory_order_relaxed);
+        }
+
+        return retVal;
+    }
+};
+
+//! point in time value, last writer wins
+class MetricGauge
+{
+protected:
+    std::atomic<int64_t> _value;
+
+public:
+    MetricGauge(void)
+        : _value(0){};
+
+    void set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+    void add(int64_t amount) { _value.fetch_add(amount, std::memory_order_relaxed); }
+    int64_t value(void) { return _value.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Named counters, gauges and latency summaries rendered in the
+ * Prometheus text exposition format
+ *
+ * - metrics are registered (by name and label set) once at setup and
+ *   updated through the returned reference, updates never lock
+ * - registering the same name and labels again returns the existing
+ *   metric, so plugins can look theirs up without keeping state
+ * - values that already live elsewhere (queue depths, drop counts) are
+ *   registered as functions and only read at scrape time
+ * - the registry lock is only taken by registration and scraping,
+ *   never by the event path - a scrape copies the series out under the
+ *   lock and reads the values (and calls the functions) after releasing
+ *   it, so a slow function never holds up registration
+ *
+ * Header only so the core and the plugins can share one registry, the
+ * core hands it to plugins through simplug_bind_metrics.
+ */
+class MetricsRegistry
+{
+protected:
+    typedef enum { METRIC_COUNTER = 0, METRIC_GAUGE, METRIC_SUMMARY } MetricType;
+
+    struct Series {
+        std::string labels;
+        std::unique_ptr<MetricCounter> counter;
+        std::unique_ptr<MetricGauge> gauge;
+        std::unique_ptr<HdrHistogram> ownedHistogram;
+        HdrHistogram *histogram;
+        double scale; ///< histogram values are multiplied by this when rendered
+        std::function<uint64_t(void)> counterFunction;
+        std::function<double(void)> function; ///< gauges
+    };
+
+    struct Family {
+        std::string help;
+        MetricType type;
+        std::vector<std::unique_ptr<Series>> series;
+    };
+
+    //! what a scrape reads of one series, copied out under the lock
+    struct Sample {
+        const std::string *name; ///< families and series are never removed
+        const Family *family;
+        const Series *series;
+        std::function<uint64_t(void)> counterFunction;
+        std::function<double(void)> function;
+        MetricCounter *counter;
+        MetricGauge *gauge;
+        HdrHistogram *histogram;
+        double scale;
+    };
+
+    std::mutex _registryMutex;
+    std::map<std::string, Family> _families;
+
+    //! returns the series of name with labels, creating family and series as needed - call with the lock held
+    Series &series(const std::string &name, const std::string &help, MetricType type, const std::string &labels)
+    {
+        Family &family = _families[name];
+
+        if (family.series.empty()) {
+            family.help = help;
+            family.type = type;
+        }
+
+        for (std::unique_ptr<Series> &series : family.series) {
+            if (series->labels == labels) {
+                return *series;
+            }
+        }
+
+        family.series.emplace_back(new Series());
+        family.series.back()->labels = labels;
+        family.series.back()->histogram = NULL;
+        family.series.back()->scale = 1.0;
+
+        return *family.series.back();
+    }
+
+    //! counts stay integers, however large - a rounded counter stops moving and its rate() reads 0
+    static std::string FormatValue(uint64_t value) { return std::to_string(value); }
+    static std::string FormatValue(int64_t value) { return std::to_string(value); }
+
+    //! enough digits to read back the same double
+    static std::string FormatValue(double value)
+    {
+        char buffer[32];
+
+        snprintf(buffer, sizeof(buffer), "%.17g", value);
+
+        return buffer;
+    }
+
+    template <typename T> static void RenderSample(std::ostringstream &out, const std::string &name, const std::string &labels, const std::string &extraLabel, T value)
+    {
+        out << name;
+
+        if (!labels.empty() || !extraLabel.empty()) {
+            out << "{" << labels << (!labels.empty() && !extraLabel.empty() ? "," : "") << extraLabel << "}";
+        }
+
+        out << " " << FormatValue(value) << "\n";
+    }
+
+public:
+    MetricsRegistry(void){};
+
+    MetricsRegistry(const MetricsRegistry &) = delete; // disable copying
+    MetricsRegistry &operator=(const MetricsRegistry &) = delete; // disable assignment
+
+    //! labels are in exposition form, e.g. plugin="pokey",code="PK_ERR_TRANSFER"
+    MetricCounter &counter(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        Series &retVal = series(name, help, METRIC_COUNTER, labels);
+
+        if (!retVal.counter) {
+            retVal.counter.reset(new MetricCounter());
+        }
+
+        return *retVal.counter;
+    }
+
+    MetricGauge &gauge(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        Series &retVal = series(name, help, METRIC_GAUGE, labels);
+
+        if (!retVal.gauge) {
+            retVal.gauge.reset(new MetricGauge());
+        }
+
+        return *retVal.gauge;
+    }
+
+    //! nanosecond histogram rendered as a summary in seconds
+    HdrHistogram &histogram(const std::string &name, const std::string &help, const std::string &labels = "")
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        Series &retVal = series(name, help, METRIC_SUMMARY, labels);
+
+        if (!retVal.histogram) {
+            retVal.ownedHistogram.reset(new HdrHistogram());
+            retVal.histogram = retVal.ownedHistogram.get();
+            retVal.scale = 1e-9;
+        }
+
+        return *retVal.histogram;
+    }
+
+    //! renders a histogram owned elsewhere (which must outlive the registry) as a summary
+    void summary(const std::string &name, const std::string &help, const std::string &labels, HdrHistogram *histogram, double scale)
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        Series &retVal = series(name, help, METRIC_SUMMARY, labels);
+
+        retVal.histogram = histogram;
+        retVal.scale = scale;
+    }
+
+    //! counter or gauge whose value is read by calling function at scrape time
+    void counterFunction(const std::string &name, const std::string &help, const std::string &labels, std::function<uint64_t(void)> function)
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        series(name, help, METRIC_COUNTER, labels).counterFunction = function;
+    }
+
+    void gaugeFunction(const std::string &name, const std::string &help, const std::string &labels, std::function<double(void)> function)
+    {
+        std::lock_guard<std::mutex> lock(_registryMutex);
+        series(name, help, METRIC_GAUGE, labels).function = function;
+    }
+
+    //! the whole registry in the Prometheus text exposition format (version 0.0.4)
+    std::string exposition(void)
+    {
+        static const char *typeNames[] = {"counter", "gauge", "summary"};
+        static const double quantiles[] = {0.5, 0.99, 0.999};
+
+        std::vector<Sample> samples;
+        std::ostringstream out;
+
+        {
+            std::lock_guard<std::mutex> lock(_registryMutex);
+
+            for (std::pair<const std::string, Family> &family : _families) {
+                for (std::unique_ptr<Series> &series : family.second.series) {
+                    samples.push_back(Sample{&family.first, &family.second, series.get(), series->counterFunction, series->function, series->counter.get(), series->gauge.get(),
+                        series->histogram, series->scale});
+                }
+            }
+        }
+
+        for (size_t i = 0; i < samples.size(); i++) {
+            Sample &sample = samples[i];
+            const std::string &name = *sample.name;
+            const std::string &labels = sample.series->labels;
+
+            if (i == 0 || samples[i - 1].family != sample.family) {
+                out << "# HELP " << name << " " << sample.family->help << "\n";
+                out << "# TYPE " << name << " " << typeNames[sample.family->type] << "\n";
+            }
+
+            if (sample.counterFunction) {
+                RenderSample(out, name, labels, "", sample.counterFunction());
+            }
+            else if (sample.function) {
+                RenderSample(out, name, labels, "", sample.function());
+            }
+            else if (sample.counter) {
+                RenderSample(out, name, labels, "", sample.counter->value());
+            }
+            else if (sample.gauge) {
+                RenderSample(out, name, labels, "", sample.gauge->value());
+            }
+            else if (sample.histogram) {
+                for (double quantile : quantiles) {
+                    std::ostringstream quantileLabel;
+                    quantileLabel << "quantile=\"" << quantile << "\"";
+                    RenderSample(out, name, labels, quantileLabel.str(), sample.histogram->percentile(quantile * 100.0) * sample.scale);
+                }
+
+                RenderSample(out, name + "_sum", labels, "", (double)sample.histogram->sum() * sample.scale);
+                RenderSample(out, name + "_count", labels, "", sample.histogram->count());
+            }
+        }
+
+        return out.str();
+    }
+};
+
+#endif
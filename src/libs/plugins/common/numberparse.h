@@ -0,0 +1,158 @@
+#ifndef __NUMBERPARSE_H
+#define __NUMBERPARSE_H
+
+#include <cmath>
+#include <limits>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * strict, locale independent number parsing for wire protocols - the
+ * whole text has to be the number (no blanks, no trailing garbage),
+ * anything else is rejected rather than read as 0 the way atoi/atof
+ * would
+ */
+
+//! optional sign followed by decimal digits, rejects values that do not fit an int64_t
+inline bool ParseInt(const char *text, size_t length, int64_t &value)
+{
+    const char *end = text + length;
+    bool negative = false;
+    uint64_t magnitude = 0;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        negative = *text == '-';
+        text++;
+    }
+
+    if (text == end) {
+        return false;
+    }
+
+    for (; text < end; text++) {
+        unsigned int digit = (unsigned char)*text - '0';
+
+        if (digit > 9 || magnitude > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+
+        magnitude = magnitude * 10 + digit;
+    }
+
+    if (magnitude > (uint64_t)INT64_MAX + (negative ? 1 : 0)) {
+        return false;
+    }
+
+    value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+
+    return true;
+}
+
+/**
+ * [sign] digits [. digits] [e|E [sign] digits], at least one digit
+ * before the exponent - exact for up to 15 significant digits and
+ * exponents within +/-22, which covers everything a simulator sends,
+ * longer values are within an ulp or two
+ */
+inline bool ParseFloat(const char *text, size_t length, double &value)
+{
+    static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    const char *end = text + length;
+    bool negative = false;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int significant = 0;
+    int exponent = 0;
+
+    if (text < end && (*text == '-' || *text == '+')) {
+        negative = *text == '-';
+        text++;
+    }
+
+    for (; text < end && (unsigned char)(*text - '0') <= 9; text++, digits++) {
+        if (significant < 19) {
+            mantissa = mantissa * 10 + (*text - '0');
+            significant += mantissa > 0;
+        }
+        else {
+            exponent++;
+        }
+    }
+
+    if (text < end && *text == '.') {
+        for (text++; text < end && (unsigned char)(*text - '0') <= 9; text++, digits++) {
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*text - '0');
+                significant += mantissa > 0;
+                exponent--;
+            }
+        }
+    }
+
+    if (digits == 0) {
+        return false;
+    }
+
+    if (text < end && (*text == 'e' || *text == 'E')) {
+        int64_t explicitExponent;
+
+        text++;
+
+        if (!ParseInt(text, end - text, explicitExponent) || explicitExponent > 400 || explicitExponent < -400) {
+            return false;
+        }
+
+        exponent += (int)explicitExponent;
+        text = end;
+    }
+
+    if (text != end) {
+        return false;
+    }
+
+    double retVal = (double)mantissa;
+
+    if (exponent >= 0 && exponent <= 22) {
+        retVal *= powers[exponent];
+    }
+    else if (exponent < 0 && exponent >= -22) {
+        retVal /= powers[-exponent];
+    }
+    else if (mantissa != 0) {
+        retVal *= std::pow(10.0, exponent);
+    }
+
+    if (std::isinf(retVal)) {
+        return false;
+    }
+
+    value = negative ? -retVal : retVal;
+
+    return true;
+}
+
+//! 0/1 (any integer, non zero is true) or true/false
+inline bool ParseBool(const char *text, size_t length, bool &value)
+{
+    int64_t number;
+
+    if (ParseInt(text, length, number)) {
+        value = number != 0;
+        return true;
+    }
+
+    if (length == 4 && (text[0] | 0x20) == 't' && (text[1] | 0x20) == 'r' && (text[2] | 0x20) == 'u' && (text[3] | 0x20) == 'e') {
+        value = true;
+        return true;
+    }
+
+    if (length == 5 && (text[0] | 0x20) == 'f' && (text[1] | 0x20) == 'a' && (text[2] | 0x20) == 'l' && (text[3] | 0x20) == 's' && (text[4] | 0x20) == 'e') {
+        value = false;
+        return true;
+    }
+
+    return false;
+}
+
+#endif
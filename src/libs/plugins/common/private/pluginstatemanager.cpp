@@ -1,11 +1,17 @@
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <unistd.h>
 
+#include "common/numberparse.h"
 #include "pluginstatemanager.h"
 
 PluginStateManager::PluginStateManager(LoggingFunctionCB logger)
     : _enqueueCallback(NULL)
     , _logger(logger)
+    , _symbols(NULL)
+    , _latency(NULL)
+    , _metrics(NULL)
     , _pluginThread(NULL)
 {
 }
@@ -14,6 +20,24 @@ PluginStateManager::~PluginStateManager(void)
 {
 }
 
+int PluginStateManager::bindSymbolTable(SymbolTable *symbols)
+{
+    _symbols = symbols;
+    return 0;
+}
+
+int PluginStateManager::bindLatencyTracer(LatencyTracer *latency)
+{
+    _latency = latency;
+    return 0;
+}
+
+int PluginStateManager::bindMetrics(MetricsRegistry *metrics)
+{
+    _metrics = metrics;
+    return 0;
+}
+
 //! just queue up a copy of the device settings for use in preflightComplete
 int PluginStateManager::configPassthrough(libconfig::Config *pluginConfiguration)
 {
@@ -31,6 +55,26 @@ int PluginStateManager::deliverValue(GenericTLV *value)
     return 0;
 }
 
+//! default batch delivery - plugins that can do better per batch override this
+int PluginStateManager::deliverValues(GenericTLV **values, int count)
+{
+    int retVal = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (deliverValue(values[i]) != 0) {
+            retVal = -1;
+        }
+    }
+
+    return retVal;
+}
+
+//! default has no declared targets - plugins that route by name override this
+int PluginStateManager::enumerateTargets(EnumerateTargetHandler targetCallback, void *arg)
+{
+    return 0;
+}
+
 void PluginStateManager::commenceEventing(EnqueueEventHandler enqueueCallback, void *arg)
 {
     _logger(LOG_INFO, "<PluginManager> Commence eventing");
@@ -43,13 +87,112 @@ void PluginStateManager::ceaseEventing(void)
     _logger(LOG_INFO, "<PluginManager> Cease eventing");
 }
 
-std::string PluginStateManager::transformBoolToString(std::string orginalValue, std::string transformResultOff, std::string transformResultOn)
+//! numeric setting of any width, libconfig does not convert between them on its own
+static bool SettingNumber(const libconfig::Setting &group, const char *name, double &value)
+{
+    if (!group.exists(name)) {
+        return false;
+    }
+
+    const libconfig::Setting &setting = group[name];
+
+    switch (setting.getType()) {
+    case libconfig::Setting::TypeInt:
+        value = (int)setting;
+        return true;
+    case libconfig::Setting::TypeInt64:
+        value = (double)(long long)setting;
+        return true;
+    case libconfig::Setting::TypeFloat:
+        value = (double)setting;
+        return true;
+    default:
+        return false;
+    }
+}
+
+//! steps in a fixed order: invert, scale and offset, clamp, then a label step
+static bool TransformStepsFromGroup(const libconfig::Setting &group, TransformChain &chain)
+{
+    bool invert = false;
+    double factor = 1;
+    double offset = 0;
+    double minimum = -std::numeric_limits<double>::infinity();
+    double maximum = std::numeric_limits<double>::infinity();
+    bool scaled = SettingNumber(group, "scale", factor);
+    bool clamped = false;
+
+    if (group.lookupValue("invert", invert) && invert) {
+        chain.invert();
+    }
+
+    scaled = SettingNumber(group, "offset", offset) || scaled;
+
+    if (scaled) {
+        chain.scale(factor, offset);
+    }
+
+    clamped = SettingNumber(group, "min", minimum);
+    clamped = SettingNumber(group, "max", maximum) || clamped;
+
+    if (clamped) {
+        chain.clamp(minimum, maximum);
+    }
+
+    if (group.exists("labels")) {
+        // label names use '_' for blanks like the switch matrix valueTransforms
+        for (const libconfig::Setting &label : group["labels"]) {
+            std::string text = label.getName();
+
+            std::replace(text.begin(), text.end(), '_', ' ');
+            chain.label((int)label, text);
+        }
+    }
+    else if (group.exists("On") && group.exists("Off")) {
+        std::string on;
+        std::string off;
+
+        group.lookupValue("On", on);
+        group.lookupValue("Off", off);
+        chain.boolLabels(off, on);
+    }
+
+    return !chain.empty();
+}
+
+bool PluginStateManager::TransformChainFromSetting(const libconfig::Setting &transform, TransformChain &chain)
 {
-    if (orginalValue == "0") {
-        return transformResultOff;
+    if (transform.isGroup()) {
+        return TransformStepsFromGroup(transform, chain);
     }
-    else if (orginalValue == "1") {
-        return transformResultOn;
+
+    if (transform.isList()) {
+        for (const libconfig::Setting &step : transform) {
+            if (step.isGroup()) {
+                TransformStepsFromGroup(step, chain);
+            }
+        }
+    }
+
+    return !chain.empty();
+}
+
+bool PluginStateManager::GenericNumber(GenericTLV *value, double &number)
+{
+    switch (value->type) {
+    case CONFIG_FLOAT:
+        number = value->value.float_value;
+        return true;
+    case CONFIG_UINT:
+        number = (uint32_t)value->value.int_value;
+        return true;
+    case CONFIG_BOOL:
+        number = value->value.bool_value ? 1 : 0;
+        return true;
+    case CONFIG_STRING:
+        return value->value.string_value && ParseFloat(value->value.string_value, strlen(value->value.string_value), number);
+    default:
+        number = value->value.int_value;
+        return true;
     }
-    return orginalValue;
 }
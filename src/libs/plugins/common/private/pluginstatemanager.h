@@ -5,7 +5,11 @@
 #include <list>
 #include <thread>
 
+#include "common/latencytracer.h"
+#include "common/metrics.h"
 #include "common/simhubdeviceplugin.h"
+#include "common/symboltable.h"
+#include "common/transformengine.h"
 
 #define PREFLIGHT_OK 0
 #define PREFLIGHT_FAIL 1
@@ -31,6 +35,15 @@ protected:
     void *_callbackArg;
     LoggingFunctionCB _logger;
 
+    //! core owned element name table, NULL if the host did not bind one
+    SymbolTable *_symbols;
+    //! core owned latency histograms, NULL if the host did not bind them
+    LatencyTracer *_latency;
+    //! core owned metrics, NULL if the host did not bind them
+    MetricsRegistry *_metrics;
+    //! stands in for the core's registry when it is not bound, never scraped
+    MetricsRegistry _localMetrics;
+
     //! config for use in preflightComplete
     libconfig::Config *_config;
     std::shared_ptr<std::thread> _pluginThread;
@@ -40,15 +53,39 @@ public:
     PluginStateManager(LoggingFunctionCB logger);
     virtual ~PluginStateManager(void);
 
+    virtual int bindSymbolTable(SymbolTable *symbols);
+    virtual int bindLatencyTracer(LatencyTracer *latency);
+    virtual int bindMetrics(MetricsRegistry *metrics);
     virtual int configPassthrough(libconfig::Config *pluginConfiguration);
     virtual int preflightComplete(void);
     virtual void commenceEventing(EnqueueEventHandler enqueueCallback, void *arg);
     virtual int deliverValue(GenericTLV *value);
+    virtual int deliverValues(GenericTLV **values, int count);
+    virtual int enumerateTargets(EnumerateTargetHandler targetCallback, void *arg);
     virtual void ceaseEventing(void);
     virtual std::string name() { return _name; }
 
-    // transformations
-    virtual std::string transformBoolToString(std::string orginalValue, std::string transformResultOff, std::string transformResultOn);
+    SymbolTable *symbolTable(void) { return _symbols; }
+    //! interns name if a symbol table is bound, SYMBOL_UNRESOLVED otherwise
+    SymbolId symbolFor(const std::string &name) { return _symbols ? _symbols->intern(name) : SYMBOL_UNRESOLVED; }
+    //! registry to register the plugin's metrics with - always valid
+    MetricsRegistry &metrics(void) { return _metrics ? *_metrics : _localMetrics; }
+    //! records stage for a value that entered simhub at ingestTime, if a tracer is bound
+    void traceLatency(LatencyStage stage, int64_t ingestTime)
+    {
+        if (_latency) {
+            _latency->record(stage, ingestTime);
+        }
+    }
+
+    /**
+     * builds the transform chain a configuration transform block
+     * describes - a group ({ On = "..", Off = ".." }, scale, offset, min,
+     * max, invert, labels) or a list of groups applied in order
+     */
+    static bool TransformChainFromSetting(const libconfig::Setting &transform, TransformChain &chain);
+    //! the value a transform runs on - false for strings that are not numbers
+    static bool GenericNumber(GenericTLV *value, double &number);
 };
 
 #endif
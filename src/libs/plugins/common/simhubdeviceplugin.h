@@ -2,9 +2,13 @@
 #define __SIMSOURCE_H
 
 #include <dlfcn.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <memory.h>
 #include <assert.h>
+
+#include "pool/block_pool.h"
+
 #if defined(build_macosx)
 #define LIB_EXT ".dylib"
 #endif
@@ -23,6 +27,9 @@ typedef void (*EnqueueEventHandler)(SPHANDLE eventSource, void *event, void *arg
 
 typedef void (*LoggingFunctionCB)(const int category, const char *msg, ...);
 
+//! called once per deliverable element name, handle is opaque to the caller and handed back on delivery
+typedef void (*EnumerateTargetHandler)(void *arg, const char *name, void *handle);
+
 typedef enum { CONFIG_INT = 0, CONFIG_STRING, CONFIG_FLOAT, CONFIG_BOOL, CONFIG_UINT } ConfigType;
 
 typedef union {
@@ -43,8 +50,28 @@ typedef struct {
     char *description;
     char *units;
     SPHANDLE ownerPlugin;
+    uint32_t symbol; ///< interned id of name, 0 if not (yet) interned
+    uint32_t pooled; ///< non zero if allocated by make_generic from the block pool
+    void *targetHandle; ///< on delivery: the handle the plugin declared for name, NULL if none
+    int64_t ingestTime; ///< monotonic_nanos() when the value entered simhub, 0 if not traced
 } GenericTLV;
 
+#define GENERIC_POOLED_MAGIC 0x504f4f4c
+#define GENERIC_ARENA_SIZE 96
+
+/**
+ * pooled allocation unit behind make_generic - the generic is followed
+ * by a small arena that holds its string payloads (name, description,
+ * units and string values) so that a typical event costs one pooled
+ * block and no mallocs at all. Strings that do not fit in the arena
+ * fall back to calloc()
+ */
+typedef struct {
+    GenericTLV generic;
+    size_t arenaUsed;
+    char arena[GENERIC_ARENA_SIZE];
+} GenericTLVBlock;
+
 // -- begin GenericTLV helper methods
 
 inline void dupe_string(char **dest, const char *source)
@@ -56,21 +83,72 @@ inline void dupe_string(char **dest, const char *source)
     strncpy(*dest, source, string_size + 1);
 }
 
+inline BlockPool<sizeof(GenericTLVBlock)> &generic_pool(void)
+{
+    return BlockPool<sizeof(GenericTLVBlock)>::Instance();
+}
+
+//! true if string lives in the arena of a pooled generic rather than on the heap
+inline bool generic_owns_string(GenericTLV *generic, const char *string)
+{
+    if (generic->pooled != GENERIC_POOLED_MAGIC || !string) {
+        return false;
+    }
+
+    GenericTLVBlock *block = (GenericTLVBlock *)generic;
+    return string >= block->arena && string < block->arena + GENERIC_ARENA_SIZE;
+}
+
+/**
+ * sets one of the string members of generic (name, description, units
+ * or value.string_value) to a copy of source - replacing whatever the
+ * member held before. Use this rather than dupe_string on generics
+ * returned by make_generic
+ */
+inline void generic_set_string(GenericTLV *generic, char **field, const char *source)
+{
+    assert(generic);
+    assert(source);
+
+    if (*field && !generic_owns_string(generic, *field)) {
+        free(*field);
+    }
+
+    size_t string_size = strlen(source) + 1;
+
+    if (generic->pooled == GENERIC_POOLED_MAGIC) {
+        GenericTLVBlock *block = (GenericTLVBlock *)generic;
+
+        if (block->arenaUsed + string_size <= GENERIC_ARENA_SIZE) {
+            *field = block->arena + block->arenaUsed;
+            block->arenaUsed += string_size;
+            memcpy(*field, source, string_size);
+            return;
+        }
+    }
+
+    *field = (char *)calloc(string_size, 1);
+    memcpy(*field, source, string_size);
+}
+
 inline GenericTLV *make_generic(const char *name, const char *description) 
 { 
-    GenericTLV *retVal = (GenericTLV *)calloc(sizeof(GenericTLV), 1); 
-
     assert(name);
     assert(strlen(name) > 0);
     assert(description);
     assert(strlen(description) > 0);
-    
-    retVal->name = NULL;
-    retVal->description = NULL;
+
+    GenericTLVBlock *block = (GenericTLVBlock *)generic_pool().allocate();
+    GenericTLV *retVal = &block->generic;
+
+    memset(retVal, 0, sizeof(GenericTLV));
+    block->arenaUsed = 0;
+
+    retVal->pooled = GENERIC_POOLED_MAGIC;
     retVal->type = CONFIG_INT;
-   
-    dupe_string(&(retVal->name), name);
-    dupe_string(&(retVal->description), description);
+
+    generic_set_string(retVal, &(retVal->name), name);
+    generic_set_string(retVal, &(retVal->description), description);
 
     return retVal;
 }
@@ -82,7 +160,7 @@ inline GenericTLV *make_string_generic(const char *name, const char *description
     
     GenericTLV *retVal = make_generic(name, description);
     retVal->type = CONFIG_STRING;
-    dupe_string(&(retVal->value.string_value), string_value);
+    generic_set_string(retVal, &(retVal->value.string_value), string_value);
     
     return retVal;
 }
@@ -91,24 +169,33 @@ inline void release_generic(GenericTLV *generic)
 {
     assert(generic);
 
-    if (generic->name) {
+    if (generic->name && !generic_owns_string(generic, generic->name)) {
         free(generic->name);
     }
 
-    if (generic->description) {
+    if (generic->description && !generic_owns_string(generic, generic->description)) {
         free(generic->description);
     }
 
     if (generic->type == CONFIG_STRING) {
         assert(generic->value.string_value);
-        free(generic->value.string_value);
+
+        if (!generic_owns_string(generic, generic->value.string_value)) {
+            free(generic->value.string_value);
+        }
     }
 
-    if (generic->units) {
+    if (generic->units && !generic_owns_string(generic, generic->units)) {
         free(generic->units);
     }
 
-    free(generic);
+    if (generic->pooled == GENERIC_POOLED_MAGIC) {
+        generic->pooled = 0;
+        generic_pool().release(generic);
+    }
+    else {
+        free(generic);
+    }
 }
 
 // -- end GenericTLV helper methods
@@ -118,6 +205,25 @@ typedef struct {
     //! inits the state manager handle
     int (*simplug_init)(SPHANDLE *plugin_instance, LoggingFunctionCB logger);
 
+    /**
+     * optional - hands the plugin the core's element name symbol table
+     * (a SymbolTable *) before configuration so that it can tag the
+     * events it generates and index its own lookups by symbol
+     */
+    int (*simplug_bind_symbol_table)(SPHANDLE plugin_instance, void *symbol_table);
+
+    /**
+     * optional - hands the plugin the core's LatencyTracer so that it can
+     * record when it read, parsed and finished delivering values
+     */
+    int (*simplug_bind_latency_tracer)(SPHANDLE plugin_instance, void *latency_tracer);
+
+    /**
+     * optional - hands the plugin the core's MetricsRegistry so that its
+     * counters are served on /metrics along with the core's own
+     */
+    int (*simplug_bind_metrics)(SPHANDLE plugin_instance, void *metrics);
+
     //! pass through kludge until we split out config files
     int (*simplug_config_passthrough)(SPHANDLE plugin_instance, void *libconfig_instance);
 
@@ -138,6 +244,20 @@ typedef struct {
      */
     int (*simplug_deliver_value)(SPHANDLE plugin_instance, GenericTLV *value);
 
+    /**
+     * optional batch form of simplug_deliver_value - delivers count values
+     * in one call, returns non-zero if any of the deliveries failed
+     */
+    int (*simplug_deliver_values)(SPHANDLE plugin_instance, GenericTLV **values, int count);
+
+    /**
+     * optional - reports every element name the plugin can be delivered
+     * (calling target_callback once per name) so that the core can route
+     * straight to it. Plugins that do not implement this are delivered
+     * every element they did not generate themselves
+     */
+    int (*simplug_enumerate_targets)(SPHANDLE plugin_instance, EnumerateTargetHandler target_callback, void *arg);
+
     //! tell the manager to tear down the event loop
     void (*simplug_cease_eventing)(SPHANDLE plugin_instance);
 
@@ -170,6 +290,15 @@ inline int simplug_bootstrap(const char *plugin_path, simplug_vtable *plugin_vta
     if (!plugin_vtable->simplug_init)
         return -1;
 
+    plugin_vtable->simplug_bind_symbol_table = (int (*)(SPHANDLE, void *))dlsym(handle, "simplug_bind_symbol_table");
+    // NOTE: plugins can optionally implement the bind_symbol_table function
+
+    plugin_vtable->simplug_bind_latency_tracer = (int (*)(SPHANDLE, void *))dlsym(handle, "simplug_bind_latency_tracer");
+    // NOTE: as well as the bind_latency_tracer function
+
+    plugin_vtable->simplug_bind_metrics = (int (*)(SPHANDLE, void *))dlsym(handle, "simplug_bind_metrics");
+    // NOTE: and the bind_metrics function
+
     plugin_vtable->simplug_config_passthrough = (int (*)(SPHANDLE, void *))dlsym(handle, "simplug_config_passthrough");
     if (!plugin_vtable->simplug_config_passthrough)
         return -1;
@@ -185,6 +314,12 @@ inline int simplug_bootstrap(const char *plugin_path, simplug_vtable *plugin_vta
     plugin_vtable->simplug_deliver_value = (int (*)(SPHANDLE, GenericTLV *))dlsym(handle, "simplug_deliver_value");
     // NOTE: at this point plugins can optionally implement the deliver_value function
 
+    plugin_vtable->simplug_deliver_values = (int (*)(SPHANDLE, GenericTLV **, int))dlsym(handle, "simplug_deliver_values");
+    // NOTE: deliver_values is optional too, callers fall back to deliver_value
+
+    plugin_vtable->simplug_enumerate_targets = (int (*)(SPHANDLE, EnumerateTargetHandler, void *))dlsym(handle, "simplug_enumerate_targets");
+    // NOTE: plugins that don't enumerate their targets accept any element
+
     plugin_vtable->simplug_cease_eventing = (void (*)(SPHANDLE))dlsym(handle, "simplug_cease_eventing");
     if (!plugin_vtable->simplug_cease_eventing)
         return -1;
@@ -0,0 +1,159 @@
+#ifndef __SYMBOLTABLE_H
+#define __SYMBOLTABLE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//! dense integer identifier of an element name
+typedef uint32_t SymbolId;
+
+//! never handed out - marks a name that has not been interned (yet)
+#define SYMBOL_UNRESOLVED 0
+
+#define SYMBOL_CHUNK_BITS 10
+#define SYMBOL_CHUNK_SIZE (1 << SYMBOL_CHUNK_BITS)
+#define SYMBOL_CHUNK_MASK (SYMBOL_CHUNK_SIZE - 1)
+#define SYMBOL_MAX_CHUNKS 1024
+
+/**
+ * Process-wide table of element names
+ *
+ * - every element name is assigned a dense SymbolId the first time it
+ *   is interned, ids are never reused so they can index flat arrays
+ * - names live in fixed size chunks that never move, so name() is
+ *   lock free for any id that has been handed out
+ * - interning takes a shared lock for the lookup and only takes the
+ *   exclusive lock for names seen for the first time
+ *
+ * The table is owned by the core and handed to plugins through the
+ * simplug_bind_symbol_table entry point - this is a header only class
+ * so both sides of the plugin boundary can use the same instance.
+ */
+class SymbolTable
+{
+protected:
+    std::shared_timed_mutex _internMutex;
+    std::unordered_map<std::string, SymbolId> _ids;
+    std::unique_ptr<std::string[]> _chunks[SYMBOL_MAX_CHUNKS];
+    std::atomic<SymbolId> _nextSymbol;
+
+public:
+    SymbolTable(void)
+        : _nextSymbol(SYMBOL_UNRESOLVED + 1)
+    {
+        _chunks[0].reset(new std::string[SYMBOL_CHUNK_SIZE]);
+    };
+
+    SymbolTable(const SymbolTable &) = delete; // disable copying
+    SymbolTable &operator=(const SymbolTable &) = delete; // disable assignment
+
+    //! returns the id of name or SYMBOL_UNRESOLVED if it has never been interned
+    SymbolId find(const std::string &name)
+    {
+        std::shared_lock<std::shared_timed_mutex> lock(_internMutex);
+        std::unordered_map<std::string, SymbolId>::iterator it = _ids.find(name);
+
+        return it != _ids.end() ? it->second : SYMBOL_UNRESOLVED;
+    }
+
+    //! returns the id of name, assigning the next free id on first sight
+    SymbolId intern(const std::string &name)
+    {
+        SymbolId retVal = find(name);
+
+        if (retVal != SYMBOL_UNRESOLVED || name.empty()) {
+            return retVal;
+        }
+
+        std::unique_lock<std::shared_timed_mutex> lock(_internMutex);
+        std::unordered_map<std::string, SymbolId>::iterator it = _ids.find(name);
+
+        if (it != _ids.end()) {
+            return it->second;
+        }
+
+        retVal = _nextSymbol.load(std::memory_order_relaxed);
+
+        if ((retVal >> SYMBOL_CHUNK_BITS) >= SYMBOL_MAX_CHUNKS) {
+            // table is full - callers fall back to name based lookups
+            return SYMBOL_UNRESOLVED;
+        }
+
+        std::unique_ptr<std::string[]> &chunk = _chunks[retVal >> SYMBOL_CHUNK_BITS];
+
+        if (!chunk) {
+            chunk.reset(new std::string[SYMBOL_CHUNK_SIZE]);
+        }
+
+        chunk[retVal & SYMBOL_CHUNK_MASK] = name;
+        _ids.emplace(name, retVal);
+
+        // publish the name before the id becomes visible to name()
+        _nextSymbol.store(retVal + 1, std::memory_order_release);
+
+        return retVal;
+    }
+
+    SymbolId intern(const char *name) { return name ? intern(std::string(name)) : SYMBOL_UNRESOLVED; }
+
+    //! returns the name of symbol, empty for unresolved or unknown ids
+    const std::string &name(SymbolId symbol)
+    {
+        static const std::string unresolved;
+
+        if (symbol == SYMBOL_UNRESOLVED || symbol >= _nextSymbol.load(std::memory_order_acquire)) {
+            return unresolved;
+        }
+
+        return _chunks[symbol >> SYMBOL_CHUNK_BITS][symbol & SYMBOL_CHUNK_MASK];
+    }
+
+    //! one past the highest id handed out so far
+    SymbolId bound(void) { return _nextSymbol.load(std::memory_order_acquire); }
+};
+
+/**
+ * Flat SymbolId to value lookup used in place of string keyed maps on
+ * the hot path - filled in at configuration time, read only afterwards
+ */
+template <typename T> class SymbolIndex
+{
+protected:
+    struct Slot {
+        T value;
+        bool present;
+    };
+
+    std::vector<Slot> _slots;
+
+public:
+    void set(SymbolId symbol, const T &value)
+    {
+        if (symbol == SYMBOL_UNRESOLVED) {
+            return;
+        }
+
+        if (symbol >= _slots.size()) {
+            _slots.resize(symbol + 1, Slot{T(), false});
+        }
+
+        _slots[symbol].value = value;
+        _slots[symbol].present = true;
+    }
+
+    bool contains(SymbolId symbol) const { return symbol < _slots.size() && _slots[symbol].present; }
+
+    //! returns NULL if there is no value for symbol
+    T *find(SymbolId symbol) { return contains(symbol) ? &_slots[symbol].value : NULL; }
+    const T *find(SymbolId symbol) const { return contains(symbol) ? &_slots[symbol].value : NULL; }
+
+    void clear(void) { _slots.clear(); }
+};
+
+#endif
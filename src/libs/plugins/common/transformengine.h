@@ -0,0 +1,301 @@
+#ifndef __TRANSFORMENGINE_H
+#define __TRANSFORMENGINE_H
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "symboltable.h"
+
+//! no transform compiled for an element
+#define TRANSFORM_NONE UINT32_MAX
+
+typedef uint32_t TransformId;
+
+typedef enum {
+    TRANSFORM_BOOL_LABEL = 0, ///< 0 and 1 become the Off / On label, anything else passes through
+    TRANSFORM_SCALE, ///< value * factor + offset
+    TRANSFORM_CLAMP, ///< limits value to [min, max]
+    TRANSFORM_INVERT, ///< 0 becomes 1, anything else 0
+    TRANSFORM_LABEL_MAP ///< exact integer value to label, anything else has no label
+} TransformOpCode;
+
+/**
+ * One step of a transform as written in the configuration - steps
+ * are applied in order, a label step ends the chain
+ */
+struct TransformStep {
+    TransformOpCode code;
+    double first; ///< scale factor, clamp minimum
+    double second; ///< scale offset, clamp maximum
+    std::vector<std::pair<int64_t, std::string>> labels; ///< off/on for a bool label, value/label pairs for a map
+};
+
+//! builds the step list for one element
+class TransformChain
+{
+protected:
+    std::vector<TransformStep> _steps;
+
+    TransformChain &add(TransformOpCode code, double first = 0, double second = 0)
+    {
+        _steps.push_back(TransformStep{code, first, second, {}});
+        return *this;
+    }
+
+public:
+    TransformChain &boolLabels(const std::string &off, const std::string &on)
+    {
+        add(TRANSFORM_BOOL_LABEL);
+        _steps.back().labels = {{0, off}, {1, on}};
+        return *this;
+    }
+
+    TransformChain &scale(double factor, double offset = 0) { return add(TRANSFORM_SCALE, factor, offset); }
+    TransformChain &clamp(double minimum, double maximum) { return add(TRANSFORM_CLAMP, std::min(minimum, maximum), std::max(minimum, maximum)); }
+    TransformChain &invert(void) { return add(TRANSFORM_INVERT); }
+
+    TransformChain &label(int64_t value, const std::string &text)
+    {
+        if (_steps.empty() || _steps.back().code != TRANSFORM_LABEL_MAP) {
+            add(TRANSFORM_LABEL_MAP);
+        }
+
+        _steps.back().labels.push_back(std::make_pair(value, text));
+        return *this;
+    }
+
+    TransformChain &labels(const std::map<int, std::string> &labels)
+    {
+        for (const std::pair<const int, std::string> &entry : labels) {
+            label(entry.first, entry.second);
+        }
+
+        return *this;
+    }
+
+    const std::vector<TransformStep> &steps(void) const { return _steps; };
+    bool empty(void) const { return _steps.empty(); };
+};
+
+//! outcome of running a transform - label is NULL when the value stays numeric
+struct TransformResult {
+    double number;
+    const char *label;
+    size_t labelLength;
+};
+
+/**
+ * Transforms compiled into a flat table of typed operations
+ *
+ * - every element's chain is a contiguous run of ops, found by symbol
+ *   (or by name for unresolved elements) once per value
+ * - ops work on the numeric value, labels are stored once, '\0'
+ *   terminated, in a single text block so results point into it
+ * - apply() neither allocates nor copies strings
+ * - add() is configuration time only, the engine is read only once
+ *   the plugin is eventing
+ */
+class TransformEngine
+{
+protected:
+    struct Op {
+        TransformOpCode code;
+        double first;
+        double second;
+        uint32_t labels; ///< first entry in _labelEntries
+        uint32_t labelCount;
+    };
+
+    struct LabelEntry {
+        int64_t value;
+        uint32_t offset; ///< into _labelText
+        uint32_t length;
+    };
+
+    struct Program {
+        uint32_t first; ///< first op in _ops
+        uint32_t count;
+    };
+
+    std::vector<Op> _ops;
+    std::vector<LabelEntry> _labelEntries; ///< sorted by value per op
+    std::string _labelText;
+    std::vector<Program> _programs;
+    std::map<std::string, TransformId> _byName;
+    SymbolIndex<TransformId> _bySymbol;
+    size_t _unresolved; ///< transforms added without a symbol, only these need the name lookup
+
+    bool resolve(const LabelEntry &entry, TransformResult &result) const
+    {
+        result.label = _labelText.data() + entry.offset;
+        result.labelLength = entry.length;
+        return true;
+    }
+
+    //! binary search of a label map op, false if value has no label
+    bool lookup(const Op &op, double value, TransformResult &result) const
+    {
+        // the cast is undefined for NaN, infinities and anything outside int64_t - [-2^63, 2^63) are exact doubles
+        if (!std::isfinite(value) || value < (double)INT64_MIN || value >= -(double)INT64_MIN) {
+            return false;
+        }
+
+        int64_t key = (int64_t)value;
+
+        if ((double)key != value) {
+            return false;
+        }
+
+        const LabelEntry *begin = _labelEntries.data() + op.labels;
+        const LabelEntry *end = begin + op.labelCount;
+        const LabelEntry *found = std::lower_bound(begin, end, key, [](const LabelEntry &entry, int64_t key) { return entry.value < key; });
+
+        return found != end && found->value == key && resolve(*found, result);
+    }
+
+public:
+    TransformEngine(void)
+        : _unresolved(0){};
+
+    /**
+     * compiles chain for the element name, the first chain added for a
+     * name wins - returns its id, TRANSFORM_NONE for an empty chain
+     */
+    TransformId add(const std::string &name, SymbolId symbol, const TransformChain &chain)
+    {
+        std::map<std::string, TransformId>::iterator existing = _byName.find(name);
+
+        if (existing != _byName.end()) {
+            return existing->second;
+        }
+
+        TransformId retVal = compile(chain);
+
+        if (retVal != TRANSFORM_NONE) {
+            _byName[name] = retVal;
+            _bySymbol.set(symbol, retVal);
+            _unresolved += symbol == SYMBOL_UNRESOLVED;
+        }
+
+        return retVal;
+    }
+
+    //! compiles chain without naming it, for owners that hold on to the id
+    TransformId compile(const TransformChain &chain)
+    {
+        if (chain.empty()) {
+            return TRANSFORM_NONE;
+        }
+
+        Program program = {(uint32_t)_ops.size(), 0};
+
+        for (const TransformStep &step : chain.steps()) {
+            Op op = {step.code, step.first, step.second, (uint32_t)_labelEntries.size(), (uint32_t)step.labels.size()};
+
+            for (const std::pair<int64_t, std::string> &label : step.labels) {
+                _labelEntries.push_back(LabelEntry{label.first, (uint32_t)_labelText.size(), (uint32_t)label.second.size()});
+                _labelText.append(label.second);
+                _labelText += '\0';
+            }
+
+            std::stable_sort(_labelEntries.begin() + op.labels, _labelEntries.end(), [](const LabelEntry &a, const LabelEntry &b) { return a.value < b.value; });
+
+            _ops.push_back(op);
+            program.count++;
+
+            // nothing runs after a label
+            if (step.code == TRANSFORM_BOOL_LABEL || step.code == TRANSFORM_LABEL_MAP) {
+                break;
+            }
+        }
+
+        _programs.push_back(program);
+
+        return (TransformId)(_programs.size() - 1);
+    }
+
+    //! TRANSFORM_NONE if the element has no transform, name is only looked at when symbol does not decide it
+    TransformId find(const char *name, SymbolId symbol) const
+    {
+        if (_programs.empty()) {
+            return TRANSFORM_NONE;
+        }
+
+        if (symbol != SYMBOL_UNRESOLVED) {
+            const TransformId *id = _bySymbol.find(symbol);
+
+            if (id) {
+                return *id;
+            }
+
+            if (!_unresolved) {
+                return TRANSFORM_NONE;
+            }
+        }
+
+        std::map<std::string, TransformId>::const_iterator it = _byName.find(name);
+
+        return it != _byName.end() ? it->second : TRANSFORM_NONE;
+    }
+
+    TransformId find(const std::string &name, SymbolId symbol) const { return find(name.c_str(), symbol); }
+
+    /**
+     * runs the transform on value - result.label is set when a label op
+     * matched, otherwise result.number holds the transformed value
+     */
+    void apply(TransformId id, double value, TransformResult &result) const
+    {
+        result.number = value;
+        result.label = NULL;
+        result.labelLength = 0;
+
+        if (id >= _programs.size()) {
+            return;
+        }
+
+        const Op *op = _ops.data() + _programs[id].first;
+        const Op *end = op + _programs[id].count;
+
+        for (; op < end; op++) {
+            switch (op->code) {
+            case TRANSFORM_BOOL_LABEL:
+                if (result.number == 0 || result.number == 1) {
+                    resolve(_labelEntries[op->labels + (result.number == 1 ? 1 : 0)], result);
+                }
+                return;
+            case TRANSFORM_LABEL_MAP:
+                lookup(*op, result.number, result);
+                return;
+            case TRANSFORM_SCALE:
+                result.number = result.number * op->first + op->second;
+                break;
+            case TRANSFORM_CLAMP:
+                result.number = std::min(std::max(result.number, op->first), op->second);
+                break;
+            case TRANSFORM_INVERT:
+                result.number = result.number == 0 ? 1 : 0;
+                break;
+            }
+        }
+    }
+
+    size_t count(void) const { return _programs.size(); };
+
+    void clear(void)
+    {
+        _ops.clear();
+        _labelEntries.clear();
+        _labelText.clear();
+        _programs.clear();
+        _byName.clear();
+        _bySymbol.clear();
+        _unresolved = 0;
+    }
+};
+
+#endif
@@ -0,0 +1,423 @@
+#include <assert.h>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <string.h>
+
+#include "main.h"
+
+// -- public C FFI
+
+extern "C" {
+int simplug_init(SPHANDLE *plugin_instance, LoggingFunctionCB logger)
+{
+    *plugin_instance = new LoadGeneratorPluginStateManager(logger);
+    return 0;
+}
+
+int simplug_bind_symbol_table(SPHANDLE plugin_instance, void *symbol_table)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindSymbolTable(static_cast<SymbolTable *>(symbol_table));
+}
+
+int simplug_bind_latency_tracer(SPHANDLE plugin_instance, void *latency_tracer)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindLatencyTracer(static_cast<LatencyTracer *>(latency_tracer));
+}
+
+int simplug_bind_metrics(SPHANDLE plugin_instance, void *metrics)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindMetrics(static_cast<MetricsRegistry *>(metrics));
+}
+
+int simplug_config_passthrough(SPHANDLE plugin_instance, void *libconfig_instance)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->configPassthrough(static_cast<libconfig::Config *>(libconfig_instance));
+}
+
+int simplug_preflight_complete(SPHANDLE plugin_instance)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->preflightComplete();
+}
+
+void simplug_commence_eventing(SPHANDLE plugin_instance, EnqueueEventHandler enqueue_callback, void *arg)
+{
+    static_cast<PluginStateManager *>(plugin_instance)->commenceEventing(enqueue_callback, arg);
+}
+
+int simplug_deliver_value(SPHANDLE plugin_instance, GenericTLV *value)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->deliverValue(value);
+}
+
+int simplug_deliver_values(SPHANDLE plugin_instance, GenericTLV **values, int count)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->deliverValues(values, count);
+}
+
+void simplug_cease_eventing(SPHANDLE plugin_instance)
+{
+    static_cast<PluginStateManager *>(plugin_instance)->ceaseEventing();
+}
+
+void simplug_release(SPHANDLE plugin_instance)
+{
+    assert(plugin_instance);
+    delete static_cast<PluginStateManager *>(plugin_instance);
+}
+}
+
+// -- internal implementation
+
+//! looks up a number that may be written as an integer or a float
+static bool LookupNumber(libconfig::Setting &setting, const char *name, double &value)
+{
+    int intValue;
+
+    if (setting.lookupValue(name, value)) {
+        return true;
+    }
+
+    if (setting.lookupValue(name, intValue)) {
+        value = intValue;
+        return true;
+    }
+
+    return false;
+}
+
+LoadGeneratorPluginStateManager::LoadGeneratorPluginStateManager(LoggingFunctionCB logger)
+    : PluginStateManager(logger)
+    , _generating(false)
+    , _generated(0)
+    , _delivered(0)
+    , _generatedCounter(NULL)
+    , _deliveredCounter(NULL)
+{
+    _name = "loadgen";
+}
+
+LoadGeneratorPluginStateManager::~LoadGeneratorPluginStateManager(void)
+{
+    ceaseEventing();
+}
+
+ConfigType LoadGeneratorPluginStateManager::TypeForName(const std::string &name)
+{
+    switch (name.empty() ? '\0' : name[0]) {
+    case 'G':
+    case 'E':
+        return CONFIG_FLOAT;
+    case 'N':
+        return CONFIG_INT;
+    case 'V':
+        return CONFIG_UINT;
+    case 'I':
+    case 'B':
+    case 'S':
+        return CONFIG_BOOL;
+    default:
+        break;
+    }
+
+    return CONFIG_STRING;
+}
+
+void LoadGeneratorPluginStateManager::addElement(const std::string &name, const std::string &type)
+{
+    LoadElement element;
+
+    element.name = name;
+    element.symbol = symbolFor(name);
+    element.sequence = 0;
+
+    if (type == "int") {
+        element.type = CONFIG_INT;
+    }
+    else if (type == "float") {
+        element.type = CONFIG_FLOAT;
+    }
+    else if (type == "bool") {
+        element.type = CONFIG_BOOL;
+    }
+    else if (type == "string") {
+        element.type = CONFIG_STRING;
+    }
+    else {
+        element.type = TypeForName(name);
+    }
+
+    _elements.push_back(element);
+}
+
+/**
+ * reads element names from the Name column of a markdown table - rows
+ * look like "| 0|A_ASP_ADF_1_VOLUME| description | ANALOG | |char|"
+ */
+bool LoadGeneratorPluginStateManager::loadElementTable(const std::string &path, const std::vector<std::string> &prefixes, size_t maxElements, const std::string &type)
+{
+    std::ifstream table(path);
+    std::string line;
+    std::vector<std::string> names;
+
+    if (!table.is_open()) {
+        _logger(LOG_ERROR, "<LoadGenerator> Could not open element table %s", path.c_str());
+        return false;
+    }
+
+    while (std::getline(table, line) && (maxElements == 0 || names.size() < maxElements)) {
+        std::vector<std::string> columns;
+        std::stringstream row(line);
+        std::string column;
+
+        if (line.empty() || line[0] != '|') {
+            continue;
+        }
+
+        while (std::getline(row, column, '|')) {
+            size_t first = column.find_first_not_of(' ');
+            size_t last = column.find_last_not_of(' ');
+            columns.push_back(first == std::string::npos ? "" : column.substr(first, last - first + 1));
+        }
+
+        // columns[0] is the empty text before the leading '|'
+        if (columns.size() < 3 || columns[2].empty() || columns[2] == "Name" || columns[2][0] == '-') {
+            continue;
+        }
+
+        bool matched = prefixes.empty();
+
+        for (const std::string &prefix : prefixes) {
+            matched = matched || columns[2].compare(0, prefix.size(), prefix) == 0;
+        }
+
+        if (matched) {
+            names.push_back(columns[2]);
+        }
+    }
+
+    for (std::string &name : names) {
+        addElement(name, type);
+    }
+
+    _logger(LOG_INFO, "<LoadGenerator> %lu element(s) from %s", names.size(), path.c_str());
+
+    return true;
+}
+
+int LoadGeneratorPluginStateManager::preflightComplete(void)
+{
+    std::string elementsFile;
+    std::string type("auto");
+    std::vector<std::string> prefixes;
+    double ratePerElement = LOADGEN_DEFAULT_RATE_PER_ELEMENT;
+    double eventsPerSecond = 0;
+    int maxElements = 0;
+    int burstSize = 0;
+    int burstInterval = 1000;
+    int duration = 0;
+    int threads = 1;
+
+    libconfig::Setting *configuration = NULL;
+
+    try {
+        configuration = &_config->lookup("configuration");
+    }
+    catch (const libconfig::SettingNotFoundException &nfex) {
+        _logger(LOG_ERROR, "<LoadGenerator> No configuration group in config");
+        return PREFLIGHT_FAIL;
+    }
+
+    configuration->lookupValue("elementsFile", elementsFile);
+    configuration->lookupValue("type", type);
+    configuration->lookupValue("maxElements", maxElements);
+    configuration->lookupValue("durationSeconds", duration);
+    configuration->lookupValue("threads", threads);
+    LookupNumber(*configuration, "ratePerElement", ratePerElement);
+    LookupNumber(*configuration, "eventsPerSecond", eventsPerSecond);
+
+    if (configuration->exists("prefixes")) {
+        libconfig::Setting &prefixList = (*configuration)["prefixes"];
+
+        for (int i = 0; i < prefixList.getLength(); i++) {
+            prefixes.push_back((const char *)prefixList[i]);
+        }
+    }
+
+    if (configuration->exists("burst")) {
+        (*configuration)["burst"].lookupValue("size", burstSize);
+        (*configuration)["burst"].lookupValue("intervalMs", burstInterval);
+    }
+
+    if (configuration->exists("elements")) {
+        libconfig::Setting &elements = (*configuration)["elements"];
+
+        for (int i = 0; i < elements.getLength(); i++) {
+            addElement((const char *)elements[i], type);
+        }
+    }
+
+    if (!elementsFile.empty() && !loadElementTable(elementsFile, prefixes, maxElements > 0 ? maxElements : 0, type)) {
+        return PREFLIGHT_FAIL;
+    }
+
+    if (_elements.empty()) {
+        _logger(LOG_ERROR, "<LoadGenerator> No elements to generate");
+        return PREFLIGHT_FAIL;
+    }
+
+    _settings.eventsPerSecond = eventsPerSecond > 0 ? eventsPerSecond : ratePerElement * _elements.size();
+    _settings.burstSize = burstSize > 0 ? burstSize : 0;
+    _settings.burstInterval = std::chrono::milliseconds(burstInterval > 0 ? burstInterval : 1000);
+    _settings.duration = std::chrono::seconds(duration > 0 ? duration : 0);
+    _settings.threads = threads > 0 ? threads : 1;
+
+    _generatedCounter = &metrics().counter("simhub_loadgen_generated_total", "Events the load generator produced");
+    _deliveredCounter = &metrics().counter("simhub_loadgen_delivered_total", "Values delivered back to the load generator");
+
+    _logger(LOG_INFO, "<LoadGenerator> %lu element(s), %.0f event(s)/s on %u thread(s)", _elements.size(), _settings.eventsPerSecond, _settings.threads);
+
+    return PREFLIGHT_OK;
+}
+
+//! hands the next value of element to the core
+void LoadGeneratorPluginStateManager::emit(LoadElement &element)
+{
+    GenericTLV *el = make_generic(element.name.c_str(), "-");
+    uint64_t sequence = element.sequence++;
+
+    el->ownerPlugin = this;
+    el->symbol = element.symbol;
+    el->ingestTime = monotonic_nanos();
+    el->type = element.type;
+
+    switch (element.type) {
+    case CONFIG_FLOAT:
+        el->value.float_value = (float)(100.0 * sin(sequence / 10.0));
+        el->length = sizeof(float);
+        break;
+    case CONFIG_BOOL:
+        el->value.bool_value = sequence & 1;
+        el->length = sizeof(uint8_t);
+        break;
+    case CONFIG_STRING: {
+        char value[32];
+        snprintf(value, sizeof(value), "%llu", (unsigned long long)sequence);
+        generic_set_string(el, &(el->value.string_value), value);
+        el->length = strlen(value);
+        break;
+    }
+    default:
+        el->value.int_value = (int)sequence;
+        el->length = sizeof(int);
+        break;
+    }
+
+    traceLatency(LATENCY_STAGE_PARSE, el->ingestTime);
+    _enqueueCallback(this, (void *)el, _callbackArg);
+
+    _generated++;
+    _generatedCounter->add();
+}
+
+/**
+ * generator thread - owns every threads'th element starting at
+ * generator and its share of the rate and bursts. Falling more than a
+ * tenth of a second behind (the core blocking the callback) drops the
+ * backlog rather than catching up in one go.
+ */
+void LoadGeneratorPluginStateManager::generate(unsigned int generator)
+{
+    std::vector<LoadElement *> elements;
+
+    for (size_t i = generator; i < _elements.size(); i += _settings.threads) {
+        elements.push_back(&_elements[i]);
+    }
+
+    if (elements.empty()) {
+        return;
+    }
+
+    double rate = _settings.eventsPerSecond / _settings.threads;
+    uint64_t maxBacklog = rate / 10 > 1 ? (uint64_t)(rate / 10) : 1;
+    unsigned int burstSize = (_settings.burstSize + _settings.threads - 1 - generator) / _settings.threads;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point nextBurst = start + _settings.burstInterval;
+    uint64_t sent = 0;
+    size_t cursor = 0;
+
+    while (_generating) {
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+        if (_settings.duration.count() > 0 && now - start >= _settings.duration) {
+            break;
+        }
+
+        uint64_t due = (uint64_t)(std::chrono::duration<double>(now - start).count() * rate);
+
+        if (due > sent + maxBacklog) {
+            sent = due - maxBacklog;
+        }
+
+        while (sent < due && _generating) {
+            emit(*elements[cursor]);
+            cursor = (cursor + 1) % elements.size();
+            sent++;
+        }
+
+        if (burstSize > 0 && now >= nextBurst) {
+            for (unsigned int i = 0; i < burstSize && _generating; i++) {
+                emit(*elements[cursor]);
+                cursor = (cursor + 1) % elements.size();
+            }
+
+            nextBurst += _settings.burstInterval;
+        }
+
+        std::this_thread::sleep_for(LOADGEN_IDLE_SLEEP);
+    }
+}
+
+void LoadGeneratorPluginStateManager::commenceEventing(EnqueueEventHandler enqueueCallback, void *arg)
+{
+    _enqueueCallback = enqueueCallback;
+    _callbackArg = arg;
+    _generating = true;
+
+    for (unsigned int generator = 0; generator < _settings.threads; generator++) {
+        _generators.push_back(std::thread(&LoadGeneratorPluginStateManager::generate, this, generator));
+    }
+}
+
+void LoadGeneratorPluginStateManager::ceaseEventing(void)
+{
+    if (_generators.empty()) {
+        return;
+    }
+
+    _generating = false;
+
+    for (std::thread &generator : _generators) {
+        generator.join();
+    }
+
+    _generators.clear();
+
+    _logger(LOG_INFO, "<LoadGenerator> %llu event(s) generated, %llu value(s) delivered back", (unsigned long long)_generated, (unsigned long long)_delivered);
+}
+
+//! only counts - the load generator is also a sink for whatever the core routes to it
+int LoadGeneratorPluginStateManager::deliverValue(GenericTLV *value)
+{
+    traceLatency(LATENCY_STAGE_DELIVER, value->ingestTime);
+
+    _delivered++;
+
+    if (_deliveredCounter) {
+        _deliveredCounter->add();
+    }
+
+    traceLatency(LATENCY_STAGE_COMPLETE, value->ingestTime);
+
+    return 0;
+}
@@ -0,0 +1,85 @@
+#ifndef __LOADGEN_MAIN_H
+#define __LOADGEN_MAIN_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/private/pluginstatemanager.h"
+
+#define LOADGEN_DEFAULT_ELEMENTS_FILE "../docs/simDataElements.md"
+#define LOADGEN_DEFAULT_RATE_PER_ELEMENT 10.0
+//! a generator that has caught up sleeps this long before looking again
+#define LOADGEN_IDLE_SLEEP std::chrono::microseconds(500)
+
+//! one generated element and the type of the values generated for it
+struct LoadElement {
+    std::string name;
+    SymbolId symbol;
+    ConfigType type;
+    uint64_t sequence; ///< number of values generated so far, drives the value
+};
+
+//! the generators' settings, the configuration group of loadgen.cfg
+struct LoadSettings {
+    double eventsPerSecond; ///< total target across all elements
+    unsigned int burstSize; ///< extra events sent back to back every burstInterval, 0 for none
+    std::chrono::milliseconds burstInterval;
+    std::chrono::seconds duration; ///< 0 to generate until eventing ceases
+    unsigned int threads;
+
+    LoadSettings(void)
+        : eventsPerSecond(0)
+        , burstSize(0)
+        , burstInterval(1000)
+        , duration(0)
+        , threads(1){};
+};
+
+/**
+ * Synthetic event source for stress and soak testing the core
+ *
+ * - element names come from the configured list and/or the name column
+ *   of a markdown element table such as docs/simDataElements.md,
+ *   optionally filtered by prefix
+ * - value types follow the ProSim prefix convention (as the prepare3d
+ *   plugin parses them) unless a type is forced
+ * - each generator thread owns a share of the elements and the rate and
+ *   paces itself against the clock, so a stalled core shows up as lost
+ *   rate rather than a burst once it recovers
+ * - everything delivered back to the plugin is counted
+ */
+class LoadGeneratorPluginStateManager : public PluginStateManager
+{
+protected:
+    std::vector<LoadElement> _elements;
+    LoadSettings _settings;
+    std::vector<std::thread> _generators;
+    std::atomic<bool> _generating;
+    std::atomic<uint64_t> _generated;
+    std::atomic<uint64_t> _delivered;
+    MetricCounter *_generatedCounter;
+    MetricCounter *_deliveredCounter;
+
+    bool loadElementTable(const std::string &path, const std::vector<std::string> &prefixes, size_t maxElements, const std::string &type);
+    //! type is "int", "float", "bool" or "string", anything else picks the type from the name
+    void addElement(const std::string &name, const std::string &type);
+    void generate(unsigned int generator);
+    void emit(LoadElement &element);
+
+public:
+    LoadGeneratorPluginStateManager(LoggingFunctionCB logger);
+    virtual ~LoadGeneratorPluginStateManager(void);
+
+    int preflightComplete(void);
+    void commenceEventing(EnqueueEventHandler enqueueCallback, void *arg);
+    void ceaseEventing(void);
+    int deliverValue(GenericTLV *value);
+
+    //! ProSim type of an element, from the first letter of its name
+    static ConfigType TypeForName(const std::string &name);
+};
+
+#endif
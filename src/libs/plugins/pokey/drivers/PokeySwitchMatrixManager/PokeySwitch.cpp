@@ -6,6 +6,7 @@
 PokeySwitch::PokeySwitch(sPoKeysDevice *pokey, int id, std::string name, int pin, int enablePin, bool invert, bool invertEnablePin)
 {
     _previousValue = -1;
+    _valueTransform = TRANSFORM_NONE;
     _pokey = pokey;
     _pin = pin;
     _enablePin = enablePin;
@@ -41,25 +42,22 @@ void PokeySwitch::addVirtualPin(std::string name, size_t position)
     _physPinMask[name] = std::make_shared<std::pair<size_t, int>>(position, 0);
 }
 
-std::string PokeySwitch::transformedValue(void)
+const char *PokeySwitch::transformedValue(void)
 {
-    if (!mapContains(_valueTransforms, (int)_currentValue)) {
-        std::cout << "/// NO TRANSFORM FOR: " << (int)_currentValue << std::endl;
-        return "";
-    }
-    else {
-        std::cout << "/// TRANSFORM FOR: " << (int)_currentValue << std::endl;
-        return _valueTransforms[_currentValue];
-    }
+    TransformResult result;
+
+    _valueTransforms.apply(_valueTransform, _currentValue, result);
+
+    return result.labelLength ? result.label : NULL;
 }
 
 GenericTLV *PokeySwitch::valueAsGeneric(void)
 {
     GenericTLV *el = NULL;
-    std::string value = transformedValue();
+    const char *value = transformedValue();
 
-    if (value.size() > 0) {
-        el = make_string_generic(name().c_str(), "pokey switch input", value.c_str());
+    if (value) {
+        el = make_string_generic(name().c_str(), "pokey switch input", value);
     }
 
     return el;
@@ -110,7 +108,8 @@ void PokeySwitch::updateVirtualValue(void)
     }
 
     if (_currentValue != _previousValue) {
-        std::cout << "/// currentValue: " << transformedValue() << std::endl;
+        const char *value = transformedValue();
+        std::cout << "/// currentValue: " << (value ? value : "") << std::endl;
     }
 }
 
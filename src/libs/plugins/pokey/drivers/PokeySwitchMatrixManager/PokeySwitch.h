@@ -9,6 +9,7 @@
 #include <PoKeysLib.h>
 
 #include "common/simhubdeviceplugin.h"
+#include "common/transformengine.h"
 
 typedef std::map<std::string, std::shared_ptr<std::pair<size_t, int>>> PinMaskMap;
 
@@ -26,9 +27,11 @@ protected:
     uint8_t _currentValue;
     PinMaskMap _physPinMask;
     bool _isPartialPin;
-    std::map<int, std::string> _valueTransforms;
+    TransformEngine _valueTransforms; ///< value to position label, compiled from valueTransforms
+    TransformId _valueTransform;
 
-    std::string transformedValue(void);
+    //! label for the current value, NULL if it has none
+    const char *transformedValue(void);
 
 public:
     PokeySwitch(sPoKeysDevice *pokey, 
@@ -52,7 +55,11 @@ public:
     bool isVirtualPinMember(std::shared_ptr<PokeySwitch> pokeyPin);
     void updateVirtualValue(void);
     GenericTLV *valueAsGeneric(void);
-    void setValueTransforms(std::map<int, std::string> &valueTransforms) { _valueTransforms = valueTransforms; };
+    void setValueTransforms(const TransformChain &valueTransforms)
+    {
+        _valueTransforms.clear();
+        _valueTransform = _valueTransforms.compile(valueTransforms);
+    };
     void setIsPartialPin(bool isPartialPin) { _isPartialPin = isPartialPin; };
 };
 
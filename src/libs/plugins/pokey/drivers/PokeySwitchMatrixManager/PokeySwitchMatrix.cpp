@@ -24,7 +24,7 @@ int PokeySwitchMatrix::addSwitch(int id, std::string name, int pin, int enablePi
     return 0;
 }
 
-void PokeySwitchMatrix::addVirtualPin(std::string virtualPinName, bool invert, PinMaskMap &virtualPinMask, std::map<int, std::string> &valueTransforms)
+void PokeySwitchMatrix::addVirtualPin(std::string virtualPinName, bool invert, PinMaskMap &virtualPinMask, const TransformChain &valueTransforms)
 {
     std::shared_ptr<PokeySwitch> pin = std::make_shared<PokeySwitch>(_pokey, 0, virtualPinName, 0, 0, invert, false);
     pin->setVirtualPinMask(virtualPinMask);
@@ -32,7 +32,7 @@ public:
     int id(void);
     int addSwitch(int id, std::string name, int pin, int enablePin, bool invert, bool invertEnablePin);
     std::vector<GenericTLV *> readSwitches(void);
-    void addVirtualPin(std::string virtualPinName, bool invert, PinMaskMap &virtualPinMask, std::map<int, std::string> &valueTransforms);
+    void addVirtualPin(std::string virtualPinName, bool invert, PinMaskMap &virtualPinMask, const TransformChain &valueTransforms);
 };
 
 #endif
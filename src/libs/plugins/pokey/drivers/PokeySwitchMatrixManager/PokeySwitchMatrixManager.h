@@ -22,6 +22,7 @@ public:
     std::shared_ptr<PokeySwitchMatrix> matrix(std::string name);
     std::shared_ptr<PokeySwitchMatrix> matrix(int id);
     std::vector<GenericTLV *> readAll();
+    bool empty(void) const { return _switchMatrix.empty(); };
 };
 
 #endif
@@ -20,6 +20,21 @@ int simplug_init(SPHANDLE *plugin_instance, LoggingFunctionCB logger)
     return 0;
 }
 
+int simplug_bind_symbol_table(SPHANDLE plugin_instance, void *symbol_table)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindSymbolTable(static_cast<SymbolTable *>(symbol_table));
+}
+
+int simplug_bind_latency_tracer(SPHANDLE plugin_instance, void *latency_tracer)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindLatencyTracer(static_cast<LatencyTracer *>(latency_tracer));
+}
+
+int simplug_bind_metrics(SPHANDLE plugin_instance, void *metrics)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindMetrics(static_cast<MetricsRegistry *>(metrics));
+}
+
 int simplug_config_passthrough(SPHANDLE plugin_instance, void *libconfig_instance)
 {
     return static_cast<PluginStateManager *>(plugin_instance)->configPassthrough(static_cast<libconfig::Config *>(libconfig_instance));
@@ -40,6 +55,16 @@ int simplug_deliver_value(SPHANDLE plugin_instance, GenericTLV *value)
     return static_cast<PluginStateManager *>(plugin_instance)->deliverValue(value);
 }
 
+int simplug_deliver_values(SPHANDLE plugin_instance, GenericTLV **values, int count)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->deliverValues(values, count);
+}
+
+int simplug_enumerate_targets(SPHANDLE plugin_instance, EnumerateTargetHandler target_callback, void *arg)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->enumerateTargets(target_callback, arg);
+}
+
 void simplug_cease_eventing(SPHANDLE plugin_instance)
 {
     static_cast<PluginStateManager *>(plugin_instance)->ceaseEventing();
@@ -83,6 +108,26 @@ void PokeyDevicePluginStateManager::ceaseEventing(void)
     for (auto devPair : _deviceMap) {
         devPair.second->stopPolling();
     }
+
+    _scheduler.stop();
+}
+
+void PokeyDevicePluginStateManager::startScheduler(void)
+{
+    unsigned int threads = POKEY_SCHEDULER_DEFAULT_THREADS;
+
+    // the pool does not grow with the devices, each thread waits on one PoKeys answer at a time
+    _config->lookupValue("pollThreads", threads);
+    _scheduler.start(threads);
+
+    _logger(LOG_INFO, "Polling %d devices on %u threads", (int)_polledDevices.size(), threads);
+
+    PokeyScheduler *scheduler = &_scheduler;
+
+    metrics().gaugeFunction("simhub_pokey_scheduler_threads", "Threads polling PoKeys devices", "", [scheduler] { return (double)scheduler->threads(); });
+    metrics().counterFunction("simhub_pokey_scheduler_runs_total", "PoKeys polls run by the scheduler", "", [scheduler] { return (uint64_t)scheduler->runs(); });
+    metrics().counterFunction(
+        "simhub_pokey_scheduler_deferrals_total", "Due PoKeys polls that waited for another poll of the same device", "", [scheduler] { return (uint64_t)scheduler->deferrals(); });
 }
 
 int PokeyDevicePluginStateManager::processPokeyDeviceUpdate(std::shared_ptr<PokeyDevice> device)
@@ -97,15 +142,27 @@ int PokeyDevicePluginStateManager::deliverValue(GenericTLV *data)
     int retVal = 0;
     // printf("-----> %s %i %i\n",data->name, data->type, (int)data->value);
 
-    std::shared_ptr<PokeyDevice> device = targetFromDeviceTargetList(data->name);
+    traceLatency(LATENCY_STAGE_DELIVER, data->ingestTime);
+
+    // routed deliveries carry the device we declared for the target
+    PokeyDevice *device = static_cast<PokeyDevice *>(data->targetHandle);
+    std::shared_ptr<PokeyDevice> targetDevice;
+
+    if (!device) {
+        targetDevice = targetFromDeviceTargetList(data->name, data->symbol);
+        device = targetDevice.get();
+    }
 
     if (device) {
         if (data->type == ConfigType::CONFIG_BOOL) {
-            retVal = device->targetValue(data->name, (bool)data->value);
+            retVal = device->targetValue(data->name, (bool)data->value, data->symbol);
         }
         else if (data->type == ConfigType::CONFIG_INT) {
-            retVal = device->targetValue(data->name, (int)data->value);
+            retVal = device->targetValue(data->name, (int)data->value, data->symbol);
         }
+
+        // targetValue returns once the device has been written to
+        traceLatency(LATENCY_STAGE_COMPLETE, data->ingestTime);
     }
     else {
         // std::cout << "no target device found" << std::endl;
@@ -114,6 +171,16 @@ int PokeyDevicePluginStateManager::deliverValue(GenericTLV *data)
     return retVal;
 }
 
+//! declares every configured output target, the handle is the device that drives it
+int PokeyDevicePluginStateManager::enumerateTargets(EnumerateTargetHandler targetCallback, void *arg)
+{
+    for (std::string &target : _targetNames) {
+        targetCallback(arg, target.c_str(), _deviceMap[target].get());
+    }
+
+    return 0;
+}
+
 void PokeyDevicePluginStateManager::commenceEventing(EnqueueEventHandler enqueueCallback, void *arg)
 {
     _enqueueCallback = enqueueCallback;
@@ -122,6 +189,13 @@ void PokeyDevicePluginStateManager::commenceEventing(EnqueueEventHandler enqueue
     for (auto devPair : _deviceMap) {
         devPair.second->setCallbackInfo(_enqueueCallback, _callbackArg, this);
     }
+
+    // polls enqueue what they find, they only start once there is somewhere to enqueue it
+    startScheduler();
+
+    for (std::shared_ptr<PokeyDevice> &device : _polledDevices) {
+        device->startPolling(_scheduler);
+    }
 }
 
 void PokeyDevicePluginStateManager::enumerateDevices(void)
@@ -149,12 +223,22 @@ void PokeyDevicePluginStateManager::enumerateDevices(void)
 bool PokeyDevicePluginStateManager::addTargetToDeviceTargetList(std::string target, std::shared_ptr<PokeyDevice> device)
 {
     // printf("----> adding %s to %s\n", target.c_str(), device->name().c_str());
-    _deviceMap.emplace(target, device);
+    if (_deviceMap.emplace(target, device).second) {
+        _deviceBySymbol.set(symbolFor(target), device);
+        _targetNames.push_back(target);
+    }
+
     return true;
 }
 
-std::shared_ptr<PokeyDevice> PokeyDevicePluginStateManager::targetFromDeviceTargetList(std::string key)
+std::shared_ptr<PokeyDevice> PokeyDevicePluginStateManager::targetFromDeviceTargetList(std::string key, SymbolId symbol)
 {
+    std::shared_ptr<PokeyDevice> *device = _deviceBySymbol.find(symbol);
+
+    if (device) {
+        return *device;
+    }
+
     // std::cout << "trying to find " << key << std::endl;
 
     std::map<std::string, std::shared_ptr<PokeyDevice>>::iterator it = _deviceMap.find(key);
@@ -265,15 +349,11 @@ bool PokeyDevicePluginStateManager::deviceConfiguration(libconfig::SettingIterat
 
 void PokeyDevicePluginStateManager::loadTransform(std::string pinName, libconfig::Setting *transform)
 {
-    _logger(LOG_INFO, "Transform | %s added", pinName.c_str());
+    TransformChain chain;
 
-    if (transform->exists("On") && transform->exists("Off")) {
-        std::string transformResultOn;
-        std::string transformResultOff;
-
-        transform->lookupValue("On", transformResultOn);
-        transform->lookupValue("Off", transformResultOff);
-        _pinValueTransforms.emplace(pinName, std::bind(&PokeyDevicePluginStateManager::transformBoolToString, this, std::placeholders::_1, transformResultOff, transformResultOn));
+    if (TransformChainFromSetting(*transform, chain)) {
+        _pinValueTransforms.add(pinName, symbolFor(pinName), chain);
+        _logger(LOG_INFO, "Transform | %s added", pinName.c_str());
     }
 }
 
@@ -400,22 +480,6 @@ bool PokeyDevicePluginStateManager::devicePinsConfiguration(libconfig::Setting *
     return retVal;
 }
 
-/**
- *   @brief  Default  find a transform by element name
- *
- *   @return TransformFunction or NULL if not found
- */
-TransformFunction PokeyDevicePluginStateManager::transformForPinName(std::string name)
-{
-    TransformMap::iterator it = _pinValueTransforms.find(name);
-
-    if (it != _pinValueTransforms.end()) {
-        return (*it).second;
-    }
-
-    return NULL;
-}
-
 bool PokeyDevicePluginStateManager::pinRemapped(std::string pinName)
 {
     return mapContains(_remappedPins, pinName);
@@ -448,6 +512,39 @@ bool PokeyDevicePluginStateManager::devicePWMConfiguration(libconfig::Setting *p
     return retVal;
 }
 
+bool PokeyDevicePluginStateManager::devicePollingConfiguration(libconfig::Setting *polling, std::shared_ptr<PokeyDevice> pokeyDevice)
+{
+    PollOptions options;
+    unsigned int interval = POLL_DEFAULT_INTERVAL;
+
+    polling->lookupValue("startDelay", options.startDelay);
+    polling->lookupValue("interval", interval);
+
+    // a function without its own interval polls at the device's
+    for (int i = 0; i < POLL_FUNCTION_COUNT; i++) {
+        options.interval[i] = interval;
+        polling->lookupValue(PollFunctionName((PollFunction)i), options.interval[i]);
+    }
+
+    if (polling->exists("adaptive")) {
+        libconfig::Setting *adaptive = &polling->lookup("adaptive");
+
+        options.adaptive = true;
+        adaptive->lookupValue("enabled", options.adaptive);
+        adaptive->lookupValue("interval", options.activeInterval);
+        adaptive->lookupValue("hold", options.activeHold);
+    }
+
+    pokeyDevice->setPollOptions(options);
+
+    std::string adaptiveRate = options.adaptive ? ", " + std::to_string(options.activeInterval) + "ms for " + std::to_string(options.activeHold) + "ms after a change" : "";
+
+    _logger(LOG_INFO, "%s | Polling | pins %ums, encoders %ums, switch matrix %ums%s", pokeyDevice->name().c_str(), options.interval[POLL_PINS], options.interval[POLL_ENCODERS],
+        options.interval[POLL_SWITCH_MATRIX], adaptiveRate.c_str());
+
+    return true;
+}
+
 bool PokeyDevicePluginStateManager::deviceEncodersConfiguration(libconfig::Setting *encoders, std::shared_ptr<PokeyDevice> pokeyDevice)
 {
     bool retVal = true;
@@ -737,7 +834,7 @@ int PokeyDevicePluginStateManager::deviceSwitchMatrixSwitchConfiguration(
                     assert(iter->exists("valueTransforms"));
 
                     libconfig::Setting &transforms = iter->lookup("valueTransforms");
-                    std::map<int, std::string> valueTransforms;
+                    TransformChain valueTransforms;
 
                     char valueNameBuffer[64];
                     char SEPCHAR = '_';
@@ -750,7 +847,7 @@ int PokeyDevicePluginStateManager::deviceSwitchMatrixSwitchConfiguration(
                             }
                         }
 
-                        valueTransforms[(int)*transformIter] = valueNameBuffer;
+                        valueTransforms.label((int)*transformIter, valueNameBuffer);
                     }
 
                     pokeyDevice->configSwitchMatrixVirtualPin(id, name, invert, virtualPinMask, valueTransforms);
@@ -784,6 +881,7 @@ int PokeyDevicePluginStateManager::preflightComplete(void)
     _preflightComplete = false;
 
     enumerateDevices();
+    _polledDevices.clear();
 
     try {
         devicesConfiguraiton = &_config->lookup("configuration");
@@ -843,7 +941,11 @@ int PokeyDevicePluginStateManager::preflightComplete(void)
         if (iter->exists("switchMatrix"))
             deviceSwitchMatrixConfiguration(&iter->lookup("switchMatrix"), pokeyDevice);
 
-        pokeyDevice->startPolling();
+        if (iter->exists("polling"))
+            devicePollingConfiguration(&iter->lookup("polling"), pokeyDevice);
+
+        // polling starts with eventing, see commenceEventing
+        _polledDevices.push_back(pokeyDevice);
     }
 
     if (_numberOfDevices > 0) {
@@ -21,9 +21,6 @@ typedef std::pair<std::string, std::shared_ptr<PokeyDevice>> pokeyDevicePair;
 typedef std::map<std::string, std::shared_ptr<PokeyDevice>> PokeyDeviceMap; ///< a list of unique device pointers
 typedef PokeyDeviceMap::iterator deviceTargetIterator; ///< iterator for deviceTargers
 
-typedef std::function<std::string(std::string, std::string, std::string)> TransformFunction;
-typedef std::map<std::string, TransformFunction> TransformMap;
-
 //! barest specialisation of the internal plugin management support base class
 class PokeyDevicePluginStateManager : public PluginStateManager
 {
@@ -44,20 +41,26 @@ protected:
 
     bool deviceDisplaysConfiguration(libconfig::Setting *displays, std::shared_ptr<PokeyDevice> pokeyDevice);
     bool devicePWMConfiguration(libconfig::Setting *pwm, std::shared_ptr<PokeyDevice> pokeyDevice);
+    bool devicePollingConfiguration(libconfig::Setting *polling, std::shared_ptr<PokeyDevice> pokeyDevice);
     int deviceDisplaysGroupsConfiguration(libconfig::Setting *displayGroups, int id, std::shared_ptr<PokeyDevice> pokeyDevice, std::string type);
     int deviceSwitchMatrixConfiguration(libconfig::Setting *switchMatrix, std::shared_ptr<PokeyDevice> pokeyDevice);
     int deviceSwitchMatrixSwitchConfiguration(libconfig::Setting *switches, int id, std::shared_ptr<PokeyDevice> pokeyDevice, std::string name, std::string type, bool enabled);
 
     bool addTargetToDeviceTargetList(std::string, std::shared_ptr<PokeyDevice> device);
-    std::shared_ptr<PokeyDevice> targetFromDeviceTargetList(std::string);
+    std::shared_ptr<PokeyDevice> targetFromDeviceTargetList(std::string, SymbolId symbol = SYMBOL_UNRESOLVED);
     void enumerateDevices(void);
     void loadTransform(std::string pinName, libconfig::Setting *transform);
     void loadMapTo(std::string pinName, libconfig::Setting *mapTo);
+    void startScheduler(void);
 
     int _numberOfDevices;
+    PokeyScheduler _scheduler; ///< polls every device, declared ahead of the devices so it outlives them
     PokeyDeviceMap _deviceMap;
+    std::vector<std::shared_ptr<PokeyDevice>> _polledDevices; ///< configured by preflight, polled while eventing
+    SymbolIndex<std::shared_ptr<PokeyDevice>> _deviceBySymbol;
+    std::vector<std::string> _targetNames;
     sPoKeysNetworkDeviceSummary *_devices;
-    TransformMap _pinValueTransforms;
+    TransformEngine _pinValueTransforms; ///< compiled from the pins' transform blocks, read only once eventing
     std::map<std::string, std::pair<std::shared_ptr<PokeyDevice>, std::string>> _remappedPins;
     std::mutex _pinRemappingMutex;
     std::vector<std::string> _pinNames;
@@ -68,12 +71,14 @@ public:
     int preflightComplete(void);
     void commenceEventing(EnqueueEventHandler enqueueCallback, void *arg);
     virtual int deliverValue(GenericTLV *value);
+    virtual int enumerateTargets(EnumerateTargetHandler targetCallback, void *arg);
     virtual void ceaseEventing(void);
     std::shared_ptr<PokeyDevice> device(std::string);
     virtual int processPokeyDeviceUpdate(std::shared_ptr<PokeyDevice> device);
 
-    //! returns the value transformation for the given pin name
-    TransformFunction transformForPinName(std::string name);
+    //! returns the value transformation for the given pin name (by symbol when it is resolved), TRANSFORM_NONE if there is none
+    TransformId transformForPinName(const std::string &name, SymbolId symbol = SYMBOL_UNRESOLVED) { return _pinValueTransforms.find(name, symbol); };
+    const TransformEngine &pinValueTransforms(void) { return _pinValueTransforms; };
 
     //! allows callers to check if a given pin has a remapping
     bool pinRemapped(std::string pinName);
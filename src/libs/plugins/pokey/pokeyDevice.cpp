@@ -11,6 +11,8 @@ PokeyDevice::PokeyDevice(PokeyDevicePluginStateManager *owner, sPoKeysNetworkDev
     _callbackArg = NULL;
     _enqueueCallback = NULL;
     _owner = owner;
+    _scheduler = NULL;
+    _lastChange = 0;
 
     _pokey = PK_ConnectToNetworkDevice(&deviceSummary);
 
@@ -41,21 +43,112 @@ PokeyDevice::PokeyDevice(PokeyDevicePluginStateManager *owner, sPoKeysNetworkDev
 
     _switchMatrixManager = std::make_shared<PokeySwitchMatrixManager>(_pokey);
 
+    registerMetrics();
     loadPinConfiguration();
-    if (makeAllPinsInactive()) {
-        _pollTimer.data = this;
-        _pollLoop = uv_loop_new();
-        uv_timer_init(_pollLoop, &_pollTimer);
+    _pollable = makeAllPinsInactive();
 
-        int ret = uv_timer_start(&_pollTimer, (uv_timer_cb)&PokeyDevice::DigitalIOTimerCallback, DEVICE_START_DELAY, DEVICE_READ_INTERVAL);
+    if (!_pollable) {
+        printf("Failed to make all pins inactive - pokey polling loop inactive");
+    }
+}
+
+void PokeyDevice::registerMetrics(void)
+{
+    MetricsRegistry &metrics = _owner->metrics();
+    std::string device = "device=\"" + _serialNumber + "\"";
+    const char *errorHelp = "PoKeys calls that failed, by return code";
 
-        if (ret == 0) {
-            _pollThread = std::make_shared<std::thread>([=] { uv_run(_pollLoop, UV_RUN_DEFAULT); });
+    _errorCounters[PK_ERR_TRANSFER] = &metrics.counter("simhub_pokey_errors_total", errorHelp, device + ",code=\"PK_ERR_TRANSFER\"");
+    _errorCounters[PK_ERR_GENERIC] = &metrics.counter("simhub_pokey_errors_total", errorHelp, device + ",code=\"PK_ERR_GENERIC\"");
+    _errorCounters[PK_ERR_PARAMETER] = &metrics.counter("simhub_pokey_errors_total", errorHelp, device + ",code=\"PK_ERR_PARAMETER\"");
+
+    for (int i = 0; i < POLL_FUNCTION_COUNT; i++) {
+        std::string labels = device + ",function=\"" + PollFunctionName((PollFunction)i) + "\"";
+        PollRate *rate = &_pollRates[i];
+
+        _pollDuration[i] = &metrics.histogram("simhub_pokey_poll_duration_seconds", "Duration of one PoKeys input poll", labels);
+        _pollInterval[i] = &metrics.histogram("simhub_pokey_poll_interval_seconds", "Time between the starts of consecutive PoKeys input polls", labels);
+        metrics.counterFunction("simhub_pokey_polls_total", "PoKeys input polls", labels, [rate] { return (uint64_t)rate->polls(); });
+        metrics.gaugeFunction("simhub_pokey_poll_frequency_hertz", "Achieved PoKeys input polls per second", labels, [rate] { return rate->frequency(); });
+        metrics.gaugeFunction("simhub_pokey_poll_jitter_seconds", "Average deviation of the poll interval from its target", labels, [rate] { return rate->jitter(); });
+        metrics.gaugeFunction("simhub_pokey_poll_target_seconds", "Interval the next PoKeys input poll is scheduled at", labels, [rate] { return rate->target() / 1000.0; });
+    }
+}
+
+unsigned int PokeyDevice::poll(PollFunction function)
+{
+    // only run if we have complete our preflight
+    if (!_owner->successfulPreflightCompleted()) {
+        return _pollRates[function].target();
+    }
+
+    int64_t pollStart = monotonic_nanos();
+    bool changed = false;
+
+    {
+        // values are written to the device from the delivery thread
+        std::lock_guard<std::mutex> lock(_pokeyMutex);
+
+        switch (function) {
+        case POLL_PINS:
+            changed = pollPins();
+            break;
+        case POLL_ENCODERS:
+            changed = pollEncoders();
+            break;
+        case POLL_SWITCH_MATRIX:
+            changed = pollSwitchMatrix();
+            break;
+        default:
+            break;
         }
     }
-    else {
-        printf("Failed to make all pins inactive - pokey polling loop inactive");
+
+    unsigned int retVal = endPoll(function, pollStart, changed);
+
+    // come back for a settling remapped pin as soon as it is due rather than after a full interval
+    if (function == POLL_PINS && !_settlingPins.empty()) {
+        int64_t due = _settlingPins.front().second + (int64_t)POKEY_REMAP_SETTLE_TIME * 1000000 - monotonic_nanos();
+        retVal = std::min(retVal, (unsigned int)std::max<int64_t>(due / 1000000 + 1, 1));
+    }
+
+    return retVal;
+}
+
+unsigned int PokeyDevice::endPoll(PollFunction function, int64_t pollStart, bool changed)
+{
+    PollRate &rate = _pollRates[function];
+    int64_t previousPoll = rate.lastPoll();
+
+    if (changed) {
+        _lastChange = pollStart;
+    }
+
+    unsigned int interval = rate.polled(pollStart, _lastChange);
+
+    if (previousPoll) {
+        _pollInterval[function]->record(pollStart - previousPoll);
     }
+
+    _pollDuration[function]->record(monotonic_nanos() - pollStart);
+
+    // a change anywhere on the device speeds up all of its functions, not only the one that saw it
+    if (changed && _pollOptions.adaptive && _scheduler) {
+        _scheduler->expedite(this, _pollOptions.activeInterval);
+    }
+
+    return interval;
+}
+
+int PokeyDevice::countError(int result)
+{
+    std::map<int, MetricCounter *>::iterator counter = _errorCounters.find(result);
+
+    if (counter != _errorCounters.end()) {
+        counter->second->add();
+    }
+
+    return result;
 }
 
 bool PokeyDevice::ownsPin(std::string pinName)
@@ -91,199 +184,233 @@ void PokeyDevice::setCallbackInfo(EnqueueEventHandler enqueueCallback, void *cal
     _pluginInstance = pluginInstance;
 }
 
-void PokeyDevice::DigitalIOTimerCallback(uv_timer_t *timer, int status)
+bool PokeyDevice::pollEncoders(void)
 {
-    PokeyDevice *self = static_cast<PokeyDevice *>(timer->data);
-
-    assert(self);
-
-    // only run if we have complete our preflight
-    if (!self->_owner->successfulPreflightCompleted()) {
-        return;
-    }
+    int encoderRetValue = countError(PK_EncoderValuesGet(_pokey));
+    // changes found in this scan are traced from when it completed
+    int64_t readTime = monotonic_nanos();
 
-    // Process the encoders
-    int encoderRetValue = PK_EncoderValuesGet(self->_pokey);
+    bool changed = false;
 
     if (encoderRetValue == PK_OK) {
         GenericTLV *el = NULL;
 
-        for (int i = 0; i < self->_encoderMap.size(); i++) {
+        for (int i = 0; i < _encoderMap.size(); i++) {
 
-            uint32_t step = self->_encoders[i].step;
-            uint32_t newEncoderValue = self->_pokey->Encoders[i].encoderValue;
-            uint32_t previousEncoderValue = self->_encoders[i].previousEncoderValue;
+            uint32_t step = _encoders[i].step;
+            uint32_t newEncoderValue = _pokey->Encoders[i].encoderValue;
+            uint32_t previousEncoderValue = _encoders[i].previousEncoderValue;
 
-            uint32_t currentValue = self->_encoders[i].value;
-            uint32_t min = self->_encoders[i].min;
-            uint32_t max = self->_encoders[i].max;
+            uint32_t currentValue = _encoders[i].value;
+            uint32_t min = _encoders[i].min;
+            uint32_t max = _encoders[i].max;
 
             if (previousEncoderValue != newEncoderValue) {
+                changed = true;
+
 
                 if (newEncoderValue < previousEncoderValue) {
                     // values are decreasing
                     // absolute encoders send 1 or -1
-                    if (self->_encoders[i].type == "absolute") {
-                        self->_encoders[i].value = 1;
+                    if (_encoders[i].type == "absolute") {
+                        _encoders[i].value = 1;
                     }
                     else {
                         if (currentValue <= min) {
-                            self->_encoders[i].previousValue = min;
-                            self->_encoders[i].value = min;
+                            _encoders[i].previousValue = min;
+                            _encoders[i].value = min;
                         }
                         else {
-                            self->_encoders[i].value = currentValue - step;
+                            _encoders[i].value = currentValue - step;
                         }
                     }
                 }
                 else {
                     // values are increasing
-                    if (self->_encoders[i].type == "absolute") {
+                    if (_encoders[i].type == "absolute") {
                         // absolute encoders send 1 or -1
-                        self->_encoders[i].value = -1;
+                        _encoders[i].value = -1;
                     }
                     else {
                         if (currentValue >= max) {
-                            self->_encoders[i].previousValue = max;
-                            self->_encoders[i].value = max;
+                            _encoders[i].previousValue = max;
+                            _encoders[i].value = max;
                         }
                         else {
-                            self->_encoders[i].value = currentValue + step;
+                            _encoders[i].value = currentValue + step;
                         }
                     }
                 }
 
-                el = make_generic(self->_encoders[i].name.c_str(), self->_encoders[i].description.c_str());
+                el = make_generic(_encoders[i].name.c_str(), _encoders[i].description.c_str());
 
-                el->ownerPlugin = self->_owner;
+                el->ownerPlugin = _owner;
+                el->symbol = _encoders[i].symbol;
                 el->type = CONFIG_INT;
-                el->value.int_value = (int)self->_encoders[i].value;
+                el->value.int_value = (int)_encoders[i].value;
                 el->length = sizeof(uint32_t);
-                dupe_string(&(el->units), self->_encoders[i].units.c_str());
+                el->ingestTime = readTime;
+                generic_set_string(el, &(el->units), _encoders[i].units.c_str());
 
                 // enqueue the element
-                self->_enqueueCallback(self, (void *)el, self->_callbackArg);
+                _owner->traceLatency(LATENCY_STAGE_PARSE, el->ingestTime);
+                _enqueueCallback(this, (void *)el, _callbackArg);
                 // set previous to equal new
-                self->_encoders[i].previousEncoderValue = newEncoderValue;
+                _encoders[i].previousEncoderValue = newEncoderValue;
             }
         }
     }
-    // Finish processing the encoders
 
-    int retVal = PK_DigitalIOGet(self->_pokey);
+    return changed;
+}
 
-    if (retVal == PK_OK) {
-        self->_owner->pinRemappingMutex().lock();
+void PokeyDevice::emitPin(int i, const std::string &name, SymbolId symbol, bool value, int64_t readTime)
+{
+    GenericTLV *el = make_generic((const char *)"-", (const char *)"-");
 
-        for (int i = 0; i < self->_pokey->info.iPinCount; i++) {
-            GenericTLV *el = make_generic((const char *)"-", (const char *)"-");
+    el->ownerPlugin = _owner;
+    el->type = CONFIG_BOOL;
+    el->ingestTime = readTime;
+    el->length = sizeof(uint8_t);
+    generic_set_string(el, &(el->name), name.c_str());
+    el->symbol = symbol;
+    el->value.bool_value = value;
 
-            if (self->_pins[i].type == "DIGITAL_INPUT") {
-                int sourcePinNumber = self->_pins[i].pinNumber;
+    if (_pins[i].description.size() > 0) {
+        generic_set_string(el, &(el->description), _pins[i].description.c_str());
+    }
 
-                if (self->_pins[i].value != self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet && !self->_pins[i].skipNext) {
-                    // data has changed so send it off for processing
-                    printf("DIN pin-index %i - %i\n", sourcePinNumber - 1, self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet);
+    if (_pins[i].units.size() > 0) {
+        generic_set_string(el, &(el->units), _pins[i].units.c_str());
+    }
 
-                    el->ownerPlugin = self->_owner;
-                    el->type = CONFIG_BOOL;
-                    bool hackSkip = false;
-                    el->length = sizeof(uint8_t);
+    TransformId transformId = _owner->transformForPinName(_pins[i].pinName, _pins[i].symbol);
 
-                    if (self->_owner->pinRemapped(self->_pins[i].pinName)) {
-                        // KLUDGE: as each device has its own polling
-                        //         thread, the logic below is a
-                        //         critical section because it can
-                        //         touch the state of multiple device
-                        //         pins
+    if (transformId != TRANSFORM_NONE) {
+        TransformResult result;
 
-                        std::pair<std::shared_ptr<PokeyDevice>, std::string> remappedPinInfo = self->_owner->remappedPinDetails(self->_pins[i].pinName);
-                        int remappedPinIndex = remappedPinInfo.first->pinIndexFromName(remappedPinInfo.second);
+        // transformed in place, a label turns the pin's bool into a string
+        _owner->pinValueTransforms().apply(transformId, el->value.bool_value ? 1 : 0, result);
 
-                        // remappedPinInfo.first->pins()[remappedPinIndex].previousValue = self->_pins[self->_pins[i].pinNumber - 1].value;
-                        self->_pins[i].previousValue = self->_pins[self->_pins[i].pinNumber - 1].value;
+        if (result.label) {
+            el->type = CONFIG_STRING;
+            // the union still holds the bool, it is not a string to release
+            el->value.string_value = NULL;
+            generic_set_string(el, &(el->value.string_value), result.label);
+            el->length = result.labelLength;
+        }
+        else {
+            el->value.bool_value = result.number != 0;
+        }
 
-                        remappedPinInfo.first->_pins[remappedPinIndex].previousValue = self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet;
+        _owner->traceLatency(LATENCY_STAGE_PARSE, el->ingestTime);
 
-                        remappedPinInfo.first->_pins[remappedPinIndex].value = self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet;
-                        self->_pins[i].value = self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet;
+        printf("---> %s: %s\n", (char *)_pins[i].pinName.c_str(), result.label ? result.label : (el->value.bool_value ? "1" : "0"));
+        _enqueueCallback(this, (void *)el, _callbackArg);
+    }
+    else {
+        printf("---> %s\n", (char *)_pins[i].pinName.c_str());
+        _owner->traceLatency(LATENCY_STAGE_PARSE, el->ingestTime);
+        _enqueueCallback(this, (void *)el, _callbackArg);
+    }
+}
 
-                        dupe_string(&(el->name), remappedPinInfo.second.c_str());
-                        el->value.bool_value = self->_pokey->Pins[sourcePinNumber - 1].DigitalValueGet;
+void PokeyDevice::settleRemappedPins(int64_t now)
+{
+    size_t waiting = 0;
 
-                        if (el->value.bool_value == 0) {
-                            remappedPinInfo.first->_pins[remappedPinIndex].skipNext = true;
-                        }
-                        else {
-                            if (!remappedPinInfo.first->_pins[remappedPinIndex].skipNext) {
-                                self->_owner->pinRemappingMutex().unlock();
-                                std::this_thread::sleep_for(250ms);
-                                // give any other remapped polling
-                                // threads a chance to send a state
-                                // change
-                                if (remappedPinInfo.first->_pins[remappedPinIndex].skipNext) {
-                                    hackSkip = true;
-                                }
-                            }
-
-                            remappedPinInfo.first->_pins[remappedPinIndex].skipNext = false;
-                        }
+    for (size_t p = 0; p < _settlingPins.size(); p++) {
+        int i = _settlingPins[p].first;
+        int64_t readTime = _settlingPins[p].second;
 
-                        printf("--> remapping %s to  %s\n", self->_pins[i].pinName.c_str(), remappedPinInfo.first->pins()[remappedPinIndex].pinName.c_str());
-                    }
-                    else {
-                        dupe_string(&(el->name), self->_pins[i].pinName.c_str());
-                        el->value.bool_value = self->_pins[i].value;
-                        self->_pins[i].previousValue = self->_pins[i].value;
-                        self->_pins[i].value = self->_pokey->Pins[self->_pins[i].pinNumber - 1].DigitalValueGet;
-                    }
+        if (now - readTime < (int64_t)POKEY_REMAP_SETTLE_TIME * 1000000) {
+            _settlingPins[waiting++] = _settlingPins[p];
+            continue;
+        }
 
-                    if (hackSkip) {
-                        printf("HACKSKIP, %s, %i\n", self->_pins[i].pinName.c_str(), self->_pins[i].value);
-                        release_generic(el);
-                        self->_owner->pinRemappingMutex().unlock();
-                        return;
-                    }
+        std::pair<std::shared_ptr<PokeyDevice>, std::string> remappedPinInfo = _owner->remappedPinDetails(_pins[i].pinName);
+        int remappedPinIndex = remappedPinInfo.first->pinIndexFromName(remappedPinInfo.second);
+        int remappedPinNumber = remappedPinInfo.first->_pins[remappedPinIndex].pinNumber;
+        PokeyPinState &remappedPinState = remappedPinInfo.first->_pinState;
+        // another source of the remapped pin fell while this one settled
+        bool skip = remappedPinState.skipped(remappedPinNumber);
 
-                    if (self->_pins[i].description.size() > 0) {
-                        dupe_string(&(el->description), self->_pins[i].description.c_str());
-                    }
+        remappedPinState.setSkipped(remappedPinNumber, false);
 
-                    if (self->_pins[i].units.size() > 0) {
-                        dupe_string(&(el->units), self->_pins[i].units.c_str());
-                    }
+        if (skip) {
+            printf("HACKSKIP, %s, %i\n", _pins[i].pinName.c_str(), _pinState.value(_pins[i].pinNumber));
+            continue;
+        }
 
-                    std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(el);
-                    TransformFunction transformer = self->_owner->transformForPinName(self->_pins[i].pinName);
+        printf("--> remapping %s to  %s\n", _pins[i].pinName.c_str(), remappedPinInfo.first->pins()[remappedPinIndex].pinName.c_str());
+        emitPin(i, remappedPinInfo.second, remappedPinInfo.first->_pins[remappedPinIndex].symbol, true, readTime);
+    }
 
-                    if (transformer) {
-                        std::string transformedValue = transformer(attribute->valueToString(), "NULL", "NULL");
+    _settlingPins.resize(waiting);
+}
 
-                        attribute->setType(STRING_ATTRIBUTE);
-                        attribute->setValue(transformedValue);
-                        GenericTLV *transformedGeneric = AttributeToCGeneric(attribute);
+bool PokeyDevice::pollPins(void)
+{
+    int retVal = countError(PK_DigitalIOGet(_pokey));
+    // changes found in this scan are traced from when it completed
+    int64_t readTime = monotonic_nanos();
+    bool changed = false;
 
-                        printf("---> %s: %s\n", (char *)self->_pins[i].pinName.c_str(), transformedValue.c_str());
-                        self->_enqueueCallback(self, (void *)transformedGeneric, self->_callbackArg);
-                    }
-                    else {
-                        printf("---> %s\n", (char *)self->_pins[i].pinName.c_str());
-                        self->_enqueueCallback(self, (void *)el, self->_callbackArg);
-                    }
-                }
+    if (retVal == PK_OK) {
+        // remapped pins touch the pin state of other devices, whose pins are polled on other threads
+        std::lock_guard<std::mutex> lock(_owner->pinRemappingMutex());
+
+        settleRemappedPins(readTime);
+
+        _changedPins.clear();
+        changed = _pinState.diff(_pokey, _changedPins) > 0;
+
+        for (int i : _changedPins) {
+            int sourcePinNumber = _pins[i].pinNumber;
+
+            // a remapped pin handled earlier in this scan may already have updated this one
+            if (!_pinState.changed(sourcePinNumber, _pokey)) {
+                continue;
             }
-        }
 
-        // -- process all switch matrix
-        std::vector<GenericTLV *> matrixResult = self->_switchMatrixManager->readAll();
+            bool value = _pokey->Pins[sourcePinNumber - 1].DigitalValueGet;
 
-        for (auto &res : matrixResult) {
-            res->ownerPlugin = self->_owner;
-            self->_enqueueCallback(self, (void *)res, self->_callbackArg);
-        }
-        // -- end process all switch matrix
+            // data has changed so send it off for processing
+            printf("DIN pin-index %i - %i\n", sourcePinNumber - 1, (int)value);
+
+            if (_owner->pinRemapped(_pins[i].pinName)) {
+                std::pair<std::shared_ptr<PokeyDevice>, std::string> remappedPinInfo = _owner->remappedPinDetails(_pins[i].pinName);
+                int remappedPinIndex = remappedPinInfo.first->pinIndexFromName(remappedPinInfo.second);
+                int remappedPinNumber = remappedPinInfo.first->_pins[remappedPinIndex].pinNumber;
+                PokeyPinState &remappedPinState = remappedPinInfo.first->_pinState;
+
+                remappedPinState.setValue(remappedPinNumber, value);
+                _pinState.setValue(sourcePinNumber, value);
+
+                if (!value) {
+                    remappedPinState.setSkipped(remappedPinNumber, true);
+                }
+                else if (!remappedPinState.skipped(remappedPinNumber)) {
+                    // give the other sources of the remapped pin a chance to
+                    // fall first, the rise is reported by the first poll
+                    // POKEY_REMAP_SETTLE_TIME ms from now unless one did
+                    _settlingPins.push_back(std::make_pair(i, readTime));
+                    continue;
+                }
+                else {
+                    remappedPinState.setSkipped(remappedPinNumber, false);
+                }
 
-        self->_owner->pinRemappingMutex().unlock();
+                printf("--> remapping %s to  %s\n", _pins[i].pinName.c_str(), remappedPinInfo.first->pins()[remappedPinIndex].pinName.c_str());
+                emitPin(i, remappedPinInfo.second, remappedPinInfo.first->_pins[remappedPinIndex].symbol, value, readTime);
+            }
+            else {
+                bool reported = _pinState.value(sourcePinNumber);
+
+                _pinState.setValue(sourcePinNumber, value);
+                emitPin(i, _pins[i].pinName, _pins[i].symbol, reported, readTime);
+            }
+        }
     }
     else {
         if (retVal == PK_ERR_TRANSFER) {
@@ -296,6 +423,23 @@ void PokeyDevice::DigitalIOTimerCallback(uv_timer_t *timer, int status)
             printf("----> PK_ERR_PARAMETER %i\n\n", retVal);
         }
     }
+
+    return changed;
+}
+
+bool PokeyDevice::pollSwitchMatrix(void)
+{
+    std::vector<GenericTLV *> matrixResult = _switchMatrixManager->readAll();
+    int64_t readTime = monotonic_nanos();
+
+    for (auto &res : matrixResult) {
+        res->ownerPlugin = _owner;
+        res->ingestTime = readTime;
+        _owner->traceLatency(LATENCY_STAGE_PARSE, res->ingestTime);
+        _enqueueCallback(this, (void *)res, _callbackArg);
+    }
+
+    return !matrixResult.empty();
 }
 
 void PokeyDevice::addPin(int pinIndex, std::string pinName, int pinNumber, std::string pinType, int defaultValue, std::string description, bool invert)
@@ -308,26 +452,47 @@ void PokeyDevice::addPin(int pinIndex, std::string pinName, int pinNumber, std::
     mapNameToPin(pinName.c_str(), pinNumber);
 
     _pins[pinIndex].pinName = pinName;
+    _pins[pinIndex].symbol = _owner->symbolFor(pinName);
     _pins[pinIndex].pinIndex = pinIndex;
-    _pins[pinIndex].type = pinType.c_str();
+    _pins[pinIndex].type = PinTypeFromString(pinType);
     _pins[pinIndex].pinNumber = pinNumber;
     _pins[pinIndex].defaultValue = defaultValue;
-    _pins[pinIndex].value = defaultValue;
     _pins[pinIndex].description = description;
+
+    _pinState.configure(_pins, MAX_PINS);
 }
 
-void PokeyDevice::startPolling()
+void PokeyDevice::startPolling(PokeyScheduler &scheduler)
 {
-    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    if (!_pollable || _scheduler) {
+        return;
+    }
+
+    // functions with nothing configured are not polled, leaving the bandwidth to the others
+    bool configured[POLL_FUNCTION_COUNT] = {_pinState.inputPinCount() > 0, _encoderMap.size() > 0, !_switchMatrixManager->empty()};
+
+    _scheduler = &scheduler;
+
+    for (int i = 0; i < POLL_FUNCTION_COUNT; i++) {
+        PollFunction function = (PollFunction)i;
+
+        _pollRates[i].configure(_pollOptions.interval[i], _pollOptions.adaptive ? _pollOptions.activeInterval : 0, _pollOptions.activeHold);
+
+        if (configured[i]) {
+            scheduler.schedule(this, _pollOptions.startDelay, [this, function] { return poll(function); });
+        }
+    }
 }
 
 void PokeyDevice::stopPolling()
 {
-    assert(_pollLoop);
-    uv_stop(_pollLoop);
+    if (!_scheduler) {
+        return;
+    }
 
-    if (_pollThread->joinable())
-        _pollThread->join();
+    // waits for a poll that is running to return
+    _scheduler->cancel(this);
+    _scheduler = NULL;
 }
 
 /**
@@ -339,12 +504,6 @@ PokeyDevice::~PokeyDevice()
 {
     stopPolling();
 
-    if (_pollThread) {
-        if (_pollThread->joinable()) {
-            _pollThread->join();
-        }
-    }
-
     PK_DisconnectDevice(_pokey);
 }
 
@@ -465,6 +624,7 @@ void PokeyDevice::addEncoder(
     }
 
     _encoders[encoderIndex].name = name;
+    _encoders[encoderIndex].symbol = _owner->symbolFor(name);
     _encoders[encoderIndex].number = encoderNumber;
     _encoders[encoderIndex].defaultValue = defaultValue;
     _encoders[encoderIndex].value = defaultValue;
@@ -540,22 +700,25 @@ void PokeyDevice::addLedToLedMatrix(int ledMatrixIndex, uint8_t ledIndex, std::s
     _pokeyMax7219Manager->addLedToMatrix(ledMatrixIndex, ledIndex, name, description, enabled, row, col);
 }
 
-uint32_t PokeyDevice::targetValue(std::string targetName, int value)
+uint32_t PokeyDevice::targetValue(std::string targetName, int value, SymbolId symbol)
 {
-    uint8_t displayNum = displayFromName(targetName);
+    uint8_t displayNum = displayFromName(targetName, symbol);
+    std::lock_guard<std::mutex> lock(_pokeyMutex);
+
     displayNumber(displayNum, targetName, value);
     return 0;
 }
 
-uint32_t PokeyDevice::targetValue(std::string targetName, bool value)
+uint32_t PokeyDevice::targetValue(std::string targetName, bool value, SymbolId symbol)
 {
     uint32_t retValue = PK_OK;
     uint32_t result = PK_OK;
 
-    uint8_t pin = pinFromName(targetName) - 1;
+    uint8_t pin = pinFromName(targetName, symbol) - 1;
+    std::lock_guard<std::mutex> lock(_pokeyMutex);
 
     if (pin >= 0 && pin <= 55) {
-        result = PK_DigitalIOSetSingle(_pokey, pin, value);
+        result = countError(PK_DigitalIOSetSingle(_pokey, pin, value));
     }
     else {
         // we have output matrix - so deliver there
@@ -626,7 +789,7 @@ uint8_t PokeyDevice::displayNumber(uint8_t displayNumber, std::string targetName
 
     _pokey->MatrixLED[displayNumber].RefreshFlag = 1;
 
-    int retValue = PK_MatrixLEDUpdate(_pokey);
+    int retValue = countError(PK_MatrixLEDUpdate(_pokey));
 
     if (retValue == PK_ERR_TRANSFER) {
         printf("----> PK_ERR_TRANSFER %i\n\n", retValue);
@@ -657,7 +820,7 @@ int PokeyDevice::configSwitchMatrixSwitch(int switchMatrixId, int switchId, std:
     return 0;
 }
 
-int PokeyDevice::configSwitchMatrixVirtualPin(int switchMatrixId, std::string name, bool invert, PinMaskMap &virtualPinMask, std::map<int, std::string> &valueTransforms)
+int PokeyDevice::configSwitchMatrixVirtualPin(int switchMatrixId, std::string name, bool invert, PinMaskMap &virtualPinMask, const TransformChain &valueTransforms)
 {
     std::shared_ptr<PokeySwitchMatrix> matrix = _switchMatrixManager->matrix(switchMatrixId);
     matrix->addVirtualPin(name, invert, virtualPinMask, valueTransforms);
@@ -694,8 +857,14 @@ int32_t PokeyDevice::name(std::string name)
     return PK_DeviceNameSet(_pokey);
 }
 
-uint8_t PokeyDevice::displayFromName(std::string targetName)
+uint8_t PokeyDevice::displayFromName(std::string targetName, SymbolId symbol)
 {
+    int *display = _displayBySymbol.find(symbol);
+
+    if (display) {
+        return *display;
+    }
+
     std::map<std::string, int>::iterator it;
     it = _displayMap.find(targetName);
 
@@ -719,8 +888,14 @@ int PokeyDevice::pinIndexFromName(std::string targetName)
     return -1;
 }
 
-int PokeyDevice::pinFromName(std::string targetName)
+int PokeyDevice::pinFromName(std::string targetName, SymbolId symbol)
 {
+    int *pin = _pinBySymbol.find(symbol);
+
+    if (pin) {
+        return *pin;
+    }
+
     std::map<std::string, int>::iterator it;
     it = _pinMap.find(targetName);
 
@@ -733,7 +908,11 @@ int PokeyDevice::pinFromName(std::string targetName)
 
 void PokeyDevice::mapNameToPin(std::string name, int pin)
 {
-    _pinMap.emplace(name, pin);
+    SymbolId symbol = _owner->symbolFor(name);
+
+    if (_pinMap.emplace(name, pin).second) {
+        _pinBySymbol.set(symbol, pin);
+    }
 }
 
 void PokeyDevice::mapNameToEncoder(std::string name, int encoderNumber)
@@ -743,7 +922,11 @@ void PokeyDevice::mapNameToEncoder(std::string name, int encoderNumber)
 
 void PokeyDevice::mapNameToMatrixLED(std::string name, int id)
 {
-    _displayMap.emplace(name, id);
+    SymbolId symbol = _owner->symbolFor(name);
+
+    if (_displayMap.emplace(name, id).second) {
+        _displayBySymbol.set(symbol, id);
+    }
 }
 
 bool PokeyDevice::isPinDigitalOutput(uint8_t pin)
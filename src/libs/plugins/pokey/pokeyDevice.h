@@ -2,20 +2,23 @@
 #define __POKEYDEVICE_H
 
 #include "PoKeysLib.h"
+#include "common/metrics.h"
 #include "common/simhubdeviceplugin.h"
+#include "common/symboltable.h"
 #include "drivers/PokeyMAX7219Manager/PokeyMAX7219Manager.h"
 #include "drivers/PokeySwitchMatrixManager/PokeySwitchMatrixManager.h"
+#include "pokeyPinState.h"
+#include "pokeyPollRate.h"
+#include "pokeyScheduler.h"
 #include <assert.h>
 #include <cmath>
 #include <iostream>
 #include <map>
+#include <mutex>
 #include <stdlib.h>
 #include <thread>
 #include <unistd.h>
-#include <uv.h>
 
-#define DEVICE_READ_INTERVAL 100
-#define DEVICE_START_DELAY 1000
 #define ENCODER_1 1
 #define ENCODER_2 2
 #define ENCODER_3 3
@@ -34,22 +37,12 @@
 #define MAX_SWITCH_MATRIX 10
 #define MAX_SWITCH_MATRIX_SWITCHES 256
 #define MAX_MATRIX 1
-
-typedef struct {
-    std::string pinName;
-    int pinNumber;
-    int pinIndex;
-    std::string type;
-    std::string description;
-    std::string units;
-    uint8_t defaultValue;
-    uint8_t value;
-    uint8_t previousValue;
-    bool skipNext;
-} device_port_t;
+//! ms a rising remapped pin waits for the pin's other sources before it is reported
+#define POKEY_REMAP_SETTLE_TIME 250
 
 typedef struct {
     std::string name;
+    SymbolId symbol;
     int number;
     std::string description;
     std::string units;
@@ -105,7 +98,6 @@ class PokeyDevicePluginStateManager;
 class PokeyDevice
 {
 private:
-    static void DigitalIOTimerCallback(uv_timer_t *timer, int status);
 
 protected:
     uint8_t _index;
@@ -125,13 +117,21 @@ protected:
     std::map<std::string, int> _pwmMap;
     std::map<std::string, int> _ledMatrix;
 
+    //! symbol indexed copies of _pinMap and _displayMap for value delivery
+    SymbolIndex<int> _pinBySymbol;
+    SymbolIndex<int> _displayBySymbol;
+
     PokeyDevicePluginStateManager *_owner;
     std::shared_ptr<PokeyMAX7219Manager> _pokeyMax7219Manager;
 
     sPoKeysDevice *_pokey;
+    std::mutex _pokeyMutex; ///< held by every poll and value write, PoKeysLib shares one request buffer per device
     void *_callbackArg;
     SPHANDLE _pluginInstance;
     device_port_t _pins[MAX_PINS];
+    PokeyPinState _pinState;
+    std::vector<int> _changedPins; ///< scratch for the poll callback
+    std::vector<std::pair<int, int64_t>> _settlingPins; ///< pin table index and read time (ns) of risen remapped pins not yet reported - pins poll only
     device_pwm_t _pwm[MAX_PWM_CHANNELS];
     device_encoder_t _encoders[MAX_ENCODERS];
     device_matrixLED_t _matrixLED[MAX_MATRIX_LEDS];
@@ -139,22 +139,44 @@ protected:
 
     EnqueueEventHandler _enqueueCallback;
 
-    std::shared_ptr<std::thread> _pollThread;
-    uv_loop_t *_pollLoop;
-    uv_timer_t _pollTimer;
+    PokeyScheduler *_scheduler; ///< runs the polls, NULL while not polling
+    bool _pollable; ///< false if the pins could not be reset, the device is never polled
+    PollRate _pollRates[POLL_FUNCTION_COUNT];
+    PollOptions _pollOptions;
+    int64_t _lastChange; ///< ns, the latest change any poll found - polls only
 
-    int pinFromName(std::string targetName);
+    int pinFromName(std::string targetName, SymbolId symbol = SYMBOL_UNRESOLVED);
     bool makeAllPinsInactive(); // disable all pins
     int pinIndexFromName(std::string targetName);
-    uint8_t displayFromName(std::string targetName);
+    uint8_t displayFromName(std::string targetName, SymbolId symbol = SYMBOL_UNRESOLVED);
     uint8_t displayNumber(uint8_t displayNumwber, std::string targetName, int value);
     void processPokeyPhysicalInputPin(int i);
     void processEncoderInputValues(void);
     void processMatrixInputValues(void);
-    void pollCallback(uv_timer_t *timer, int status);
 
     std::shared_ptr<PokeySwitchMatrixManager> _switchMatrixManager;
 
+    //! PoKeys errors by return code, served on the core's /metrics
+    std::map<int, MetricCounter *> _errorCounters;
+    HdrHistogram *_pollDuration[POLL_FUNCTION_COUNT];
+    HdrHistogram *_pollInterval[POLL_FUNCTION_COUNT];
+
+    void registerMetrics(void);
+    //! one scheduled poll of function, returns the ms until the next one
+    unsigned int poll(PollFunction function);
+    //! each returns true if it found a change
+    bool pollPins(void);
+    bool pollEncoders(void);
+    bool pollSwitchMatrix(void);
+    //! reports the settled rises in _settlingPins, under the pin remapping mutex
+    void settleRemappedPins(int64_t now);
+    //! hands the value of pin table entry i, reported as name, to the core
+    void emitPin(int i, const std::string &name, SymbolId symbol, bool value, int64_t readTime);
+    //! records a poll of function that found a change or not, returns the ms until the next one
+    unsigned int endPoll(PollFunction function, int64_t pollStart, bool changed);
+    //! counts result against its error code if it is one, returns result
+    int countError(int result);
+
 public:
     PokeyDevice(PokeyDevicePluginStateManager *owner, sPoKeysNetworkDeviceSummary, uint8_t);
     virtual ~PokeyDevice(void);
@@ -166,8 +188,8 @@ public:
     void mapNameToEncoder(std::string name, int encoderNumber);
     void mapNameToMatrixLED(std::string name, int id);
 
-    uint32_t targetValue(std::string targetName, bool value);
-    uint32_t targetValue(std::string targetName, int value);
+    uint32_t targetValue(std::string targetName, bool value, SymbolId symbol = SYMBOL_UNRESOLVED);
+    uint32_t targetValue(std::string targetName, int value, SymbolId symbol = SYMBOL_UNRESOLVED);
     uint32_t inputPin(uint8_t pin, bool invert = false);
     uint32_t outputPin(uint8_t pin);
     uint32_t inactivePin(uint8_t pin); // make a pin inactive
@@ -217,13 +239,19 @@ public:
     // switch matrix "handlers"
     int configSwitchMatrix(int id, std::string name, std::string type, bool enabled);
     int configSwitchMatrixSwitch(int switchMatrixId, int switchId, std::string name, int pin, int enablePin, bool invert, bool invertEnablePin);
-    int configSwitchMatrixVirtualPin(int switchMatrixId, std::string name, bool invert, PinMaskMap &virtualPinMask, std::map<int, std::string> &valueTransforms);
+    int configSwitchMatrixVirtualPin(int switchMatrixId, std::string name, bool invert, PinMaskMap &virtualPinMask, const TransformChain &valueTransforms);
 
     // led matrix "handlers"
     void configMatrix(int id, uint8_t chipSelect, std::string type, uint8_t enabled = 0, std::string name = "", std::string description = "");
     void addLedToLedMatrix(int ledMatrixIndex, uint8_t ledIndex, std::string name, std::string description, uint8_t enabled, uint8_t row, uint8_t col);
 
-    void startPolling();
+    //! only before startPolling()
+    void setPollOptions(const PollOptions &options) { _pollOptions = options; };
+    const PollOptions &pollOptions(void) const { return _pollOptions; };
+    const PollRate &pollRate(PollFunction function) const { return _pollRates[function]; };
+
+    //! schedules a poll of every function with something to poll on scheduler
+    void startPolling(PokeyScheduler &scheduler);
     void stopPolling();
     std::string name();
 };
@@ -0,0 +1,180 @@
+#ifndef __POKEYPINSTATE_H
+#define __POKEYPINSTATE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "PoKeysLib.h"
+#include "common/symboltable.h"
+
+//! one bit per pin, bit n is pin number n + 1 - every PoKeys model has fewer than 64 pins
+#define POKEY_PIN_BITS 64
+
+typedef enum { PIN_TYPE_NONE = 0, PIN_TYPE_DIGITAL_INPUT, PIN_TYPE_DIGITAL_OUTPUT } PinType;
+
+//! resolves a configured pin type once, at configuration time
+inline PinType PinTypeFromString(const std::string &type)
+{
+    if (type == "DIGITAL_INPUT") {
+        return PIN_TYPE_DIGITAL_INPUT;
+    }
+    else if (type == "DIGITAL_OUTPUT") {
+        return PIN_TYPE_DIGITAL_OUTPUT;
+    }
+
+    return PIN_TYPE_NONE;
+}
+
+//! the value and skip state of a pin live in PokeyPinState
+typedef struct {
+    std::string pinName;
+    SymbolId symbol;
+    int pinNumber;
+    int pinIndex;
+    PinType type;
+    std::string description;
+    std::string units;
+    uint8_t defaultValue;
+} device_port_t;
+
+/**
+ * Finds the digital input pins whose state on the device differs from
+ * the value last reported for them - the per poll diff of a PokeyDevice,
+ * kept apart from the device so it can be exercised against an in
+ * memory sPoKeysDevice
+ *
+ * - inputs, last reported values and pins to skip are each packed in
+ *   a 64 bit mask indexed by pin number
+ * - a poll packs the device's inputs into one more mask, the changes
+ *   are (sampled ^ reported) & inputs & ~skipped and only set bits are
+ *   visited, a poll without changes touches no pin entry
+ * - inverted inputs are inverted by the device (PK_PinCap_invertPin),
+ *   DigitalValueGet already reads the inverted state
+ */
+class PokeyPinState
+{
+protected:
+    uint64_t _inputMask;
+    uint64_t _reported; ///< last reported value of every pin
+    uint64_t _skipped; ///< pins whose next change is not reported
+    int _indexByBit[POKEY_PIN_BITS]; ///< pin table index of every input bit
+
+    static bool Valid(int pinNumber) { return pinNumber >= 1 && pinNumber <= POKEY_PIN_BITS; }
+    static uint64_t Bit(int pinNumber) { return (uint64_t)1 << (pinNumber - 1); }
+
+public:
+    PokeyPinState(void)
+        : _inputMask(0)
+        , _reported(0)
+        , _skipped(0)
+    {
+        for (int i = 0; i < POKEY_PIN_BITS; i++) {
+            _indexByBit[i] = -1;
+        }
+    };
+
+    /**
+     * rebuilds the masks from the pin table, every pin starts out at its
+     * default value - call whenever the pin table changes
+     */
+    void configure(const device_port_t *pins, int pinCount)
+    {
+        _inputMask = 0;
+        _reported = 0;
+        _skipped = 0;
+
+        for (int i = 0; i < POKEY_PIN_BITS; i++) {
+            _indexByBit[i] = -1;
+        }
+
+        for (int i = 0; i < pinCount; i++) {
+            // entries addPin has not filled in are left uninitialised
+            if (pins[i].pinName.empty() || !Valid(pins[i].pinNumber)) {
+                continue;
+            }
+
+            if (pins[i].defaultValue) {
+                _reported |= Bit(pins[i].pinNumber);
+            }
+
+            if (pins[i].type == PIN_TYPE_DIGITAL_INPUT) {
+                _inputMask |= Bit(pins[i].pinNumber);
+                _indexByBit[pins[i].pinNumber - 1] = i;
+            }
+        }
+    }
+
+    //! packs the device state of every input pin into a mask
+    uint64_t sample(const sPoKeysDevice *device) const
+    {
+        uint64_t retVal = 0;
+        uint64_t inputs = _inputMask;
+
+        if (device->info.iPinCount < POKEY_PIN_BITS) {
+            inputs &= ((uint64_t)1 << device->info.iPinCount) - 1;
+        }
+
+        while (inputs) {
+            int bit = __builtin_ctzll(inputs);
+
+            retVal |= (uint64_t)(device->Pins[bit].DigitalValueGet != 0) << bit;
+            inputs &= inputs - 1;
+        }
+
+        return retVal;
+    }
+
+    //! input pins in sampled that differ from their reported value and are not being skipped
+    uint64_t changes(uint64_t sampled) const { return (sampled ^ _reported) & _inputMask & ~_skipped; }
+
+    /**
+     * appends to changed the pin table index of every input pin whose
+     * device state differs from its reported value (and is not being
+     * skipped)
+     *
+     * @return size_t the number of changed pins
+     */
+    size_t diff(const sPoKeysDevice *device, std::vector<int> &changed) const
+    {
+        size_t retVal = 0;
+        uint64_t flipped = changes(sample(device));
+
+        while (flipped) {
+            changed.push_back(_indexByBit[__builtin_ctzll(flipped)]);
+            flipped &= flipped - 1;
+            retVal++;
+        }
+
+        return retVal;
+    }
+
+    //! true if the pin's state on device differs from its reported value and it is not being skipped
+    bool changed(int pinNumber, const sPoKeysDevice *device) const
+    {
+        return Valid(pinNumber) && (device->Pins[pinNumber - 1].DigitalValueGet != 0) != value(pinNumber) && !skipped(pinNumber);
+    }
+
+    bool value(int pinNumber) const { return Valid(pinNumber) && (_reported & Bit(pinNumber)); }
+
+    void setValue(int pinNumber, bool value)
+    {
+        if (Valid(pinNumber)) {
+            _reported = value ? (_reported | Bit(pinNumber)) : (_reported & ~Bit(pinNumber));
+        }
+    }
+
+    bool skipped(int pinNumber) const { return Valid(pinNumber) && (_skipped & Bit(pinNumber)); }
+
+    void setSkipped(int pinNumber, bool skip)
+    {
+        if (Valid(pinNumber)) {
+            _skipped = skip ? (_skipped | Bit(pinNumber)) : (_skipped & ~Bit(pinNumber));
+        }
+    }
+
+    uint64_t inputMask(void) const { return _inputMask; }
+    size_t inputPinCount(void) const { return (size_t)__builtin_popcountll(_inputMask); }
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __POKEYPOLLRATE_H
+#define __POKEYPOLLRATE_H
+
+#include <algorithm>
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define POLL_DEFAULT_START_DELAY 1000
+#define POLL_DEFAULT_INTERVAL 100
+#define POLL_DEFAULT_ACTIVE_INTERVAL 10
+#define POLL_DEFAULT_ACTIVE_HOLD 3000
+//! weight of a new sample in the interval and jitter averages is 1 / POLL_AVERAGE_WEIGHT
+#define POLL_AVERAGE_WEIGHT 16
+
+//! the functions of a device that are polled on their own timers
+typedef enum { POLL_PINS = 0, POLL_ENCODERS, POLL_SWITCH_MATRIX, POLL_FUNCTION_COUNT } PollFunction;
+
+inline const char *PollFunctionName(PollFunction function)
+{
+    static const char *names[] = {"pins", "encoders", "switchMatrix"};
+    return function < POLL_FUNCTION_COUNT ? names[function] : "unknown";
+}
+
+//! per device poll rates, the polling group of a device in pokey.cfg
+struct PollOptions {
+    unsigned int startDelay; ///< ms before the first poll
+    unsigned int interval[POLL_FUNCTION_COUNT]; ///< ms between polls while the device is idle
+    bool adaptive; ///< poll at activeInterval for activeHold ms after any change on the device
+    unsigned int activeInterval; ///< ms
+    unsigned int activeHold; ///< ms
+
+    PollOptions(void)
+        : startDelay(POLL_DEFAULT_START_DELAY)
+        , adaptive(false)
+        , activeInterval(POLL_DEFAULT_ACTIVE_INTERVAL)
+        , activeHold(POLL_DEFAULT_ACTIVE_HOLD)
+    {
+        std::fill(interval, interval + POLL_FUNCTION_COUNT, POLL_DEFAULT_INTERVAL);
+    };
+};
+
+/**
+ * Paces one polled function of a device and measures the rate it
+ * actually achieves
+ *
+ * - polled() is called by the poll at its start and returns the ms
+ *   until the next one, the active interval while the device changed
+ *   within the hold time, the idle interval otherwise
+ * - the achieved interval and its deviation from the interval that was
+ *   asked for are kept as moving averages, readable from any thread
+ */
+class PollRate
+{
+protected:
+    unsigned int _idleInterval;
+    unsigned int _activeInterval; ///< 0 when not adaptive
+    int64_t _activeHold; ///< ns
+    std::atomic<unsigned int> _target; ///< ms asked for by the previous poll, read by the metrics scrape
+    int64_t _lastPoll; ///< ns, 0 before the first poll - poll thread only
+    std::atomic<uint64_t> _polls;
+    std::atomic<int64_t> _meanInterval; ///< ns
+    std::atomic<int64_t> _jitter; ///< ns
+
+    static int64_t Average(int64_t average, int64_t sample) { return average + (sample - average) / POLL_AVERAGE_WEIGHT; }
+
+public:
+    PollRate(void)
+        : _target(0)
+        , _polls(0)
+        , _meanInterval(0)
+        , _jitter(0)
+    {
+        configure(POLL_DEFAULT_INTERVAL);
+    };
+
+    //! activeInterval 0 polls at idleInterval regardless of changes
+    void configure(unsigned int idleInterval, unsigned int activeInterval = 0, unsigned int activeHold = POLL_DEFAULT_ACTIVE_HOLD)
+    {
+        _idleInterval = std::max(idleInterval, 1u);
+        _activeInterval = activeInterval ? std::min(activeInterval, _idleInterval) : 0;
+        _activeHold = (int64_t)activeHold * 1000000;
+        _target.store(_idleInterval, std::memory_order_relaxed);
+        _lastPoll = 0;
+    }
+
+    //! true while a change at lastChange (ns, 0 for none) keeps the function at its active interval
+    bool active(int64_t now, int64_t lastChange) const { return _activeInterval && lastChange && now - lastChange < _activeHold; }
+
+    //! ms between polls at now
+    unsigned int interval(int64_t now, int64_t lastChange) const { return active(now, lastChange) ? _activeInterval : _idleInterval; }
+
+    /**
+     * records a poll starting at now (ns)
+     *
+     * @return unsigned int ms until the next poll
+     */
+    unsigned int polled(int64_t now, int64_t lastChange)
+    {
+        if (_lastPoll) {
+            int64_t elapsed = now - _lastPoll;
+            int64_t deviation = llabs(elapsed - (int64_t)_target.load(std::memory_order_relaxed) * 1000000);
+
+            if (_meanInterval == 0) {
+                _meanInterval = elapsed;
+                _jitter = deviation;
+            }
+            else {
+                _meanInterval = Average(_meanInterval, elapsed);
+                _jitter = Average(_jitter, deviation);
+            }
+        }
+
+        _polls++;
+        _lastPoll = now;
+        unsigned int retVal = interval(now, lastChange);
+        _target.store(retVal, std::memory_order_relaxed);
+
+        return retVal;
+    }
+
+    uint64_t polls(void) const { return _polls; }
+    //! ns, start of the latest poll - poll thread only
+    int64_t lastPoll(void) const { return _lastPoll; }
+    //! ms asked for by the latest poll
+    unsigned int target(void) const { return _target.load(std::memory_order_relaxed); }
+    //! achieved polls per second, 0 until two polls have run
+    double frequency(void) const { return _meanInterval > 0 ? 1e9 / (double)_meanInterval : 0; }
+    //! seconds the achieved interval is off its target on average
+    double jitter(void) const { return (double)_jitter / 1e9; }
+};
+
+#endif
@@ -0,0 +1,256 @@
+#ifndef __POKEYSCHEDULER_H
+#define __POKEYSCHEDULER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+#define POKEY_SCHEDULER_DEFAULT_THREADS 2
+
+/**
+ * a poll of one function of a device, returns the ms until it is due
+ * again
+ */
+typedef std::function<unsigned int(void)> PokeyPollTask;
+
+/**
+ * Runs the polls of every Pokey device on one fixed pool of threads
+ *
+ * - polls wait in a heap ordered by deadline, a worker sleeps until
+ *   the earliest one is due and reschedules it with the delay it
+ *   returns
+ * - the tasks of one owner (a device) never run at the same time, a
+ *   PoKeys device handle is not safe to share between threads - a due
+ *   task whose owner is busy waits until the owner's running task ends.
+ *   Anything else using the handle, such as value writes, has to
+ *   exclude the polls itself (PokeyDevice::_pokeyMutex)
+ * - PoKeysLib requests block until the device answers, so the number
+ *   of threads bounds how many devices are talking at once rather than
+ *   following the number of devices
+ */
+class PokeyScheduler
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+protected:
+    struct Task {
+        const void *owner;
+        PokeyPollTask poll;
+    };
+
+    struct Deadline {
+        Clock::time_point due;
+        uint64_t sequence; ///< orders equal deadlines first come first served
+        uint64_t task;
+
+        //! std heap functions build a max heap, the earliest deadline has to compare greatest
+        bool operator<(const Deadline &other) const { return due != other.due ? due > other.due : sequence > other.sequence; }
+    };
+
+    std::mutex _mutex;
+    std::condition_variable _wakeup; ///< heap changed or stopping
+    std::condition_variable _idle; ///< an owner's task finished
+    std::vector<Deadline> _heap;
+    std::map<uint64_t, Task> _tasks;
+    std::set<const void *> _busy; ///< owners with a task running
+    std::map<const void *, std::vector<Deadline>> _deferred; ///< due tasks of busy owners
+    std::vector<std::thread> _workers;
+    uint64_t _nextTask;
+    uint64_t _sequence;
+    bool _running;
+    std::atomic<uint64_t> _runs;
+    std::atomic<uint64_t> _deferrals;
+
+    void push(Clock::time_point due, uint64_t task)
+    {
+        _heap.push_back(Deadline{due, _sequence++, task});
+        std::push_heap(_heap.begin(), _heap.end());
+    }
+
+    void work(void)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        while (_running) {
+            if (_heap.empty()) {
+                _wakeup.wait(lock);
+                continue;
+            }
+
+            if (_heap.front().due > Clock::now()) {
+                _wakeup.wait_until(lock, _heap.front().due);
+                continue;
+            }
+
+            std::pop_heap(_heap.begin(), _heap.end());
+            Deadline deadline = _heap.back();
+            _heap.pop_back();
+
+            std::map<uint64_t, Task>::iterator task = _tasks.find(deadline.task);
+
+            // cancelled
+            if (task == _tasks.end()) {
+                continue;
+            }
+
+            const void *owner = task->second.owner;
+
+            if (_busy.count(owner)) {
+                _deferred[owner].push_back(deadline);
+                _deferrals++;
+                continue;
+            }
+
+            _busy.insert(owner);
+            // cancel() waits for the owner to be idle, so the task outlives the unlocked poll
+            PokeyPollTask &poll = task->second.poll;
+
+            lock.unlock();
+            unsigned int delay = poll();
+            lock.lock();
+
+            _runs++;
+            _busy.erase(owner);
+
+            if (_tasks.count(deadline.task)) {
+                push(Clock::now() + std::chrono::milliseconds(delay), deadline.task);
+            }
+
+            std::map<const void *, std::vector<Deadline>>::iterator deferred = _deferred.find(owner);
+
+            if (deferred != _deferred.end()) {
+                for (Deadline &waiting : deferred->second) {
+                    push(waiting.due, waiting.task);
+                }
+
+                _deferred.erase(deferred);
+            }
+
+            _idle.notify_all();
+            _wakeup.notify_all();
+        }
+    }
+
+public:
+    PokeyScheduler(void)
+        : _nextTask(0)
+        , _sequence(0)
+        , _running(false)
+        , _runs(0)
+        , _deferrals(0){};
+
+    virtual ~PokeyScheduler(void) { stop(); };
+
+    //! starts threads workers, does nothing if already running
+    void start(size_t threads = POKEY_SCHEDULER_DEFAULT_THREADS)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_running) {
+            return;
+        }
+
+        _running = true;
+
+        for (size_t i = 0; i < std::max<size_t>(threads, 1); i++) {
+            _workers.push_back(std::thread(&PokeyScheduler::work, this));
+        }
+    }
+
+    //! joins the workers once their running polls return, scheduled tasks are kept
+    void stop(void)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _running = false;
+        }
+
+        _wakeup.notify_all();
+
+        for (std::thread &worker : _workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+
+        _workers.clear();
+    }
+
+    //! runs poll for owner in delay ms, and from then on after the delay each run returns
+    void schedule(const void *owner, unsigned int delay, PokeyPollTask poll)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        uint64_t task = _nextTask++;
+
+        _tasks[task] = Task{owner, poll};
+        push(Clock::now() + std::chrono::milliseconds(delay), task);
+        _wakeup.notify_one();
+    }
+
+    //! brings every task of owner due later than delay ms from now forward to then
+    void expedite(const void *owner, unsigned int delay)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Clock::time_point due = Clock::now() + std::chrono::milliseconds(delay);
+        bool moved = false;
+
+        for (Deadline &deadline : _heap) {
+            std::map<uint64_t, Task>::iterator task = _tasks.find(deadline.task);
+
+            if (task != _tasks.end() && task->second.owner == owner && deadline.due > due) {
+                deadline.due = due;
+                moved = true;
+            }
+        }
+
+        if (moved) {
+            std::make_heap(_heap.begin(), _heap.end());
+            _wakeup.notify_one();
+        }
+    }
+
+    /**
+     * removes every task of owner, waiting for a running one to return -
+     * not from one of owner's own polls
+     */
+    void cancel(const void *owner)
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+
+        _idle.wait(lock, [this, owner] { return !_busy.count(owner); });
+
+        for (std::map<uint64_t, Task>::iterator task = _tasks.begin(); task != _tasks.end();) {
+            task = task->second.owner == owner ? _tasks.erase(task) : std::next(task);
+        }
+
+        _deferred.erase(owner);
+    }
+
+    size_t threads(void)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _workers.size();
+    }
+
+    size_t tasks(void)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _tasks.size();
+    }
+
+    //! polls run so far
+    uint64_t runs(void) const { return _runs; }
+    //! due polls that had to wait for another poll of the same owner
+    uint64_t deferrals(void) const { return _deferrals; }
+};
+
+#endif
@@ -6,7 +6,6 @@
 #include <thread>
 
 #include "common/simhubdeviceplugin.h"
-#include "elements/attributes/attribute.h"
 #include "main.h"
 
 using namespace std::chrono_literals;
@@ -20,6 +19,21 @@ int simplug_init(SPHANDLE *plugin_instance, LoggingFunctionCB logger)
     return 0;
 }
 
+int simplug_bind_symbol_table(SPHANDLE plugin_instance, void *symbol_table)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindSymbolTable(static_cast<SymbolTable *>(symbol_table));
+}
+
+int simplug_bind_latency_tracer(SPHANDLE plugin_instance, void *latency_tracer)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindLatencyTracer(static_cast<LatencyTracer *>(latency_tracer));
+}
+
+int simplug_bind_metrics(SPHANDLE plugin_instance, void *metrics)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->bindMetrics(static_cast<MetricsRegistry *>(metrics));
+}
+
 int simplug_config_passthrough(SPHANDLE plugin_instance, void *libconfig_instance)
 {
     return static_cast<PluginStateManager *>(plugin_instance)->configPassthrough(static_cast<libconfig::Config *>(libconfig_instance));
@@ -40,6 +54,11 @@ int simplug_deliver_value(SPHANDLE plugin_instance, GenericTLV *value)
     return static_cast<PluginStateManager *>(plugin_instance)->deliverValue(value);
 }
 
+int simplug_deliver_values(SPHANDLE plugin_instance, GenericTLV **values, int count)
+{
+    return static_cast<PluginStateManager *>(plugin_instance)->deliverValues(values, count);
+}
+
 void simplug_cease_eventing(SPHANDLE plugin_instance)
 {
     static_cast<PluginStateManager *>(plugin_instance)->ceaseEventing();
@@ -58,7 +77,10 @@ SimSourcePluginStateManager *SimSourcePluginStateManager::_StateManagerInstance
 
 void SimSourcePluginStateManager::AllocBuffer(uv_handle_t *handle, size_t size, uv_buf_t *buf)
 {
-    *buf = SimSourcePluginStateManager::StateManagerInstance()->_readBuffer;
+    LineFramer &framer = SimSourcePluginStateManager::StateManagerInstance()->_framer;
+
+    // reads go straight into the framer behind any partial line
+    *buf = uv_buf_init(framer.writeSpace(), framer.writeSpaceSize());
 }
 
 //! static getter for singleton instance of our class
@@ -69,6 +91,11 @@ SimSourcePluginStateManager *SimSourcePluginStateManager::StateManagerInstance(v
 
 SimSourcePluginStateManager::SimSourcePluginStateManager(LoggingFunctionCB logger)
     : PluginStateManager(logger)
+    , _eventLoop(NULL)
+    , _connectionState(SIM_DISCONNECTED)
+    , _stopping(false)
+    , _everConnected(false)
+    , _framer(PREPARE3D_FRAME_CAPACITY)
 {
     // enforce singleton pre-condition
 
@@ -76,13 +103,14 @@ SimSourcePluginStateManager::SimSourcePluginStateManager(LoggingFunctionCB logge
 
     _StateManagerInstance = this;
     _processedElementCount = 0;
+    _readTime = 0;
     _name = "prepar3d";
+    _malformedValues = &metrics().counter("simhub_prepare3d_malformed_values_total", "ProSim values rejected as malformed");
+    _reconnects = &metrics().counter("simhub_prepare3d_reconnects_total", "Connections to ProSim re-established after a loss");
+    _connectFailures = &metrics().counter("simhub_prepare3d_connect_failures_total", "Failed attempts to connect to ProSim");
 
-    if (!(_rawBuffer = (char *)malloc(BUFFER_LEN))) {
-        printf("Unable to allocate buffer of size %d", BUFFER_LEN);
-    }
-    else {
-        _readBuffer = ::uv_buf_init(_rawBuffer, BUFFER_LEN);
+    if (!_framer.capacity()) {
+        printf("Unable to allocate buffer of size %d", PREPARE3D_FRAME_CAPACITY);
     }
 }
 
@@ -90,10 +118,6 @@ SimSourcePluginStateManager::~SimSourcePluginStateManager(void)
 {
     ceaseEventing();
 
-    if (_rawBuffer != NULL) {
-        free(_rawBuffer);
-    }
-
     _StateManagerInstance = NULL;
 }
 
@@ -131,35 +155,196 @@ int SimSourcePluginStateManager::preflightComplete(void)
         if (iter->exists("transforms")) {
             loadTransforms(&iter->lookup("transforms"));
         }
+
+        if (iter->exists("types")) {
+            loadTypes(&iter->lookup("types"));
+        }
+
+        if (iter->exists("outbound")) {
+            loadOutboundOptions(&iter->lookup("outbound"));
+        }
+
+        if (iter->exists("reconnect")) {
+            loadReconnectOptions(&iter->lookup("reconnect"));
+        }
     }
 
-    _logger(LOG_INFO, "<SimSourcePlugin> Connecting to simulator on %s:%d", ipAddress.c_str(), port);
+    // the registry bound by the host replaces the local one
+    _malformedValues = &metrics().counter("simhub_prepare3d_malformed_values_total", "ProSim values rejected as malformed");
+    metrics().counterFunction("simhub_prepare3d_overlong_lines_total", "ProSim lines dropped for not fitting the read buffer", "", [this] { return (uint64_t)_framer.overlongLines(); });
+    _writer.registerMetrics(metrics(), "plugin=\"prepar3d\"");
+    _writer.setCompletion([this](int64_t ingestTime) { traceLatency(LATENCY_STAGE_COMPLETE, ingestTime); });
+    _reconnects = &metrics().counter("simhub_prepare3d_reconnects_total", "Connections to ProSim re-established after a loss");
+    _connectFailures = &metrics().counter("simhub_prepare3d_connect_failures_total", "Failed attempts to connect to ProSim");
+    metrics().gaugeFunction("simhub_prepare3d_connection_state", "ProSim connection, 0 disconnected, 1 connecting, 2 connected", "", [this] { return (double)_connectionState; });
 
-    struct sockaddr_in req_addr;
+    _logger(LOG_INFO, "<SimSourcePlugin> Connecting to simulator on %s:%d", ipAddress.c_str(), port);
 
     _eventLoop = uv_default_loop();
     check_uv(uv_loop_init(_eventLoop));
+    check_uv(uv_timer_init(_eventLoop, &_reconnectTimer));
+    _reconnectTimer.data = this;
+    check_uv(uv_async_init(_eventLoop, &_stopSignal, &SimSourcePluginStateManager::OnStop));
+    _stopSignal.data = this;
+
+    // commands can be submitted from now on, they go out once connected
+    if (!_writer.open(_eventLoop)) {
+        _logger(LOG_ERROR, "<SimSourcePlugin> Unable to set up the simulator command writer");
+        return PREFLIGHT_FAIL;
+    }
+
+    if (!resolveAddress(ipAddress, port, &_simulatorAddress)) {
+        return PREFLIGHT_FAIL;
+    }
+
+    // later failures are retried in the background, see scheduleReconnect
+    if (connect() < 0) {
+        retVal = PREFLIGHT_FAIL;
+    }
+
+    return retVal;
+}
+
+//! starts connecting to _simulatorAddress, completes in OnConnect
+int SimSourcePluginStateManager::connect(void)
+{
     check_uv(uv_tcp_init(_eventLoop, &_tcpClient));
     uv_tcp_keepalive(&_tcpClient, 1, 60);
 
-    uv_ip4_addr(ipAddress.c_str(), port, &req_addr);
-
     // so the callback can see member values
     _connectReq.data = this;
+    _connectionState = SIM_CONNECTING;
 
-    int connectErr = uv_tcp_connect(&_connectReq, &_tcpClient, (struct sockaddr *)&req_addr, &SimSourcePluginStateManager::OnConnect);
+    int retVal = uv_tcp_connect(&_connectReq, &_tcpClient, (struct sockaddr *)&_simulatorAddress, &SimSourcePluginStateManager::OnConnect);
 
-    if (connectErr < 0) {
-        retVal = PREFLIGHT_FAIL;
+    if (retVal < 0) {
+        _logger(LOG_ERROR, "<SimSourcePlugin> Unable to connect to simulator: %s", uv_strerror(retVal));
+        disconnect();
     }
 
-    // connect to simulated prosim listener
-    _sendSocketClient.setLogger(_logger);
-    if (retVal != PREFLIGHT_FAIL && !_sendSocketClient.connect(ipAddress, port)) {
-        retVal = PREFLIGHT_FAIL;
+    return retVal;
+}
+
+//! drops the connection, OnClose schedules the next attempt unless eventing has ceased
+void SimSourcePluginStateManager::disconnect(void)
+{
+    _writer.detach();
+    _connectionState = SIM_DISCONNECTED;
+
+    if (!uv_is_closing((uv_handle_t *)&_tcpClient)) {
+        uv_close((uv_handle_t *)&_tcpClient, &SimSourcePluginStateManager::OnClose);
     }
+}
 
-    return retVal;
+void SimSourcePluginStateManager::scheduleReconnect(void)
+{
+    uint64_t delay = _backoff.next();
+
+    _logger(LOG_INFO, "<SimSourcePlugin> Reconnecting to simulator in %llu ms (attempt %llu)", (unsigned long long)delay, (unsigned long long)_backoff.attempts());
+    uv_timer_start(&_reconnectTimer, &SimSourcePluginStateManager::OnReconnectTimer, delay, 0);
+}
+
+void SimSourcePluginStateManager::OnReconnectTimer(uv_timer_t *handle)
+{
+    SimSourcePluginStateManager *self = static_cast<SimSourcePluginStateManager *>(handle->data);
+
+    if (!self->_stopping) {
+        self->connect();
+    }
+}
+
+//! replays the latest record of every element sent so far so ProSim converges with the cockpit
+void SimSourcePluginStateManager::resync(void)
+{
+    std::lock_guard<std::mutex> latestGuard(_latestValuesMutex);
+
+    for (std::pair<const std::string, std::string> &latest : _latestValues) {
+        _writer.submit(latest.second.data(), latest.second.size());
+    }
+
+    if (!_latestValues.empty()) {
+        _logger(LOG_INFO, "<SimSourcePlugin> Resynced %lu value(s) to the simulator", _latestValues.size());
+    }
+
+    _writer.flush();
+}
+
+void SimSourcePluginStateManager::loadReconnectOptions(libconfig::Setting *reconnect)
+{
+    int initialDelay = (int)_backoff.initial();
+    int maxDelay = (int)_backoff.maximum();
+    double multiplier = BACKOFF_DEFAULT_MULTIPLIER;
+    double jitter = BACKOFF_DEFAULT_JITTER;
+
+    reconnect->lookupValue("initialDelay", initialDelay);
+    reconnect->lookupValue("maxDelay", maxDelay);
+    reconnect->lookupValue("multiplier", multiplier);
+    reconnect->lookupValue("jitter", jitter);
+
+    _backoff.configure(initialDelay > 0 ? initialDelay : 1, maxDelay > 0 ? maxDelay : 1, multiplier, jitter);
+
+    _logger(LOG_INFO, "Reconnect | %llu ms doubling by %.1f up to %llu ms, jitter %.2f", (unsigned long long)_backoff.initial(), multiplier, (unsigned long long)_backoff.maximum(), jitter);
+}
+
+//! address is an IPv4 address or a hostname, resolved through libuv rather than gethostbyname
+bool SimSourcePluginStateManager::resolveAddress(const std::string &address, int port, struct sockaddr_in *resolved)
+{
+    if (uv_ip4_addr(address.c_str(), port, resolved) == 0) {
+        return true;
+    }
+
+    struct addrinfo hints;
+    uv_getaddrinfo_t resolver;
+
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+
+    // no callback - resolves synchronously, preflight runs before the loop does
+    int status = uv_getaddrinfo(_eventLoop, &resolver, NULL, address.c_str(), NULL, &hints);
+
+    if (status < 0 || !resolver.addrinfo) {
+        _logger(LOG_ERROR, "Failed to resolve hostname %s: %s", address.c_str(), uv_strerror(status));
+        return false;
+    }
+
+    memcpy(resolved, resolver.addrinfo->ai_addr, sizeof(struct sockaddr_in));
+    resolved->sin_port = htons(port);
+    uv_freeaddrinfo(resolver.addrinfo);
+
+    char name[INET_ADDRSTRLEN];
+    uv_ip4_name(resolved, name, sizeof(name));
+    _logger(LOG_INFO, "prepar3d hostname resolved to %s", name);
+
+    return true;
+}
+
+void SimSourcePluginStateManager::loadOutboundOptions(libconfig::Setting *outbound)
+{
+    OutboundOptions options;
+    int flushThreshold = (int)options.flushThreshold;
+    int flushInterval = (int)options.flushInterval;
+    int queueCapacity = (int)options.queueCapacity;
+
+    outbound->lookupValue("noDelay", options.noDelay);
+    outbound->lookupValue("cork", options.cork);
+    outbound->lookupValue("flushThreshold", flushThreshold);
+    outbound->lookupValue("flushInterval", flushInterval);
+    outbound->lookupValue("queueCapacity", queueCapacity);
+
+    options.flushThreshold = flushThreshold > 0 ? flushThreshold : 1;
+    options.flushInterval = flushInterval > 0 ? flushInterval : 0;
+    options.queueCapacity = queueCapacity > 0 ? queueCapacity : OUTBOUND_DEFAULT_QUEUE_CAPACITY;
+
+    if (options.cork && options.flushInterval == 0) {
+        // without the tick a corked record below flushThreshold would never be written
+        _logger(LOG_ERROR, "Outbound | cork needs a flushInterval, using %i ms", OUTBOUND_DEFAULT_FLUSH_INTERVAL);
+        options.flushInterval = OUTBOUND_DEFAULT_FLUSH_INTERVAL;
+    }
+
+    _writer.setOptions(options);
+
+    _logger(LOG_INFO, "Outbound | noDelay %s, cork %s, flush at %lu bytes / %u ms, %lu queued records", options.noDelay ? "on" : "off", options.cork ? "on" : "off", options.flushThreshold, options.flushInterval, options.queueCapacity);
 }
 
 void SimSourcePluginStateManager::loadTransforms(libconfig::Setting *transforms)
@@ -168,35 +353,35 @@ void SimSourcePluginStateManager::loadTransforms(libconfig::Setting *transforms)
 
     for (libconfig::Setting const &transform : *transforms) {
         std::string transformName = transform.getName();
+        TransformChain chain;
 
-        _logger(LOG_INFO, "Transforms | %s loaded", transformName.c_str());
-
-        if (transform.exists("On") && transform.exists("Off")) {
-            std::string transformResultOn;
-            std::string transformResultOff;
-
-            transform.lookupValue("On", transformResultOn);
-            transform.lookupValue("Off", transformResultOff);
-            _transformMap.emplace(
-                transformName, std::bind(&SimSourcePluginStateManager::transformBoolToString, this, std::placeholders::_1, transformResultOff, transformResultOn));
+        if (TransformChainFromSetting(transform, chain)) {
+            _transforms.add(transformName, symbolFor(transformName), chain);
+            _logger(LOG_INFO, "Transforms | %s loaded", transformName.c_str());
+        }
+        else {
+            _logger(LOG_ERROR, "Transforms | %s has no transform steps, skipped", transformName.c_str());
         }
     }
 }
 
-/**
- *   @brief  Default  find a transform by element name
- *
- *   @return TransformFunction or NULL if not found
- */
-TransformFunction SimSourcePluginStateManager::transform(std::string transformName)
+//! explicit value types for elements whose name prefix does not match their type
+void SimSourcePluginStateManager::loadTypes(libconfig::Setting *types)
 {
-    TransformMap::iterator it = _transformMap.find(transformName);
+    for (libconfig::Setting const &type : *types) {
+        std::string elementName = type.getName();
+        std::string typeName;
 
-    if (it != _transformMap.end()) {
-        return (*it).second;
+        if (type.getType() == libconfig::Setting::TypeString) {
+            typeName = (const char *)type;
+        }
+
+        if (!_valueParser.setOverride(elementName, symbolFor(elementName), typeName)) {
+            _logger(LOG_ERROR, "Types | Unknown type '%s' for %s. Skipping....", typeName.c_str(), elementName.c_str());
+        }
     }
 
-    return NULL;
+    _logger(LOG_INFO, "Types | %lu type override(s) loaded", _valueParser.overrideCount());
 }
 
 void SimSourcePluginStateManager::OnConnect(uv_connect_t *req, int status)
@@ -205,13 +390,14 @@ void SimSourcePluginStateManager::OnConnect(uv_connect_t *req, int status)
 
     SimSourcePluginStateManager *self = static_cast<SimSourcePluginStateManager *>(req->data);
 
-    if (status == SIM_CONNECT_NOT_FOUND) {
-        SimSourcePluginStateManager::StateManagerInstance()->_logger(LOG_ERROR, "   - Failed to connect to simulator");
-        // deliver NULL value to indicate failure to app
-        self->_enqueueCallback(self, (void *)NULL, self->_callbackArg);
+    if (status < 0) {
+        // the rest of the hub keeps running while we retry in the background
+        self->_logger(LOG_ERROR, "   - Failed to connect to simulator: %s", uv_strerror(status));
+        self->_connectFailures->add();
+        self->disconnect();
     }
     else {
-        SimSourcePluginStateManager::StateManagerInstance()->instanceConnectionHandler(req, status);
+        self->instanceConnectionHandler(req, status);
     }
 }
 
@@ -228,356 +414,247 @@ void SimSourcePluginStateManager::OnClose(uv_handle_t *handle)
 
 void SimSourcePluginStateManager::instanceConnectionHandler(uv_connect_t *req, int status)
 {
-    if (uv_is_readable(req->handle)) {
-        uv_read_start(req->handle, &SimSourcePluginStateManager::AllocBuffer, &SimSourcePluginStateManager::OnRead);
+    if (!uv_is_readable(req->handle)) {
+        _logger(LOG_ERROR, "   - Simulator connection is not readable");
+        disconnect();
+        return;
     }
-    else {
-        printf("not readable\n");
+
+    if (_everConnected) {
+        _reconnects->add();
+        _logger(LOG_INFO, "<SimSourcePlugin> Reconnected to simulator after %llu attempt(s)", (unsigned long long)_backoff.attempts());
     }
+
+    _everConnected = true;
+    _connectionState = SIM_CONNECTED;
+    _backoff.reset();
+
+    // a partial line left by the previous connection cannot be completed
+    _framer.reset();
+    uv_read_start(req->handle, &SimSourcePluginStateManager::AllocBuffer, &SimSourcePluginStateManager::OnRead);
+    _writer.attach(&_tcpClient);
+    resync();
 }
 
 void SimSourcePluginStateManager::instanceReadHandler(uv_stream_t *server, ssize_t nread, const uv_buf_t *buf)
 {
     if (nread > 0) {
-        uv_buf_t buffer = uv_buf_init((char *)malloc(nread), nread);
-        memcpy(buffer.base, buf->base, nread);
-        buffer.base[nread - 1] = '\0';
-        processData(buffer.base, nread);
-        free(buffer.base);
+        // everything parsed out of this read is traced from here
+        _readTime = monotonic_nanos();
+
+        // buf is the framer's write space, see AllocBuffer
+        _framer.commit(nread);
+        processFrames();
     }
     else if (nread < 0) {
         if (nread == UV_EOF) {
-            SimSourcePluginStateManager::StateManagerInstance()->_logger(LOG_INFO, " - Stopping prepare3d ingest loop");
-            stopUVLoop();
-            // deliver NULL value to indicate failure to app
-            _enqueueCallback(this, (void *)NULL, _callbackArg);
+            _logger(LOG_INFO, " - Simulator closed the connection");
         }
         else {
-            SimSourcePluginStateManager::StateManagerInstance()->_logger(LOG_INFO, " - %s", uv_strerror(nread));
-            uv_close((uv_handle_t *)server, &SimSourcePluginStateManager::OnClose);
+            _logger(LOG_INFO, " - %s", uv_strerror(nread));
         }
+
+        // reconnects once the handle is closed, see instanceCloseHandler
+        disconnect();
     }
 }
 
-void SimSourcePluginStateManager::processData(char *data, int len)
+//! frames and parses data not read into the framer by the socket, e.g. replayed captures
+void SimSourcePluginStateManager::processData(const char *data, int len)
 {
-    if (len > 2) {
-        int elementCount = 0;
-        char *p = strtok(data, "\n");
-        char *array[MAX_ELEMENTS_PER_UPDATE];
-
-        while (p != NULL) {
-            size_t len = strlen(p);
+    _framer.appendRecords(data, len, [this](char *line, size_t length, char *assign) { processLine(line, length, assign); });
+}
 
-            if (len > 2) {
-                char *buffer = (char *)malloc(BUFFER_LEN);
-                memset(buffer, 0, BUFFER_LEN);
-                strncpy(buffer, p, len);
-                buffer[len - 1] = '\0';
-                array[elementCount++] = buffer;
-            }
+//! parses every complete line the socket reads have delivered so far
+void SimSourcePluginStateManager::processFrames(void)
+{
+    _framer.frameRecords([this](char *line, size_t length, char *assign) { processLine(line, length, assign); });
+}
 
-            p = strtok(NULL, "\n");
-        }
+//! assign is the line's first '=' as found by the framer's delimiter scan
+void SimSourcePluginStateManager::processLine(char *line, size_t length, char *assign)
+{
+    TextView name;
+    TextView value;
 
-        for (int i = 0; i < elementCount; ++i) {
-            processElement(array[i]);
-            free(array[i]);
-        }
+    if (SplitRecord(line, length, assign, name, value) && !value.empty()) {
+        processElement(name, value);
     }
 }
 
-void SimSourcePluginStateManager::processElement(char *element)
+//! name and value point into the framer's buffer and are '\0' terminated
+void SimSourcePluginStateManager::processElement(const TextView &name, const TextView &value)
 {
-    char *name = strtok(element, "=");
-    char *value = strtok(NULL, " =");
+    _elementName.assign(name.data, name.length);
 
-    if (value == NULL) {
-        return;
-    }
+    SymbolId symbol = symbolFor(_elementName);
+    ValueParseFunction parse = _valueParser.parserFor(_elementName, symbol);
+    GenericTLV *el = make_generic(name.data, "-");
 
-    name[strlen(name) - 1] = '\0';
-    
-    if (strlen(name) == 0) {
+    if (!parse(value, el)) {
+        release_generic(el);
+        _malformedValues->add();
         return;
     }
-    
-    char *type = getElementDataType(name[0]);
 
-    if (type != NULL) {
-        GenericTLV *el = make_generic(name, "-");
+    el->ownerPlugin = this;
+    el->symbol = symbol;
+    el->ingestTime = _readTime;
 
-        el->ownerPlugin = this;
+    traceLatency(LATENCY_STAGE_PARSE, el->ingestTime);
+    _enqueueCallback(this, (void *)el, _callbackArg);
 
-        if (strncmp(type, "float", sizeof(&type)) == 0) {
-            el->type = CONFIG_FLOAT;
-            el->value.float_value = atof(value);
-            el->length = sizeof(float);
-        }
-        else if (strncmp(type, "char", sizeof(&type)) == 0) {
-            el->type = CONFIG_STRING;
-            dupe_string(&(el->value.string_value), value);
-            el->length = strlen(value);
-        }
-        else if (strncmp(type, "int", sizeof(&type)) == 0) {
-            el->type = CONFIG_INT;
-            el->value.int_value = atoi(value);
-            el->length = sizeof(int);
-        }
-        else if (strncmp(type, "uint", sizeof(&type)) == 0) {
-            el->type = CONFIG_UINT;
-            el->value.int_value = (uint)atoi(value);
-            el->length = sizeof(int);
+    _processedElementCount++;
+}
+
+//! appends value as a prosim "name=value\n" line to out
+void SimSourcePluginStateManager::formatValue(GenericTLV *value, std::string &out)
+{
+    TransformId transformId = _transforms.find(value->name, value->symbol);
+    TransformResult result;
+    char number[32];
+
+    out.append(value->name);
+    out += '=';
+
+    if (transformId != TRANSFORM_NONE && GenericNumber(value, result.number)) {
+        _transforms.apply(transformId, result.number, result);
+
+        if (result.label) {
+            out.append(result.label, result.labelLength);
         }
-        else if (strncmp(type, "bool", sizeof(&type)) == 0) {
-            el->type = CONFIG_BOOL;
-            el->length = sizeof(uint8_t);
-            if (strncmp(value, "0", sizeof(el->value)) == 0) {
-                el->value.bool_value = 0;
-            }
-            else {
-                el->value.bool_value = 1;
-            }
+        else if (value->type != CONFIG_FLOAT && result.number == (double)(long long)result.number) {
+            out.append(number, snprintf(number, sizeof(number), "%lld", (long long)result.number));
         }
         else {
-            _logger(LOG_ERROR, "Missing prosim type mapping %s %s %s", name, value, type);
+            out.append(number, snprintf(number, sizeof(number), "%g", result.number));
         }
-
-        _enqueueCallback(this, (void *)el, _callbackArg);
-
-        // TODO remove this echo test - or make it a configuartion switch
-        // deliverValue(&el);
-
-        _processedElementCount++;
     }
-}
-
-char *SimSourcePluginStateManager::getElementDataType(char identifier)
-{
-
-    switch (identifier) {
-    case GAUGE_IDENTIFIER:
-        return (char *)"float";
-        break;
-    case NUMBER_IDENTIFIER:
-        return (char *)"int";
-        break;
-    case INDICATOR_IDENTIFIER:
-        return (char *)"bool";
-        break;
-    case VALUE_IDENTIFIER:
-        return (char *)"uint";
-        break;
-    case ANALOG_IDENTIFIER:
-        return (char *)"char";
-        break;
-    case ROTARY_IDENTIFIER:
-        return (char *)"char";
-        break;
-    case BOOLEAN_IDENTIFIER:
-        return (char *)"bool";
-        break;
-    case SWITCH_IDENTIFIER:
-        return (char *)"bool";
-        break;
-    case ENCODER_IDENTIFIER:
-        return (char *)"float";
-        break;
-    default:
-        //_logger(LOG_ERROR, "Missing prosim element data type %c", identifier);
-        break;
+    else {
+        switch (value->type) {
+        case CONFIG_FLOAT:
+            // %g matches the stream formatting the values used to go out with
+            out.append(number, snprintf(number, sizeof(number), "%g", value->value.float_value));
+            break;
+        case CONFIG_UINT:
+            out.append(number, snprintf(number, sizeof(number), "%u", (unsigned int)value->value.int_value));
+            break;
+        case CONFIG_BOOL:
+            out += value->value.bool_value ? '1' : '0';
+            break;
+        case CONFIG_STRING:
+            out.append(value->value.string_value ? value->value.string_value : "");
+            break;
+        default:
+            out.append(number, snprintf(number, sizeof(number), "%d", value->value.int_value));
+            break;
+        }
     }
 
-    return (char *)"char";
+    out += '\n';
 }
 
-std::string SimSourcePluginStateManager::prosimValueString(std::shared_ptr<Attribute> attribute)
+//! queues value for the next flush of the simulator connection, see OutboundWriter
+int SimSourcePluginStateManager::deliverValue(GenericTLV *value)
 {
-    std::string retVal("");
+    // per delivering thread, keeps its capacity between values
+    static thread_local std::string record;
 
-    // TODO: look at first char of target and use this to
-    // validate the type of attribute and to convert the
-    // attribute value to a prosim value string
+    traceLatency(LATENCY_STAGE_DELIVER, value->ingestTime);
 
-    switch (attribute->name().c_str()[0]) {
-    case SWITCH_IDENTIFIER:
-    // printf("SimSourcePluginStateManager\n");
-    // retVal = attribute->value<bool>() ? 0 : 1;
-    // break;
+    record.clear();
+    formatValue(value, record);
 
-    default:
-        retVal = attribute->valueToString();
-        break;
-    }
-
-    return retVal;
-}
+    {
+        std::lock_guard<std::mutex> latestGuard(_latestValuesMutex);
 
-int SimSourcePluginStateManager::deliverValue(GenericTLV *value)
-{
-    std::ostringstream oss;
-    std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(value);
+        _latestKey.assign(value->name);
+        std::map<std::string, std::string>::iterator latest = _latestValues.find(_latestKey);
 
-    TransformFunction transformFunction = transform(attribute->name());
-    std::string val = "";
-
-    if (value->type == CONFIG_STRING) {
-        std::cout << "::deliverValue just got value with name: " << value->name << " and value " << value->value.string_value << std::endl;
-    }
-    else if (value->type == CONFIG_BOOL) {
-        std::cout << "::deliverValue just got value with name: " << value->name << " and value " << value->value.bool_value << std::endl;
+        // assigning into the existing entry reuses its capacity
+        if (latest != _latestValues.end()) {
+            latest->second.assign(record);
+        }
+        else {
+            _latestValues.emplace(_latestKey, record);
+        }
     }
 
-    if (transformFunction) {
-        val = transformFunction(attribute->valueToString(), "NULL", "NULL");
-        oss << attribute->name() << "=" << val << "\n";
-    }
-    else {
-        oss << attribute->name() << "=" << prosimValueString(attribute) << "\n";
+    if (!_writer.submit(record.data(), record.size(), value->ingestTime)) {
+        _logger(LOG_ERROR, "<SimSourcePlugin> %s is too long to send (%lu bytes)", value->name, record.size());
     }
 
-    // printf("SimSourcePluginStateManager::deliverValue %s %s\n", oss.str().c_str(), val.c_str());
-    _sendSocketClient.sendData(oss.str());
-
     return 0;
 }
 
-void SimSourcePluginStateManager::instanceCloseHandler(uv_handle_t *handle)
+//! a batch is appended record by record and goes out with the same flush
+int SimSourcePluginStateManager::deliverValues(GenericTLV **values, int count)
 {
-    if (!_eventLoop->active_handles) {
-        stopUVLoop();
+    for (int i = 0; i < count; i++) {
+        deliverValue(values[i]);
     }
-}
 
-void SimSourcePluginStateManager::stopUVLoop(void)
-{
-    if (_eventLoop) {
-        uv_stop(_eventLoop);
-        uv_loop_close(_eventLoop);
-        _eventLoop = NULL;
-    }
+    return 0;
 }
 
-void SimSourcePluginStateManager::ceaseEventing(void)
+void SimSourcePluginStateManager::instanceCloseHandler(uv_handle_t *handle)
 {
-    if (_pluginThread) {
-        stopUVLoop();
-
-        if (_pluginThread->joinable()) {
-            _pluginThread->join();
-        }
+    if (!_stopping) {
+        scheduleReconnect();
     }
 }
 
-void SimSourcePluginStateManager::commenceEventing(EnqueueEventHandler enqueueCallback, void *arg)
+void SimSourcePluginStateManager::OnStop(uv_async_t *handle)
 {
-    _enqueueCallback = enqueueCallback;
-    _callbackArg = arg;
-    _pluginThread = std::make_shared<std::thread>([=] { check_uv(uv_run(_eventLoop, UV_RUN_DEFAULT)); });
+    static_cast<SimSourcePluginStateManager *>(handle->data)->shutdown();
 }
 
-// -- simple socket send/receive wrapper
-
-TCPClient::TCPClient(void)
+//! closes every handle of the loop and stops it - loop thread only
+void SimSourcePluginStateManager::shutdown(void)
 {
-    _sock = -1;
-    _port = 0;
-    _address = "";
+    // a pending reconnect would otherwise hold the loop until its backoff delay is up
+    uv_timer_stop(&_reconnectTimer);
+    uv_close((uv_handle_t *)&_reconnectTimer, NULL);
+    _writer.close();
+    // _stopping is set, OnClose does not schedule a reconnect
+    disconnect();
+    uv_close((uv_handle_t *)&_stopSignal, NULL);
+    uv_stop(_eventLoop);
 }
 
-void TCPClient::setLogger(LoggingFunctionCB logger)
+//! wakes the loop thread to shut itself down, libuv handles are only touched from that thread
+void SimSourcePluginStateManager::stopUVLoop(void)
 {
-    _logger = logger;
+    if (_eventLoop) {
+        uv_async_send(&_stopSignal);
+    }
 }
 
-/**
-    Connect to a host on a certain port number
-*/
-bool TCPClient::connect(std::string address, int port)
+void SimSourcePluginStateManager::ceaseEventing(void)
 {
-    bool retVal = true;
-
-    _address = address;
-    _port = port;
+    _stopping = true;
 
-    // create socket if it is not already created
-    if (_sock == -1) {
-        _sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (_pluginThread) {
+        stopUVLoop();
 
-        if (_sock == -1) {
-            perror("Could not create socket");
-            retVal = false;
+        if (_pluginThread->joinable()) {
+            _pluginThread->join();
         }
-    }
 
-    // setup address structure
-    if (inet_addr(_address.c_str()) == -1) {
-        struct hostent *he;
-        struct in_addr **addr_list;
+        _pluginThread.reset();
 
-        // resolve the hostname, its not an ip address
-        if ((he = gethostbyname(_address.c_str())) == NULL) {
-            herror("gethostbyname");
-            _logger(LOG_ERROR, "Failed to resolve hostname %s", _address.c_str());
-            retVal = false;
-        }
-        else {
-            // cast the h_addr_list to in_addr , since h_addr_list also has the ip
-            // address in long format only
-
-            addr_list = (struct in_addr **)he->h_addr_list;
-            for (int i = 0; addr_list[i] != NULL; i++) {
-                _server.sin_addr = *addr_list[i];
-                _logger(LOG_INFO, "prepar3d hostname resolved to %s", inet_ntoa(*addr_list[i]));
-                break;
-            }
+        if (_eventLoop) {
+            // close callbacks uv_stop left pending run here, the loop thread is gone
+            uv_run(_eventLoop, UV_RUN_DEFAULT);
+            uv_loop_close(_eventLoop);
+            _eventLoop = NULL;
         }
     }
-    else {
-        _server.sin_addr.s_addr = inet_addr(address.c_str());
-    }
-
-    _server.sin_family = AF_INET;
-    _server.sin_port = htons(port);
-
-    // connect to remote server
-    if (::connect(_sock, (struct sockaddr *)&_server, sizeof(_server)) < 0) {
-        perror("connect failed. Error");
-        retVal = false;
-    }
-
-    if (retVal)
-        _logger(LOG_INFO, "<SimSourcePlugin> Connected to %s:%d", address.c_str(), port);
-
-    return retVal;
 }
 
-/**
-    Send data to the connected host
-*/
-bool TCPClient::sendData(std::string data)
-{
-    // Send some data
-    if (send(_sock, data.c_str(), data.size(), 0) < 0) {
-        perror("Send failed : ");
-        return false;
-    }
-
-    return true;
-}
-
-/**
-    Receive data from the connected host
-*/
-std::string TCPClient::receive(int size = 512)
+void SimSourcePluginStateManager::commenceEventing(EnqueueEventHandler enqueueCallback, void *arg)
 {
-    char buffer[size];
-    std::string reply;
-
-    // Receive a reply from the server
-    if (recv(_sock, buffer, sizeof(buffer), 0) < 0)
-        puts("recv failed");
-
-    reply = buffer;
-    return reply;
+    _enqueueCallback = enqueueCallback;
+    _callbackArg = arg;
+    _pluginThread = std::make_shared<std::thread>([=] { check_uv(uv_run(_eventLoop, UV_RUN_DEFAULT)); });
 }
@@ -1,32 +1,28 @@
 #ifndef __SIMSOURCE_MAIN_H
 #define __SIMSOURCE_MAIN_H
 
+#include "common/alignedallocation.h"
+#include "common/backoff.h"
+#include "common/lineframer.h"
 #include "common/private/pluginstatemanager.h"
+#include "outboundWriter.h"
+#include "prosimValueParser.h"
 
-#include <arpa/inet.h>
+#include <atomic>
 #include <errno.h>
 #include <map>
-#include <netdb.h>
+#include <mutex>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/socket.h>
 #include <thread>
 #include <uv.h>
 
-#define BUFFER_LEN 4096
-#define MAX_ELEMENTS_PER_UPDATE 1024
-#define GAUGE_IDENTIFIER 'G'
-#define NUMBER_IDENTIFIER 'N'
-#define INDICATOR_IDENTIFIER 'I'
-#define VALUE_IDENTIFIER 'V'
-#define ANALOG_IDENTIFIER 'A'
-#define ROTARY_IDENTIFIER 'R'
-#define BOOLEAN_IDENTIFIER 'B'
-#define SWITCH_IDENTIFIER 'S'
-#define ENCODER_IDENTIFIER 'E'
+//! largest ProSim line that can be framed, longer lines are dropped
+#define PREPARE3D_FRAME_CAPACITY (64 * 1024)
 
-#define SIM_CONNECT_NOT_FOUND -61
+typedef enum { SIM_DISCONNECTED = 0, SIM_CONNECTING, SIM_CONNECTED } SimConnectionState;
 
 #define check_uv(status)                                                                                                                                                           \
     do {                                                                                                                                                                           \
@@ -37,44 +33,36 @@
         }                                                                                                                                                                          \
     } while (0)
 
-/**
- * simple tcp socket wrapper class
- */
-class TCPClient
-{
-private:
-    int _sock;
-    std::string _address;
-    int _port;
-    struct sockaddr_in _server;
-    LoggingFunctionCB _logger;
-
-public:
-    TCPClient(void);
-    bool connect(std::string, int);
-    bool sendData(std::string data);
-    std::string receive(int);
-    void setLogger(LoggingFunctionCB logger);
-};
-
-// every function pointer will be stored as this type
-// typedef void (*voidFunctionType)(void);
-typedef std::function<std::string(std::string, std::string, std::string)> TransformFunction;
-typedef std::map<std::string, TransformFunction> TransformMap;
-
 //! barest specialisation of the internal plugin management support base class
-class SimSourcePluginStateManager : public PluginStateManager
+class SimSourcePluginStateManager : public PluginStateManager, public AlignedAllocation<RING_QUEUE_CACHE_LINE>
 {
 private:
     uv_loop_t *_eventLoop; ///< main libuv event loop
-    uv_buf_t _readBuffer; ///< tcp read buffer
-    uv_tcp_t _tcpClient; ///< TCPClient
+    uv_tcp_t _tcpClient; ///< the one ProSim connection, ingest and commands
     uv_connect_t _connectReq;
-    char *_rawBuffer; ///< raw buffer for the tcp loop
-    TCPClient _sendSocketClient;
+    struct sockaddr_in _simulatorAddress;
+    uv_timer_t _reconnectTimer;
+    uv_async_t _stopSignal; ///< ceaseEventing wakes the loop thread with this to shut it down
+    Backoff _backoff; ///< delay between reconnect attempts
+    std::atomic<int> _connectionState; ///< SimConnectionState
+    std::atomic<bool> _stopping; ///< ceaseEventing was called, connections are not re-established
+    bool _everConnected;
+    MetricCounter *_reconnects;
+    MetricCounter *_connectFailures;
+    LineFramer _framer; ///< socket reads land here and are parsed in place
+    std::string _elementName; ///< reused for symbol lookups so parsing does not allocate
+    ProsimValueParser _valueParser;
+    MetricCounter *_malformedValues;
+    OutboundWriter _writer; ///< commands go out on _tcpClient from the loop thread
+
+    // latest record sent per element, replayed after a reconnect
+    std::mutex _latestValuesMutex;
+    std::map<std::string, std::string> _latestValues;
+    std::string _latestKey; ///< reused for lookups, guarded by _latestValuesMutex
 
     // statistics
     long _processedElementCount;
+    int64_t _readTime; ///< monotonic_nanos() of the socket read being processed
 
     //! simple implementation of class instance singleton
     static SimSourcePluginStateManager *_StateManagerInstance;
@@ -86,21 +74,34 @@ private:
     static void OnRead(uv_stream_t *server, ssize_t nread, const uv_buf_t *buf);
     static void OnClose(uv_handle_t *handle);
     static void OnConnect(uv_connect_t *req, int status);
+    static void OnReconnectTimer(uv_timer_t *handle);
+    static void OnStop(uv_async_t *handle);
 
     void instanceReadHandler(uv_stream_t *server, ssize_t nread, const uv_buf_t *buf);
     void instanceCloseHandler(uv_handle_t *handle);
     void instanceConnectionHandler(uv_connect_t *req, int status);
 
-    // data element processing
-    void processData(char *data, int len);
-    void processElement(char *element);
-    char *getElementDataType(char identifier);
-    std::string prosimValueString(std::shared_ptr<Attribute> attribute);
+    // connection management - loop thread only
+    int connect(void);
+    void disconnect(void);
+    void scheduleReconnect(void);
+    void resync(void);
+    void shutdown(void);
 
 protected:
-    TransformMap _transformMap;
+    // data element processing
+    void processData(const char *data, int len);
+    void processFrames(void);
+    void processLine(char *line, size_t length, char *assign);
+    void processElement(const TextView &name, const TextView &value);
+    void formatValue(GenericTLV *value, std::string &out);
+
+    TransformEngine _transforms; ///< compiled from the transforms group, read only once eventing
     void loadTransforms(libconfig::Setting *transforms);
-    TransformFunction transform(std::string transformName);
+    void loadTypes(libconfig::Setting *types);
+    void loadOutboundOptions(libconfig::Setting *outbound);
+    void loadReconnectOptions(libconfig::Setting *reconnect);
+    bool resolveAddress(const std::string &address, int port, struct sockaddr_in *resolved);
     virtual void stopUVLoop(void);
 
 public:
@@ -111,6 +112,7 @@ public:
     void commenceEventing(EnqueueEventHandler enqueueCallback, void *arg);
     void ceaseEventing(void);
     int deliverValue(GenericTLV *value);
+    int deliverValues(GenericTLV **values, int count);
 };
 
 #endif
@@ -0,0 +1,206 @@
+#include "outboundWriter.h"
+
+OutboundWriter::OutboundWriter(void)
+    : _stream(NULL)
+    , _open(false)
+    , _writing(false)
+    , _submissions(OUTBOUND_DEFAULT_QUEUE_CAPACITY, OVERFLOW_DROP_OLDEST)
+    , _submittedBytes(0)
+    , _bytesWritten(0)
+    , _recordsWritten(0)
+    , _flushes(0)
+    , _writeErrors(0)
+    , _oversizedRecords(0)
+{
+    _submissions.setDropHandler([this](OutboundRecord &record) { _submittedBytes -= record.length; });
+}
+
+void OutboundWriter::setOptions(const OutboundOptions &options)
+{
+    _options = options;
+    _submissions.configure(options.queueCapacity, OVERFLOW_DROP_OLDEST);
+}
+
+bool OutboundWriter::open(uv_loop_t *loop)
+{
+    if (_open) {
+        return true;
+    }
+
+    _wakeup.data = this;
+    _tick.data = this;
+    _writeRequest.data = this;
+
+    if (uv_async_init(loop, &_wakeup, &OutboundWriter::OnWakeup) < 0) {
+        return false;
+    }
+
+    uv_timer_init(loop, &_tick);
+
+    if (_options.cork && _options.flushInterval > 0) {
+        uv_timer_start(&_tick, &OutboundWriter::OnTick, _options.flushInterval, _options.flushInterval);
+    }
+
+    _open = true;
+
+    return true;
+}
+
+void OutboundWriter::close(void)
+{
+    if (!_open) {
+        return;
+    }
+
+    _open = false;
+    _stream = NULL;
+    uv_timer_stop(&_tick);
+    uv_close((uv_handle_t *)&_wakeup, NULL);
+    uv_close((uv_handle_t *)&_tick, NULL);
+
+    _pending.clear();
+    _pendingIngestTimes.clear();
+}
+
+void OutboundWriter::attach(uv_tcp_t *connection)
+{
+    _stream = (uv_stream_t *)connection;
+    uv_tcp_nodelay(connection, _options.noDelay ? 1 : 0);
+
+    // whatever was submitted while there was no connection goes out now
+    flush();
+}
+
+void OutboundWriter::detach(void)
+{
+    // an inflight write completes with UV_ECANCELED once the stream is closed
+    _stream = NULL;
+    _pending.clear();
+    _pendingIngestTimes.clear();
+}
+
+bool OutboundWriter::submit(const char *text, size_t length, int64_t ingestTime)
+{
+    OutboundRecord record;
+
+    if (length > OUTBOUND_RECORD_CAPACITY) {
+        _oversizedRecords++;
+        return false;
+    }
+
+    record.ingestTime = ingestTime;
+    record.length = (uint16_t)length;
+    memcpy(record.text, text, length);
+
+    size_t before = _submittedBytes.fetch_add(length);
+
+    _submissions.push(record);
+
+    bool wake = _options.cork ? (before < _options.flushThreshold && before + length >= _options.flushThreshold) : true;
+
+    // uv_async_send coalesces, a burst of submissions costs one wakeup
+    if (wake && _open) {
+        uv_async_send(&_wakeup);
+    }
+
+    return true;
+}
+
+void OutboundWriter::OnWakeup(uv_async_t *handle)
+{
+    static_cast<OutboundWriter *>(handle->data)->flushIfDue();
+}
+
+void OutboundWriter::OnTick(uv_timer_t *handle)
+{
+    static_cast<OutboundWriter *>(handle->data)->flush();
+}
+
+void OutboundWriter::OnWrite(uv_write_t *request, int status)
+{
+    OutboundWriter *self = static_cast<OutboundWriter *>(request->data);
+
+    self->_writing = false;
+
+    if (status < 0) {
+        self->_writeErrors++;
+    }
+    else if (self->_completion) {
+        for (int64_t ingestTime : self->_inflightIngestTimes) {
+            self->_completion(ingestTime);
+        }
+    }
+
+    self->_inflight.clear();
+    self->_inflightIngestTimes.clear();
+    self->flushIfDue();
+}
+
+void OutboundWriter::drain(void)
+{
+    OutboundRecord record;
+
+    while (_submissions.tryPop(record)) {
+        _submittedBytes -= record.length;
+        _pending.append(record.text, record.length);
+        _pendingIngestTimes.push_back(record.ingestTime);
+    }
+}
+
+void OutboundWriter::flushIfDue(void)
+{
+    if (_options.cork) {
+        if (_pending.size() + _submittedBytes < _options.flushThreshold) {
+            return;
+        }
+    }
+
+    flush();
+}
+
+void OutboundWriter::flush(void)
+{
+    // without a connection records stay in the ring, see detach
+    if (!_open || !_stream) {
+        return;
+    }
+
+    drain();
+
+    if (_writing || _pending.empty()) {
+        return;
+    }
+
+    // swapping keeps both buffers' capacity, nothing is allocated once warmed up
+    _inflight.swap(_pending);
+    _inflightIngestTimes.swap(_pendingIngestTimes);
+
+    uv_buf_t buffer = uv_buf_init(&_inflight[0], _inflight.size());
+
+    _writing = true;
+
+    if (uv_write(&_writeRequest, _stream, &buffer, 1, &OutboundWriter::OnWrite) < 0) {
+        _writing = false;
+        _writeErrors++;
+        _inflight.clear();
+        _inflightIngestTimes.clear();
+        return;
+    }
+
+    _flushes++;
+    _bytesWritten += _inflight.size();
+    _recordsWritten += _inflightIngestTimes.size();
+    _flushBytes.record(_inflight.size());
+    _flushRecords.record(_inflightIngestTimes.size());
+}
+
+void OutboundWriter::registerMetrics(MetricsRegistry &metrics, const std::string &labels)
+{
+    metrics.counterFunction("simhub_outbound_bytes_total", "Bytes written to the simulator", labels, [this] { return (uint64_t)_bytesWritten; });
+    metrics.counterFunction("simhub_outbound_records_total", "Records written to the simulator", labels, [this] { return (uint64_t)_recordsWritten; });
+    metrics.counterFunction("simhub_outbound_flushes_total", "Writes issued to the simulator", labels, [this] { return (uint64_t)_flushes; });
+    metrics.counterFunction("simhub_outbound_write_errors_total", "Failed writes to the simulator", labels, [this] { return (uint64_t)_writeErrors; });
+    metrics.counterFunction("simhub_outbound_dropped_records_total", "Records dropped before reaching the simulator", labels, [this] { return (uint64_t)droppedRecords(); });
+    metrics.summary("simhub_outbound_flush_bytes", "Bytes per write to the simulator", labels, &_flushBytes, 1);
+    metrics.summary("simhub_outbound_flush_records", "Records per write to the simulator", labels, &_flushRecords, 1);
+}
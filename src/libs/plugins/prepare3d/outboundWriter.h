@@ -0,0 +1,142 @@
+#ifndef __OUTBOUNDWRITER_H
+#define __OUTBOUNDWRITER_H
+
+#include <atomic>
+#include <functional>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <uv.h>
+#include <vector>
+
+#include "common/hdrhistogram.h"
+#include "common/metrics.h"
+#include "queue/ring_queue.h"
+
+#define OUTBOUND_DEFAULT_FLUSH_THRESHOLD (16 * 1024)
+#define OUTBOUND_DEFAULT_FLUSH_INTERVAL 5
+#define OUTBOUND_DEFAULT_QUEUE_CAPACITY 4096
+//! longest record that can be submitted, ProSim lines are far shorter
+#define OUTBOUND_RECORD_CAPACITY 240
+
+//! per connection write behaviour, the outbound group of prepare3d.cfg
+struct OutboundOptions {
+    bool noDelay; ///< TCP_NODELAY - flushed records leave immediately rather than waiting on Nagle
+    bool cork; ///< hold records until flushThreshold bytes or the next flushInterval tick
+    size_t flushThreshold; ///< bytes
+    unsigned int flushInterval; ///< ms between corked flushes
+    size_t queueCapacity; ///< records waiting for the loop, the oldest are dropped beyond this
+
+    OutboundOptions(void)
+        : noDelay(true)
+        , cork(false)
+        , flushThreshold(OUTBOUND_DEFAULT_FLUSH_THRESHOLD)
+        , flushInterval(OUTBOUND_DEFAULT_FLUSH_INTERVAL)
+        , queueCapacity(OUTBOUND_DEFAULT_QUEUE_CAPACITY){};
+};
+
+//! one submitted record, copied into a ring slot so submitting never allocates
+struct OutboundRecord {
+    int64_t ingestTime;
+    uint16_t length;
+    char text[OUTBOUND_RECORD_CAPACITY];
+
+    OutboundRecord(void)
+        : ingestTime(0)
+        , length(0){};
+};
+
+//! called on the loop thread with the ingest time of every record once its write has completed
+typedef std::function<void(int64_t)> OutboundCompletion;
+
+/**
+ * Coalescing writer for the records a plugin sends back to its
+ * simulator connection
+ *
+ * - any thread submits records through a lock-free ring and wakes the
+ *   plugin's libuv loop with a uv_async_t, the socket itself is only
+ *   ever touched by the loop thread
+ * - the loop drains the ring into one buffer that goes out with a
+ *   single uv_write per loop iteration, or (corked) when flushThreshold
+ *   bytes are pending or the flushInterval tick fires
+ * - only one write is in flight at a time, records drained meanwhile
+ *   go out together when it completes
+ * - records submitted while no connection is attached wait in the
+ *   ring, the oldest are dropped once it is full
+ * - bytes and records per flush are kept in histograms
+ */
+class OutboundWriter
+{
+protected:
+    OutboundOptions _options;
+    uv_stream_t *_stream; ///< attached connection, NULL while there is none
+    uv_async_t _wakeup; ///< wakes the loop to drain the ring from other threads
+    uv_timer_t _tick; ///< corked flush interval
+    uv_write_t _writeRequest;
+    std::atomic<bool> _open;
+    bool _writing;
+    OutboundCompletion _completion;
+
+    RingQueue<OutboundRecord> _submissions;
+    std::atomic<size_t> _submittedBytes; ///< bytes in the ring, decides corked wakeups
+    std::string _pending; ///< loop thread only from here down
+    std::vector<int64_t> _pendingIngestTimes;
+    std::string _inflight;
+    std::vector<int64_t> _inflightIngestTimes;
+
+    std::atomic<uint64_t> _bytesWritten;
+    std::atomic<uint64_t> _recordsWritten;
+    std::atomic<uint64_t> _flushes;
+    std::atomic<uint64_t> _writeErrors;
+    std::atomic<uint64_t> _oversizedRecords;
+    HdrHistogram _flushBytes;
+    HdrHistogram _flushRecords;
+
+    static void OnWakeup(uv_async_t *handle);
+    static void OnTick(uv_timer_t *handle);
+    static void OnWrite(uv_write_t *request, int status);
+
+    //! moves everything submitted so far into the pending buffer
+    void drain(void);
+    //! flushes if the pending records are due, see OutboundOptions
+    void flushIfDue(void);
+
+public:
+    OutboundWriter(void);
+    virtual ~OutboundWriter(void){};
+
+    //! only before open(), the ring is sized here
+    void setOptions(const OutboundOptions &options);
+    const OutboundOptions &options(void) const { return _options; };
+    void setCompletion(OutboundCompletion completion) { _completion = completion; };
+
+    //! creates the writer's handles on loop - before the loop runs or on its thread
+    bool open(uv_loop_t *loop);
+    //! closes the writer's handles, anything not yet written is dropped - loop thread only
+    void close(void);
+
+    //! starts writing to a connected socket - loop thread only
+    void attach(uv_tcp_t *connection);
+    //! the connection is gone, records written to it but not completed are dropped - loop thread only
+    void detach(void);
+    bool attached(void) const { return _stream != NULL; };
+
+    /**
+     * queues one record for the connection - callable from any thread,
+     * false if the record is longer than OUTBOUND_RECORD_CAPACITY
+     */
+    bool submit(const char *text, size_t length, int64_t ingestTime = 0);
+
+    //! drains the ring and writes everything pending unless a write is still in flight - loop thread only
+    void flush(void);
+
+    void registerMetrics(MetricsRegistry &metrics, const std::string &labels);
+
+    uint64_t bytesWritten(void) const { return _bytesWritten; };
+    uint64_t recordsWritten(void) const { return _recordsWritten; };
+    uint64_t flushes(void) const { return _flushes; };
+    uint64_t writeErrors(void) const { return _writeErrors; };
+    uint64_t droppedRecords(void) { return _submissions.droppedCount() + _oversizedRecords; };
+};
+
+#endif
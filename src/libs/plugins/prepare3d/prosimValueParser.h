@@ -0,0 +1,190 @@
+#ifndef __PROSIMVALUEPARSER_H
+#define __PROSIMVALUEPARSER_H
+
+#include <map>
+#include <string>
+
+#include "common/lineframer.h"
+#include "common/numberparse.h"
+#include "common/simhubdeviceplugin.h"
+#include "common/symboltable.h"
+
+#define GAUGE_IDENTIFIER 'G'
+#define NUMBER_IDENTIFIER 'N'
+#define INDICATOR_IDENTIFIER 'I'
+#define VALUE_IDENTIFIER 'V'
+#define ANALOG_IDENTIFIER 'A'
+#define ROTARY_IDENTIFIER 'R'
+#define BOOLEAN_IDENTIFIER 'B'
+#define SWITCH_IDENTIFIER 'S'
+#define ENCODER_IDENTIFIER 'E'
+
+//! fills in type, value and length of generic from text, false if text is not a valid value of the type
+typedef bool (*ValueParseFunction)(const TextView &text, GenericTLV *generic);
+
+inline bool ParseFloatValue(const TextView &text, GenericTLV *generic)
+{
+    double value;
+
+    if (!ParseFloat(text.data, text.length, value)) {
+        return false;
+    }
+
+    generic->type = CONFIG_FLOAT;
+    generic->value.float_value = (float)value;
+    generic->length = sizeof(float);
+
+    return true;
+}
+
+inline bool ParseIntValue(const TextView &text, GenericTLV *generic)
+{
+    int64_t value;
+
+    if (!ParseInt(text.data, text.length, value) || value < INT32_MIN || value > INT32_MAX) {
+        return false;
+    }
+
+    generic->type = CONFIG_INT;
+    generic->value.int_value = (int)value;
+    generic->length = sizeof(int);
+
+    return true;
+}
+
+inline bool ParseUintValue(const TextView &text, GenericTLV *generic)
+{
+    int64_t value;
+
+    if (!ParseInt(text.data, text.length, value) || value < 0 || value > UINT32_MAX) {
+        return false;
+    }
+
+    generic->type = CONFIG_UINT;
+    generic->value.int_value = (int)(uint32_t)value;
+    generic->length = sizeof(int);
+
+    return true;
+}
+
+inline bool ParseBoolValue(const TextView &text, GenericTLV *generic)
+{
+    bool value;
+
+    if (!ParseBool(text.data, text.length, value)) {
+        return false;
+    }
+
+    generic->type = CONFIG_BOOL;
+    generic->value.bool_value = value ? 1 : 0;
+    generic->length = sizeof(uint8_t);
+
+    return true;
+}
+
+inline bool ParseStringValue(const TextView &text, GenericTLV *generic)
+{
+    generic->type = CONFIG_STRING;
+    generic_set_string(generic, &(generic->value.string_value), text.data);
+    generic->length = text.length;
+
+    return true;
+}
+
+/**
+ * Picks the parse routine for a ProSim element
+ *
+ * - by default from the first letter of the name through a 256 entry
+ *   table (G_ gauges are floats, I_ indicators bools and so on)
+ * - elements whose prefix does not match their type can be given an
+ *   explicit type in prepare3d.cfg, these overrides are looked up by
+ *   symbol like the transforms
+ */
+class ProsimValueParser
+{
+protected:
+    ValueParseFunction _byIdentifier[256];
+    std::map<std::string, ValueParseFunction> _overrides;
+    SymbolIndex<ValueParseFunction> _overridesBySymbol;
+
+public:
+    ProsimValueParser(void)
+    {
+        // unknown prefixes are passed on as strings
+        for (int i = 0; i < 256; i++) {
+            _byIdentifier[i] = ParseStringValue;
+        }
+
+        _byIdentifier[(unsigned char)GAUGE_IDENTIFIER] = ParseFloatValue;
+        _byIdentifier[(unsigned char)NUMBER_IDENTIFIER] = ParseIntValue;
+        _byIdentifier[(unsigned char)INDICATOR_IDENTIFIER] = ParseBoolValue;
+        _byIdentifier[(unsigned char)VALUE_IDENTIFIER] = ParseUintValue;
+        _byIdentifier[(unsigned char)ANALOG_IDENTIFIER] = ParseStringValue;
+        _byIdentifier[(unsigned char)ROTARY_IDENTIFIER] = ParseStringValue;
+        _byIdentifier[(unsigned char)BOOLEAN_IDENTIFIER] = ParseBoolValue;
+        _byIdentifier[(unsigned char)SWITCH_IDENTIFIER] = ParseBoolValue;
+        _byIdentifier[(unsigned char)ENCODER_IDENTIFIER] = ParseFloatValue;
+    };
+
+    //! "float", "int", "uint", "bool" or "string" ("char"), NULL for anything else
+    static ValueParseFunction ForTypeName(const std::string &type)
+    {
+        if (type == "float") {
+            return ParseFloatValue;
+        }
+        else if (type == "int") {
+            return ParseIntValue;
+        }
+        else if (type == "uint") {
+            return ParseUintValue;
+        }
+        else if (type == "bool") {
+            return ParseBoolValue;
+        }
+        else if (type == "string" || type == "char") {
+            return ParseStringValue;
+        }
+
+        return NULL;
+    }
+
+    //! returns false for an unknown type
+    bool setOverride(const std::string &name, SymbolId symbol, const std::string &type)
+    {
+        ValueParseFunction parse = ForTypeName(type);
+
+        if (!parse) {
+            return false;
+        }
+
+        _overrides[name] = parse;
+        _overridesBySymbol.set(symbol, parse);
+
+        return true;
+    }
+
+    ValueParseFunction parserFor(const std::string &name, SymbolId symbol)
+    {
+        if (!_overrides.empty()) {
+            ValueParseFunction *parse = _overridesBySymbol.find(symbol);
+
+            if (parse) {
+                return *parse;
+            }
+
+            if (symbol == SYMBOL_UNRESOLVED) {
+                std::map<std::string, ValueParseFunction>::iterator it = _overrides.find(name);
+
+                if (it != _overrides.end()) {
+                    return it->second;
+                }
+            }
+        }
+
+        return name.empty() ? ParseStringValue : _byIdentifier[(unsigned char)name[0]];
+    }
+
+    size_t overrideCount(void) const { return _overrides.size(); };
+};
+
+#endif
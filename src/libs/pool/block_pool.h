@@ -0,0 +1,211 @@
+#ifndef __BLOCK_POOL_H
+#define __BLOCK_POOL_H
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <vector>
+
+#define BLOCK_POOL_BATCH_SIZE 64
+#define BLOCK_POOL_MAX_DEPOT_BATCHES 64
+#define BLOCK_POOL_ALIGNMENT 16
+
+/**
+ * Fixed size block pool for the event hot path
+ *
+ * - every thread keeps a small cache of free blocks, so allocating and
+ *   releasing is a pointer push/pop with no locking in the steady state
+ * - a thread with too many free blocks (the consumer releasing what
+ *   producers allocated) hands a batch of them to a global depot, a
+ *   thread that runs dry takes a whole batch back - the depot lock is
+ *   taken once per BLOCK_POOL_BATCH_SIZE blocks
+ * - blocks are individually malloc()ed and the depot is bounded, excess
+ *   blocks go back to the system with free(). This keeps the pool safe
+ *   across the plugin boundary where each shared library has its own
+ *   instance: a block allocated by one instance can be released into
+ *   any other
+ */
+template <size_t BLOCK_SIZE> class BlockPool
+{
+protected:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct FreeList {
+        FreeBlock *head;
+        size_t count;
+    };
+
+    //! per thread free list, returned to the depot when the thread exits
+    struct ThreadCache {
+        FreeList blocks;
+
+        ThreadCache(void)
+            : blocks({NULL, 0}){};
+
+        ~ThreadCache(void)
+        {
+            while (blocks.count > 0) {
+                BlockPool::Instance().depositBatch(blocks, blocks.count < BLOCK_POOL_BATCH_SIZE ? blocks.count : BLOCK_POOL_BATCH_SIZE);
+            }
+        }
+    };
+
+    std::mutex _depotMutex;
+    std::vector<FreeList> _depot;
+    std::atomic<uint64_t> _systemAllocations;
+    std::atomic<uint64_t> _systemReleases;
+
+    static ThreadCache &Cache(void)
+    {
+        static thread_local ThreadCache cache;
+        return cache;
+    }
+
+    //! move count blocks from the head of list into the depot
+    void depositBatch(FreeList &list, size_t count)
+    {
+        FreeList batch = {list.head, count};
+        FreeBlock *tail = list.head;
+
+        for (size_t i = 1; i < count; i++) {
+            tail = tail->next;
+        }
+
+        list.head = tail->next;
+        list.count -= count;
+        tail->next = NULL;
+
+        {
+            std::lock_guard<std::mutex> depotGuard(_depotMutex);
+
+            if (_depot.size() < BLOCK_POOL_MAX_DEPOT_BATCHES) {
+                _depot.push_back(batch);
+                return;
+            }
+        }
+
+        // depot is full - give the batch back to the system
+        while (batch.head) {
+            FreeBlock *next = batch.head->next;
+            free(batch.head);
+            batch.head = next;
+            _systemReleases++;
+        }
+    }
+
+    bool withdrawBatch(FreeList &list)
+    {
+        std::lock_guard<std::mutex> depotGuard(_depotMutex);
+
+        if (_depot.empty()) {
+            return false;
+        }
+
+        list = _depot.back();
+        _depot.pop_back();
+
+        return true;
+    }
+
+    BlockPool(void)
+        : _systemAllocations(0)
+        , _systemReleases(0){};
+
+public:
+    static const size_t blockSize = (BLOCK_SIZE + BLOCK_POOL_ALIGNMENT - 1) & ~(size_t)(BLOCK_POOL_ALIGNMENT - 1);
+
+    //! deliberately never destroyed, thread caches may outlive static destruction
+    static BlockPool &Instance(void)
+    {
+        static BlockPool *pool = new BlockPool();
+        return *pool;
+    }
+
+    void *allocate(void)
+    {
+        FreeList &cache = Cache().blocks;
+
+        if (cache.count == 0 && !withdrawBatch(cache)) {
+            void *retVal = malloc(blockSize);
+
+            if (!retVal) {
+                throw std::bad_alloc();
+            }
+
+            _systemAllocations++;
+            return retVal;
+        }
+
+        FreeBlock *retVal = cache.head;
+        cache.head = retVal->next;
+        cache.count--;
+
+        return retVal;
+    }
+
+    void release(void *block)
+    {
+        if (!block) {
+            return;
+        }
+
+        FreeList &cache = Cache().blocks;
+        FreeBlock *freeBlock = static_cast<FreeBlock *>(block);
+
+        freeBlock->next = cache.head;
+        cache.head = freeBlock;
+        cache.count++;
+
+        if (cache.count >= 2 * BLOCK_POOL_BATCH_SIZE) {
+            depositBatch(cache, BLOCK_POOL_BATCH_SIZE);
+        }
+    }
+
+    //! number of blocks this instance had to malloc()
+    uint64_t systemAllocations(void) { return _systemAllocations; }
+    //! number of blocks this instance gave back with free()
+    uint64_t systemReleases(void) { return _systemReleases; }
+};
+
+/**
+ * STL allocator on top of BlockPool - single object allocations come
+ * from the pool of the matching size class, anything else (arrays)
+ * falls through to operator new. Meant for std::allocate_shared so the
+ * object and its control block share one pooled block.
+ */
+template <typename T> class PoolAllocator
+{
+public:
+    typedef T value_type;
+
+    PoolAllocator(void) noexcept {};
+    template <typename U> PoolAllocator(const PoolAllocator<U> &) noexcept {};
+
+    T *allocate(size_t n)
+    {
+        if (n == 1) {
+            return static_cast<T *>(BlockPool<sizeof(T)>::Instance().allocate());
+        }
+
+        return static_cast<T *>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T *p, size_t n)
+    {
+        if (n == 1) {
+            BlockPool<sizeof(T)>::Instance().release(p);
+        }
+        else {
+            ::operator delete(p);
+        }
+    }
+
+    template <typename U> bool operator==(const PoolAllocator<U> &) const noexcept { return true; }
+    template <typename U> bool operator!=(const PoolAllocator<U> &) const noexcept { return false; }
+};
+
+#endif
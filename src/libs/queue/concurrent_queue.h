@@ -62,6 +62,17 @@ public:
         cond_.notify_one();
     }
 
+    //! push a run of items under a single lock acquisition
+    template <typename It> void push(It first, It last)
+    {
+        std::unique_lock<std::mutex> mlock(mutex_);
+        for (; first != last; ++first) {
+            queue_.push(*first);
+        }
+        mlock.unlock();
+        cond_.notify_one();
+    }
+
     ConcurrentQueue()
         : terminated_(false){};
     ConcurrentQueue(const ConcurrentQueue &) = delete; // disable copying
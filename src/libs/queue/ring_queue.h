@@ -0,0 +1,461 @@
+#ifndef __RING_QUEUE_H
+#define __RING_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrent_queue.h"
+
+//! what a producer does when it finds the ring full
+typedef enum { OVERFLOW_BLOCK = 0, OVERFLOW_DROP_OLDEST, OVERFLOW_DROP_NEWEST } QueueOverflowPolicy;
+
+#define RING_QUEUE_DEFAULT_CAPACITY 4096
+#define RING_QUEUE_SPIN_COUNT 64
+#define RING_QUEUE_CACHE_LINE 64
+
+//! parses the config file spelling of an overflow policy, falls back to OVERFLOW_BLOCK
+inline QueueOverflowPolicy QueueOverflowPolicyFromString(std::string policy)
+{
+    if (policy == "drop_oldest") {
+        return OVERFLOW_DROP_OLDEST;
+    }
+    else if (policy == "drop_newest") {
+        return OVERFLOW_DROP_NEWEST;
+    }
+
+    return OVERFLOW_BLOCK;
+}
+
+/**
+ * Parking spot for the single consumer of one or more ring queues.
+ *
+ * Producers only touch the mutex/condition variable when the consumer
+ * has announced that it is about to sleep, so a busy consumer costs
+ * producers one atomic load per push. The announce/re-check/notify
+ * sequence is ordered with seq_cst so either the consumer sees the
+ * new element or the producer sees the idle flag - never neither.
+ */
+class QueueWaiter
+{
+protected:
+    std::mutex _mutex;
+    std::condition_variable _cond;
+    std::atomic<bool> _idle;
+
+public:
+    QueueWaiter(void)
+        : _idle(false){};
+
+    //! called by producers after publishing an element
+    void notify(void)
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (_idle.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _cond.notify_one();
+        }
+    }
+
+    //! wakes the consumer unconditionally (shutdown)
+    void notifyAll(void)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _cond.notify_all();
+    }
+
+    /**
+     * block the consumer until ready() returns true - ready is always
+     * evaluated once after the idle flag is raised so that a push racing
+     * with the decision to sleep is never missed
+     */
+    template <typename P> void wait(P ready)
+    {
+        _idle.store(true, std::memory_order_seq_cst);
+
+        if (!ready()) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _cond.wait(lock, ready);
+        }
+
+        _idle.store(false, std::memory_order_relaxed);
+    }
+
+    //! as above but gives up after timeout, returns the final value of ready()
+    template <typename P> bool waitFor(P ready, std::chrono::microseconds timeout)
+    {
+        bool retVal = true;
+
+        _idle.store(true, std::memory_order_seq_cst);
+
+        if (!ready()) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            retVal = _cond.wait_for(lock, timeout, ready);
+        }
+
+        _idle.store(false, std::memory_order_relaxed);
+
+        return retVal;
+    }
+};
+
+/**
+ * Bounded lock-free multi-producer ring queue (after Dmitry Vyukov's
+ * bounded MPMC design) intended for a single consumer thread.
+ *
+ * - each cell carries a sequence number, producers claim a slot with
+ *   one CAS on the enqueue cursor and publish with a release store so
+ *   there is no shared lock between producers or with the consumer
+ * - the consumer only sleeps (via QueueWaiter) when the ring is empty
+ * - the overflow policy decides what happens when the ring is full
+ * - unblock() has the same semantics as ConcurrentQueue::unblock(),
+ *   pending and future pops throw ConcurrentQueueInterrupted
+ */
+template <typename T> class RingQueue
+{
+protected:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> _buffer;
+    size_t _mask;
+    QueueOverflowPolicy _overflowPolicy;
+    std::shared_ptr<QueueWaiter> _waiter;
+    std::function<void(T &)> _dropHandler;
+
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<size_t> _enqueuePos;
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<size_t> _dequeuePos;
+    alignas(RING_QUEUE_CACHE_LINE) std::atomic<bool> _terminated;
+    std::atomic<uint64_t> _droppedCount;
+
+    //! blocked producers park here when the policy is OVERFLOW_BLOCK
+    std::atomic<int> _blockedProducers;
+    std::mutex _notFullMutex;
+    std::condition_variable _notFullCond;
+    std::chrono::milliseconds _blockTimeout; ///< 0 blocks until there is room
+    QueueOverflowPolicy _blockFallback; ///< what a producer that timed out blocking does, drop newest or oldest
+
+    void allocate(size_t capacity)
+    {
+        size_t size = 2;
+
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        _buffer.reset(new Cell[size]);
+        _mask = size - 1;
+
+        for (size_t i = 0; i < size; i++) {
+            _buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        _enqueuePos.store(0, std::memory_order_relaxed);
+        _dequeuePos.store(0, std::memory_order_relaxed);
+    }
+
+    template <typename U> bool tryEnqueue(U &&item)
+    {
+        Cell *cell;
+        size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &_buffer[pos & _mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+
+            if (dif == 0) {
+                if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (dif < 0) {
+                return false; // full
+            }
+            else {
+                pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::forward<U>(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool tryDequeue(T &item)
+    {
+        Cell *cell;
+        size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &_buffer[pos & _mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)(pos + 1);
+
+            if (dif == 0) {
+                if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            else if (dif < 0) {
+                return false; // empty
+            }
+            else {
+                pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->data = T(); // drop any reference the slot still holds
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+
+        wakeBlockedProducers();
+
+        return true;
+    }
+
+    void wakeBlockedProducers(void)
+    {
+        if (_overflowPolicy == OVERFLOW_BLOCK) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            if (_blockedProducers.load(std::memory_order_relaxed) > 0) {
+                std::lock_guard<std::mutex> lock(_notFullMutex);
+                _notFullCond.notify_all();
+            }
+        }
+    }
+
+    bool hasSpace(void) { return size() <= _mask; }
+
+    //! evicts from the head until item fits
+    template <typename U> bool evictAndEnqueue(U &&item)
+    {
+        T discarded;
+
+        // the dequeue side of the ring is safe for concurrent callers
+        while (!tryEnqueue(std::forward<U>(item))) {
+            if (tryDequeue(discarded)) {
+                _droppedCount++;
+
+                if (_dropHandler) {
+                    _dropHandler(discarded);
+                }
+            }
+        }
+
+        _waiter->notify();
+        return true;
+    }
+
+    template <typename U> bool enqueue(U &&item)
+    {
+        if (_terminated) {
+            return false;
+        }
+
+        if (tryEnqueue(std::forward<U>(item))) {
+            _waiter->notify();
+            return true;
+        }
+
+        switch (_overflowPolicy) {
+        case OVERFLOW_DROP_NEWEST:
+            _droppedCount++;
+            return false;
+
+        case OVERFLOW_DROP_OLDEST:
+            return evictAndEnqueue(std::forward<U>(item));
+
+        case OVERFLOW_BLOCK:
+        default:
+            for (int spin = 0; spin < RING_QUEUE_SPIN_COUNT; spin++) {
+                std::this_thread::yield();
+
+                if (tryEnqueue(std::forward<U>(item))) {
+                    _waiter->notify();
+                    return true;
+                }
+            }
+
+            _blockedProducers++;
+
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + _blockTimeout;
+            bool timedOut = false;
+
+            while (!_terminated) {
+                if (tryEnqueue(std::forward<U>(item))) {
+                    _blockedProducers--;
+                    _waiter->notify();
+                    return true;
+                }
+
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                std::unique_lock<std::mutex> lock(_notFullMutex);
+
+                if (_blockTimeout.count() == 0) {
+                    _notFullCond.wait(lock, [this] { return _terminated || hasSpace(); });
+                }
+                else if (!_notFullCond.wait_until(lock, deadline, [this] { return _terminated || hasSpace(); })) {
+                    timedOut = true;
+                    break;
+                }
+            }
+
+            _blockedProducers--;
+
+            // still full - make room unless the element is dropped as the newest
+            if (timedOut && _blockFallback == OVERFLOW_DROP_OLDEST) {
+                return evictAndEnqueue(std::forward<U>(item));
+            }
+
+            _droppedCount++;
+            return false;
+        }
+    }
+
+public:
+    RingQueue(size_t capacity = RING_QUEUE_DEFAULT_CAPACITY, QueueOverflowPolicy overflowPolicy = OVERFLOW_BLOCK, std::shared_ptr<QueueWaiter> waiter = nullptr)
+        : _overflowPolicy(overflowPolicy)
+        , _waiter(waiter ? waiter : std::make_shared<QueueWaiter>())
+        , _terminated(false)
+        , _droppedCount(0)
+        , _blockedProducers(0)
+        , _blockTimeout(0)
+        , _blockFallback(OVERFLOW_DROP_NEWEST)
+    {
+        allocate(capacity);
+    };
+
+    RingQueue(const RingQueue &) = delete; // disable copying
+    RingQueue &operator=(const RingQueue &) = delete; // disable assignment
+
+    /**
+     * re-dimension the ring - only valid before any producer or consumer
+     * has started using the queue (e.g. straight after config load)
+     */
+    void configure(size_t capacity, QueueOverflowPolicy overflowPolicy)
+    {
+        _overflowPolicy = overflowPolicy;
+        allocate(capacity);
+    }
+
+    /**
+     * longest a producer waits for room under OVERFLOW_BLOCK, 0 (the
+     * default) waits indefinitely - after that the element is dropped
+     * (fallback OVERFLOW_DROP_NEWEST) or the oldest elements are evicted
+     * to make room for it (OVERFLOW_DROP_OLDEST), either way counted as
+     * dropped
+     */
+    void setBlockTimeout(std::chrono::milliseconds timeout, QueueOverflowPolicy fallback = OVERFLOW_DROP_NEWEST)
+    {
+        _blockTimeout = timeout;
+        _blockFallback = fallback == OVERFLOW_DROP_OLDEST ? OVERFLOW_DROP_OLDEST : OVERFLOW_DROP_NEWEST;
+    }
+
+    //! called with every element evicted under OVERFLOW_DROP_OLDEST (on the evicting producer's thread)
+    void setDropHandler(std::function<void(T &)> dropHandler) { _dropHandler = dropHandler; }
+
+    //! returns false if the element was not queued (drop-newest overflow or shutdown)
+    bool push(const T &item) { return enqueue(item); }
+    bool push(T &&item) { return enqueue(std::move(item)); }
+
+    //! blocking pop - throws ConcurrentQueueInterrupted once unblock() was called
+    T pop(void)
+    {
+        T item;
+        pop(item);
+        return item;
+    }
+
+    void pop(T &item)
+    {
+        while (!_terminated) {
+            if (tryDequeue(item)) {
+                return;
+            }
+
+            _waiter->wait([this] { return _terminated || !empty(); });
+        }
+
+        throw ConcurrentQueueInterrupted();
+    }
+
+    /**
+     * batched pop - blocks like pop() for the first element, then keeps
+     * appending to batch until maxItems have been taken or linger has
+     * elapsed since the first element arrived, whichever comes first
+     *
+     * - a zero linger takes whatever is already queued without waiting
+     * - returns the number of elements appended to batch
+     */
+    size_t popBatch(std::vector<T> &batch, size_t maxItems, std::chrono::microseconds linger)
+    {
+        T item;
+        size_t count = 1;
+
+        pop(item);
+        batch.push_back(std::move(item));
+
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + linger;
+
+        while (count < maxItems) {
+            if (tryDequeue(item)) {
+                batch.push_back(std::move(item));
+                count++;
+                continue;
+            }
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            if (_terminated || now >= deadline) {
+                break;
+            }
+
+            _waiter->waitFor([this] { return _terminated || !empty(); }, std::chrono::duration_cast<std::chrono::microseconds>(deadline - now));
+        }
+
+        return count;
+    }
+
+    //! non-blocking pop
+    bool tryPop(T &item) { return tryDequeue(item); }
+
+    //! provide way to interrupt the blocking wait in "pop" member(s)
+    void unblock(void)
+    {
+        _terminated = true;
+        _waiter->notifyAll();
+
+        std::lock_guard<std::mutex> lock(_notFullMutex);
+        _notFullCond.notify_all();
+    }
+
+    bool terminated(void) { return _terminated; }
+    bool empty(void) { return size() == 0; }
+    size_t capacity(void) { return _mask + 1; }
+    QueueOverflowPolicy overflowPolicy(void) { return _overflowPolicy; }
+    uint64_t droppedCount(void) { return _droppedCount; }
+    std::shared_ptr<QueueWaiter> waiter(void) { return _waiter; }
+
+    //! approximate number of queued elements (exact when quiescent)
+    size_t size(void)
+    {
+        size_t tail = _dequeuePos.load(std::memory_order_acquire);
+        size_t head = _enqueuePos.load(std::memory_order_acquire);
+        return head > tail ? head - tail : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "plugins/common/backoff.h"
+
+TEST(BackoffTest, GrowsExponentiallyUpToTheMaximum)
+{
+    Backoff backoff(100, 1000, 2.0, 0.0);
+
+    EXPECT_EQ(100u, backoff.next());
+    EXPECT_EQ(200u, backoff.next());
+    EXPECT_EQ(400u, backoff.next());
+    EXPECT_EQ(800u, backoff.next());
+    EXPECT_EQ(1000u, backoff.next());
+    EXPECT_EQ(1000u, backoff.next());
+    EXPECT_EQ(6u, backoff.attempts());
+}
+
+TEST(BackoffTest, JitterStaysWithinTheCeiling)
+{
+    Backoff backoff(1000, 1000, 2.0, 0.5);
+
+    backoff.seed(42);
+
+    for (int i = 0; i < 1000; i++) {
+        uint64_t delay = backoff.next();
+
+        EXPECT_GE(delay, 500u);
+        EXPECT_LE(delay, 1000u);
+    }
+}
+
+TEST(BackoffTest, JitterSpreadsTheDelays)
+{
+    Backoff first(1000, 1000, 2.0, 0.5);
+    Backoff second(1000, 1000, 2.0, 0.5);
+    int differing = 0;
+
+    first.seed(1);
+    second.seed(2);
+
+    for (int i = 0; i < 100; i++) {
+        differing += first.next() != second.next();
+    }
+
+    EXPECT_GT(differing, 90);
+}
+
+TEST(BackoffTest, ResetStartsOver)
+{
+    Backoff backoff(100, 10000, 3.0, 0.0);
+
+    backoff.next();
+    backoff.next();
+    backoff.next();
+    backoff.reset();
+
+    EXPECT_EQ(0u, backoff.attempts());
+    EXPECT_EQ(100u, backoff.next());
+}
+
+TEST(BackoffTest, ClampsConfiguration)
+{
+    Backoff backoff(0, 0, 0.5, 2.0);
+
+    EXPECT_EQ(1u, backoff.initial());
+    EXPECT_EQ(1u, backoff.maximum());
+    EXPECT_EQ(1u, backoff.next());
+    EXPECT_EQ(1u, backoff.next());
+}
@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "elements/attributes/attribute.h"
+#include "plugins/common/simhubdeviceplugin.h"
+
+static int blockPoolTestOwner;
+
+TEST(BlockPoolTest, ReleasedBlocksAreReused)
+{
+    BlockPool<64> &pool = BlockPool<64>::Instance();
+
+    void *first = pool.allocate();
+    pool.release(first);
+
+    EXPECT_EQ(first, pool.allocate());
+}
+
+TEST(BlockPoolTest, GenericStringsLiveInArena)
+{
+    GenericTLV *generic = make_string_generic("S_TEST", "description", "value");
+
+    EXPECT_EQ(true, generic_owns_string(generic, generic->name));
+    EXPECT_EQ(true, generic_owns_string(generic, generic->description));
+    EXPECT_EQ(true, generic_owns_string(generic, generic->value.string_value));
+    EXPECT_EQ(std::string("value"), generic->value.string_value);
+
+    release_generic(generic);
+}
+
+TEST(BlockPoolTest, LongGenericStringsFallBackToHeap)
+{
+    GenericTLV *generic = make_generic("N_TEST", "-");
+    std::string longValue(GENERIC_ARENA_SIZE * 2, 'x');
+
+    generic_set_string(generic, &(generic->units), longValue.c_str());
+
+    EXPECT_EQ(false, generic_owns_string(generic, generic->units));
+    EXPECT_EQ(longValue, generic->units);
+
+    release_generic(generic);
+}
+
+TEST(BlockPoolTest, PooledAttributeRoundTrip)
+{
+    GenericTLV *generic = make_string_generic("S_TEST", "-", "hello");
+    generic->ownerPlugin = &blockPoolTestOwner;
+    generic->symbol = 7;
+
+    std::shared_ptr<Attribute> attribute = AttributeFromCGeneric(generic);
+    release_generic(generic);
+
+    GenericTLV *delivered = AttributeToCGeneric(attribute);
+
+    EXPECT_EQ(std::string("S_TEST"), delivered->name);
+    EXPECT_EQ(CONFIG_STRING, delivered->type);
+    EXPECT_EQ(std::string("hello"), delivered->value.string_value);
+    EXPECT_EQ(7, delivered->symbol);
+
+    release_generic(delivered);
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "conflation/conflationStage.h"
+
+static SymbolTable conflationTestSymbols;
+
+static EventRecord makeIntRecord(std::string name, int value)
+{
+    EventRecord record;
+    record.symbol = conflationTestSymbols.intern(name);
+    record.setInt(value);
+    record.resetTimestamp();
+    return record;
+}
+
+TEST(ConflationTest, FirstUpdateIsQueued)
+{
+    ConflationStage conflation;
+
+    EXPECT_EQ(true, conflation.offer(makeIntRecord("G_TEST", 1)));
+    EXPECT_EQ(1, conflation.pendingCount());
+    EXPECT_EQ(0, conflation.coalescedCount());
+}
+
+TEST(ConflationTest, LatestPendingValueWins)
+{
+    ConflationStage conflation;
+    EventRecord queued = makeIntRecord("G_TEST", 1);
+
+    EXPECT_EQ(true, conflation.offer(queued));
+    EXPECT_EQ(false, conflation.offer(makeIntRecord("G_TEST", 2)));
+    EXPECT_EQ(false, conflation.offer(makeIntRecord("G_TEST", 3)));
+
+    conflation.claim(queued);
+
+    EXPECT_EQ(3, queued.value.intValue);
+    EXPECT_EQ(0, conflation.pendingCount());
+    EXPECT_EQ(2, conflation.coalescedCount());
+    EXPECT_EQ(2, conflation.coalescedCounts()[conflationTestSymbols.find("G_TEST")]);
+
+    // claimed, so the next update is queued again
+    EXPECT_EQ(true, conflation.offer(makeIntRecord("G_TEST", 4)));
+}
+
+TEST(ConflationTest, ElementsAreIndependent)
+{
+    ConflationStage conflation;
+    EventRecord first = makeIntRecord("G_ONE", 1);
+    EventRecord second = makeIntRecord("N_TWO", 10);
+
+    EXPECT_EQ(true, conflation.offer(first));
+    EXPECT_EQ(true, conflation.offer(second));
+    EXPECT_EQ(false, conflation.offer(makeIntRecord("N_TWO", 11)));
+
+    conflation.claim(first);
+    conflation.claim(second);
+
+    EXPECT_EQ(1, first.value.intValue);
+    EXPECT_EQ(11, second.value.intValue);
+}
+
+TEST(ConflationTest, ClaimLeavesUnconflatedEventsAlone)
+{
+    ConflationStage conflation;
+    EventRecord event = makeIntRecord("S_SWITCH", 1);
+    EventRecord original = event;
+
+    conflation.offer(makeIntRecord("G_TEST", 1));
+    conflation.claim(event);
+
+    EXPECT_EQ(original.symbol, event.symbol);
+    EXPECT_EQ(original.value.intValue, event.value.intValue);
+    EXPECT_EQ(1, conflation.pendingCount());
+}
+
+TEST(ConflationTest, CancelReleasesPendingElement)
+{
+    ConflationStage conflation;
+
+    EXPECT_EQ(true, conflation.offer(makeIntRecord("G_TEST", 1)));
+    conflation.cancel(conflationTestSymbols.find("G_TEST"));
+
+    EXPECT_EQ(0, conflation.pendingCount());
+    EXPECT_EQ(true, conflation.offer(makeIntRecord("G_TEST", 2)));
+}
+
+TEST(ConflationTest, UnresolvedEventsAreNeverConflated)
+{
+    ConflationStage conflation;
+    EventRecord event = makeIntRecord("G_TEST", 1);
+
+    event.symbol = SYMBOL_UNRESOLVED;
+
+    EXPECT_EQ(true, conflation.offer(event));
+    EXPECT_EQ(true, conflation.offer(event));
+    EXPECT_EQ(0, conflation.pendingCount());
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "plugins/common/delimiterscanner.h"
+
+static bool SameRecords(const DelimiterIndex &expected, const DelimiterIndex &actual)
+{
+    if (expected.records.size() != actual.records.size() || expected.pendingAssign != actual.pendingAssign) {
+        return false;
+    }
+
+    for (size_t i = 0; i < expected.records.size(); i++) {
+        if (expected.records[i].assign != actual.records[i].assign || expected.records[i].end != actual.records[i].end) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//! every level the cpu running the tests supports
+static std::vector<ScanLevel> SupportedScanLevels(void)
+{
+    std::vector<ScanLevel> levels;
+
+    for (ScanLevel level : {SCAN_SCALAR, SCAN_SSE2, SCAN_AVX2}) {
+        if (DelimiterScanner::Supported(level)) {
+            levels.push_back(level);
+        }
+    }
+
+    return levels;
+}
+
+TEST(DelimiterScannerTest, IndexesRecords)
+{
+    std::string data = "N_ONE = 1\nNO_ASSIGN\nV_TWO = a=b\nG_THREE";
+
+    for (ScanLevel level : SupportedScanLevels()) {
+        DelimiterScanner scanner(level);
+        DelimiterIndex index;
+
+        scanner.scan(data.data(), data.size(), 100, index);
+
+        ASSERT_EQ(3, index.records.size()) << DelimiterScanner::LevelName(level);
+        EXPECT_EQ(106, index.records[0].assign);
+        EXPECT_EQ(109, index.records[0].end);
+        EXPECT_EQ(DELIMITER_NONE, index.records[1].assign);
+        EXPECT_EQ(119, index.records[1].end);
+        // only the first '=' of a record counts
+        EXPECT_EQ(126, index.records[2].assign);
+        EXPECT_EQ(131, index.records[2].end);
+        EXPECT_EQ(DELIMITER_NONE, index.pendingAssign);
+    }
+}
+
+TEST(DelimiterScannerTest, FallsBackToSupportedLevel)
+{
+    DelimiterScanner scanner(SCAN_AVX2);
+
+    EXPECT_TRUE(DelimiterScanner::Supported(scanner.level()));
+    EXPECT_TRUE(DelimiterScanner::Supported(SCAN_SCALAR));
+    EXPECT_TRUE(DelimiterScanner::Supported(DelimiterScanner::BestLevel()));
+}
+
+//! every length up to a few vector blocks at every alignment, delimiter dense and sparse
+TEST(DelimiterScannerTest, VectorPathsMatchScalar)
+{
+    std::mt19937 random(4242);
+    std::vector<char> buffer(512 + 64);
+    DelimiterScanner scalar(SCAN_SCALAR);
+
+    for (int density : {2, 8, 64}) {
+        for (char &c : buffer) {
+            int pick = random() % density;
+            c = pick == 0 ? '\n' : (pick == 1 ? '=' : (char)('A' + random() % 26));
+        }
+
+        for (ScanLevel level : SupportedScanLevels()) {
+            DelimiterScanner scanner(level);
+
+            for (size_t alignment = 0; alignment < 64; alignment++) {
+                for (size_t length = 0; length + alignment <= buffer.size() && length <= 200; length++) {
+                    DelimiterIndex expected;
+                    DelimiterIndex actual;
+
+                    scalar.scan(buffer.data() + alignment, length, 7, expected);
+                    scanner.scan(buffer.data() + alignment, length, 7, actual);
+
+                    ASSERT_TRUE(SameRecords(expected, actual)) << DelimiterScanner::LevelName(level) << " alignment " << alignment << " length " << length << " density " << density;
+                }
+            }
+        }
+    }
+}
+
+TEST(DelimiterScannerTest, PiecewiseScanMatchesWholeScan)
+{
+    std::string data;
+
+    for (int i = 0; i < 40; i++) {
+        data += "E_ELEMENT_" + std::to_string(i) + " = " + std::to_string(i * 13) + "\n";
+    }
+
+    for (ScanLevel level : SupportedScanLevels()) {
+        DelimiterScanner scanner(level);
+        DelimiterIndex whole;
+
+        scanner.scan(data.data(), data.size(), 0, whole);
+
+        for (size_t split = 0; split <= data.size(); split++) {
+            DelimiterIndex pieces;
+
+            scanner.scan(data.data(), split, 0, pieces);
+            scanner.scan(data.data() + split, data.size() - split, split, pieces);
+
+            ASSERT_TRUE(SameRecords(whole, pieces)) << DelimiterScanner::LevelName(level) << " split " << split;
+        }
+    }
+}
+
+TEST(DelimiterScannerTest, ShiftMovesPendingAssign)
+{
+    DelimiterIndex index;
+    std::string partial = "N_PARTIAL = 4";
+
+    DelimiterScanner().scan(partial.data(), partial.size(), 20, index);
+    ASSERT_EQ(30, index.pendingAssign);
+
+    index.shift(20);
+    EXPECT_EQ(10, index.pendingAssign);
+    EXPECT_TRUE(index.records.empty());
+}
@@ -0,0 +1,186 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "delivery/deliveryWorker.h"
+
+static GenericTLV *makeDeliveryValue(int value)
+{
+    GenericTLV *retVal = make_generic("I_TEST", "delivery test");
+    retVal->type = CONFIG_INT;
+    retVal->value.int_value = value;
+    return retVal;
+}
+
+TEST(DeliveryWorkerTest, DeliversInOrder)
+{
+    std::mutex deliveredMutex;
+    std::vector<int> delivered;
+    DeliveryOptions options;
+
+    options.batchSize = 4;
+
+    DeliveryWorker worker("test", options, [&](std::vector<GenericTLV *> &values) {
+        std::lock_guard<std::mutex> guard(deliveredMutex);
+
+        for (GenericTLV *value : values) {
+            delivered.push_back(value->value.int_value);
+        }
+
+        return true;
+    });
+
+    worker.start();
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(true, worker.push(makeDeliveryValue(i)));
+    }
+
+    while (worker.delivered() < 100) {
+        std::this_thread::yield();
+    }
+
+    worker.stop();
+
+    ASSERT_EQ(100, delivered.size());
+
+    for (int i = 0; i < 100; i++) {
+        EXPECT_EQ(i, delivered[i]);
+    }
+
+    EXPECT_EQ(100, worker.queueLatencyHistogram().count());
+    EXPECT_EQ(100, worker.queueLatency().count());
+    EXPECT_EQ(false, worker.failed());
+}
+
+TEST(DeliveryWorkerTest, SlowDestinationDropsOldestWhenFull)
+{
+    std::mutex gateMutex;
+    std::condition_variable gateCond;
+    bool open = false;
+    std::atomic<int> lastDelivered(-1);
+    DeliveryOptions options;
+
+    options.queueDepth = 4;
+    options.overflowPolicy = OVERFLOW_DROP_OLDEST;
+    options.batchSize = 1;
+
+    // the plugin call blocks until the gate opens, like a stalled device write
+    DeliveryWorker worker("slow", options, [&](std::vector<GenericTLV *> &values) {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gateCond.wait(lock, [&] { return open; });
+        lastDelivered = values.back()->value.int_value;
+        return true;
+    });
+
+    worker.start();
+    worker.push(makeDeliveryValue(0));
+
+    // wait for the worker to take the first value into the stalled call
+    while (worker.depth() > 0) {
+        std::this_thread::yield();
+    }
+
+    for (int i = 1; i <= 10; i++) {
+        EXPECT_EQ(true, worker.push(makeDeliveryValue(i)));
+    }
+
+    EXPECT_EQ(4, worker.depth());
+    EXPECT_EQ(6, worker.dropped());
+
+    {
+        std::lock_guard<std::mutex> guard(gateMutex);
+        open = true;
+    }
+
+    gateCond.notify_all();
+
+    while (worker.delivered() < 5) {
+        std::this_thread::yield();
+    }
+
+    worker.stop();
+
+    EXPECT_EQ(10, lastDelivered);
+}
+
+TEST(DeliveryWorkerTest, DefaultsToDroppingOldest)
+{
+    DeliveryOptions options;
+
+    EXPECT_EQ(OVERFLOW_DROP_OLDEST, options.overflowPolicy);
+    EXPECT_EQ(DEFAULT_DELIVERY_BLOCK_TIMEOUT, options.blockTimeout);
+}
+
+TEST(DeliveryWorkerTest, BlockingOnFullQueueIsBounded)
+{
+    std::mutex gateMutex;
+    std::condition_variable gateCond;
+    bool open = false;
+    DeliveryOptions options;
+
+    options.queueDepth = 2;
+    options.overflowPolicy = OVERFLOW_BLOCK;
+    options.blockTimeout = 10;
+    options.batchSize = 1;
+
+    DeliveryWorker worker("blocking", options, [&](std::vector<GenericTLV *> &values) {
+        std::unique_lock<std::mutex> lock(gateMutex);
+        gateCond.wait(lock, [&] { return open; });
+        return true;
+    });
+
+    worker.start();
+    worker.push(makeDeliveryValue(0));
+
+    while (worker.depth() > 0) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_EQ(true, worker.push(makeDeliveryValue(1)));
+    EXPECT_EQ(true, worker.push(makeDeliveryValue(2)));
+
+    // the caller gets its thread back after the timeout and the value is counted as dropped
+    EXPECT_EQ(false, worker.push(makeDeliveryValue(3)));
+    EXPECT_EQ(1, worker.dropped());
+
+    {
+        std::lock_guard<std::mutex> guard(gateMutex);
+        open = true;
+    }
+
+    gateCond.notify_all();
+    worker.stop();
+}
+
+TEST(DeliveryWorkerTest, FailureIsReported)
+{
+    DeliveryWorker worker("failing", DeliveryOptions(), [](std::vector<GenericTLV *> &values) { return false; });
+
+    worker.start();
+    worker.push(makeDeliveryValue(1));
+
+    while (worker.delivered() < 1) {
+        std::this_thread::yield();
+    }
+
+    worker.stop();
+
+    EXPECT_EQ(true, worker.failed());
+    EXPECT_EQ(1, worker.failedBatches());
+}
+
+TEST(DeliveryWorkerTest, StoppedWorkerRefusesValues)
+{
+    DeliveryWorker worker("stopped", DeliveryOptions(), [](std::vector<GenericTLV *> &values) { return true; });
+
+    worker.start();
+    worker.stop();
+
+    EXPECT_EQ(false, worker.push(makeDeliveryValue(1)));
+    EXPECT_EQ(0, worker.delivered());
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "recorder/eventLog.h"
+#include "recorder/eventReplay.h"
+
+//! writes a small log to path - an int, a float and a string too long to be stored inline
+static void WriteTestEventLog(const std::string &path, SymbolTable &symbols)
+{
+    EventLogWriter writer;
+    EventRecord event;
+
+    ASSERT_TRUE(writer.open(path));
+
+    event.symbol = symbols.intern("N_TEST_INT");
+    event.setInt(42);
+    event.timestamp = 1000;
+    event.ingestTime = 5000000;
+    EXPECT_TRUE(writer.append(event, "N_TEST_INT", "pokey"));
+
+    event.symbol = symbols.intern("G_TEST_FLOAT");
+    event.setFloat(4.25f);
+    event.ingestTime = 15000000;
+    EXPECT_TRUE(writer.append(event, "G_TEST_FLOAT", "prepare3d"));
+
+    event.symbol = symbols.intern("A_TEST_STRING");
+    event.setString(std::string(100, 'x'));
+    event.ingestTime = 25000000;
+    EXPECT_TRUE(writer.append(event, "A_TEST_STRING", "pokey"));
+
+    EXPECT_EQ(3, writer.eventCount());
+}
+
+TEST(EventLogTest, RoundTripRemapsSymbols)
+{
+    std::string path = "/tmp/simhub_test_event_log.bin";
+    SymbolTable recordingSymbols;
+    SymbolTable replaySymbols;
+
+    WriteTestEventLog(path, recordingSymbols);
+
+    // the replaying process has its own ids
+    replaySymbols.intern("SOMETHING_ELSE");
+
+    EventLogReader reader(&replaySymbols);
+    EventRecord event;
+    std::string source;
+
+    ASSERT_TRUE(reader.open(path));
+
+    ASSERT_TRUE(reader.next(event, source));
+    EXPECT_EQ("N_TEST_INT", replaySymbols.name(event.symbol));
+    EXPECT_NE(recordingSymbols.find("N_TEST_INT"), event.symbol);
+    EXPECT_EQ(INT_ATTRIBUTE, event.type);
+    EXPECT_EQ(42, event.value.intValue);
+    EXPECT_EQ(1000, event.timestamp);
+    EXPECT_EQ("pokey", source);
+
+    ASSERT_TRUE(reader.next(event, source));
+    EXPECT_EQ("G_TEST_FLOAT", replaySymbols.name(event.symbol));
+    EXPECT_EQ(FLOAT_ATTRIBUTE, event.type);
+    EXPECT_FLOAT_EQ(4.25f, event.value.floatValue);
+    EXPECT_EQ("prepare3d", source);
+
+    ASSERT_TRUE(reader.next(event, source));
+    EXPECT_EQ(STRING_ATTRIBUTE, event.type);
+    EXPECT_EQ(std::string(100, 'x'), event.string());
+    EXPECT_EQ("pokey", source);
+
+    EXPECT_FALSE(reader.next(event, source));
+
+    reader.rewind();
+    ASSERT_TRUE(reader.next(event, source));
+    EXPECT_EQ("N_TEST_INT", replaySymbols.name(event.symbol));
+
+    remove(path.c_str());
+}
+
+TEST(EventLogTest, RejectsOtherFiles)
+{
+    SymbolTable symbols;
+    EventLogReader reader(&symbols);
+
+    EXPECT_FALSE(reader.open("/tmp/simhub_test_no_such_event_log.bin"));
+}
+
+TEST(EventLogTest, ReplayKeepsOrderAndPacing)
+{
+    std::string path = "/tmp/simhub_test_event_replay.bin";
+    SymbolTable symbols;
+    std::vector<std::string> replayed;
+
+    WriteTestEventLog(path, symbols);
+
+    // recorded 20ms apart end to end, at 2x that is at least 10ms
+    EventReplay replay(&symbols, 2.0, false);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    ASSERT_TRUE(replay.open(path));
+    replay.start([&replayed, &symbols](EventRecord &event, const std::string &source) { replayed.push_back(symbols.name(event.symbol) + "@" + source); });
+
+    while (!replay.finished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+    replay.stop();
+
+    ASSERT_EQ(3, replayed.size());
+    EXPECT_EQ("N_TEST_INT@pokey", replayed[0]);
+    EXPECT_EQ("G_TEST_FLOAT@prepare3d", replayed[1]);
+    EXPECT_EQ("A_TEST_STRING@pokey", replayed[2]);
+    EXPECT_EQ(3, replay.replayed());
+
+    remove(path.c_str());
+}
@@ -0,0 +1,82 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "elements/attributes/attribute.h"
+#include "elements/attributes/eventRecord.h"
+
+static int eventRecordTestOwner;
+
+TEST(EventRecordTest, FitsOneCacheLine)
+{
+    EXPECT_EQ(64, sizeof(EventRecord));
+}
+
+TEST(EventRecordTest, ShortStringsStayInline)
+{
+    EventRecord record;
+    record.setString(std::string("ON"));
+
+    EXPECT_EQ(0, record.flags & EVENT_RECORD_HEAP_STRING);
+    EXPECT_EQ(std::string("ON"), record.string());
+    EXPECT_EQ(2, record.length);
+}
+
+TEST(EventRecordTest, LongStringsSurviveCopyAndMove)
+{
+    std::string longValue(EVENT_RECORD_INLINE_STRING * 2, 'x');
+    EventRecord record;
+    record.setString(longValue);
+
+    EventRecord copy(record);
+    EventRecord moved(std::move(record));
+
+    EXPECT_NE(0, copy.flags & EVENT_RECORD_HEAP_STRING);
+    EXPECT_EQ(longValue, copy.string());
+    EXPECT_EQ(longValue, moved.string());
+    EXPECT_NE(copy.string(), moved.string());
+
+    // replacing a heap string with a number releases it
+    copy.setInt(5);
+    EXPECT_EQ(0, copy.flags & EVENT_RECORD_HEAP_STRING);
+    EXPECT_EQ(5, copy.value.intValue);
+}
+
+TEST(EventRecordTest, GenericRoundTrip)
+{
+    GenericTLV *generic = make_generic("N_TEST", "-");
+    generic->ownerPlugin = &eventRecordTestOwner;
+    generic->symbol = 3;
+    generic->type = CONFIG_FLOAT;
+    generic->value.float_value = 1.5f;
+
+    EventRecord record;
+    EventRecordFromCGeneric(generic, record);
+    release_generic(generic);
+
+    EXPECT_EQ(FLOAT_ATTRIBUTE, record.type);
+    EXPECT_EQ(3, record.symbol);
+    EXPECT_EQ(&eventRecordTestOwner, record.ownerPlugin);
+    EXPECT_NE(0, record.timestamp);
+
+    GenericTLV *delivered = EventRecordToCGeneric(record, "N_TEST");
+
+    EXPECT_EQ(std::string("N_TEST"), delivered->name);
+    EXPECT_EQ(CONFIG_FLOAT, delivered->type);
+    EXPECT_EQ(1.5f, delivered->value.float_value);
+
+    release_generic(delivered);
+}
+
+TEST(EventRecordTest, AttributeViewsRecord)
+{
+    EventRecord record;
+    record.symbol = 9;
+    record.setBool(true);
+
+    Attribute attribute(record, "S_TEST");
+
+    EXPECT_EQ(std::string("S_TEST"), attribute.name());
+    EXPECT_EQ(9, attribute.symbol());
+    EXPECT_EQ(BOOL_ATTRIBUTE, attribute.type());
+    EXPECT_EQ(std::string("1"), attribute.valueToString());
+}
@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "plugins/common/hdrhistogram.h"
+#include "plugins/common/latencytracer.h"
+
+TEST(HdrHistogramTest, PercentilesWithinResolution)
+{
+    HdrHistogram histogram;
+
+    // 1us .. 10000us in 1us steps
+    for (uint64_t value = 1; value <= 10000; value++) {
+        histogram.record(value * 1000);
+    }
+
+    EXPECT_EQ(10000, histogram.count());
+    EXPECT_EQ(1000, histogram.min());
+    EXPECT_EQ(10000000, histogram.max());
+    EXPECT_NEAR(5000000, histogram.percentile(50.0), 5000000 * 0.01);
+    EXPECT_NEAR(9900000, histogram.percentile(99.0), 9900000 * 0.01);
+    EXPECT_NEAR(9990000, histogram.percentile(99.9), 9990000 * 0.01);
+    EXPECT_EQ(10000000, histogram.percentile(100.0));
+}
+
+TEST(HdrHistogramTest, SmallValuesAreExact)
+{
+    HdrHistogram histogram;
+
+    for (uint64_t value = 0; value < 256; value++) {
+        histogram.record(value);
+    }
+
+    EXPECT_EQ(127, histogram.percentile(50.0));
+    EXPECT_EQ(255, histogram.max());
+}
+
+TEST(HdrHistogramTest, ConcurrentRecording)
+{
+    HdrHistogram histogram;
+    std::vector<std::thread> recorders;
+
+    for (int i = 0; i < 4; i++) {
+        recorders.push_back(std::thread([&histogram] {
+            for (uint64_t value = 1; value <= 100000; value++) {
+                histogram.record(value);
+            }
+        }));
+    }
+
+    for (std::thread &recorder : recorders) {
+        recorder.join();
+    }
+
+    EXPECT_EQ(400000, histogram.count());
+    EXPECT_EQ(100000, histogram.max());
+    EXPECT_EQ(1, histogram.min());
+}
+
+TEST(HdrHistogramTest, TracerSkipsUntracedEvents)
+{
+    LatencyTracer tracer;
+
+    tracer.record(LATENCY_STAGE_ENQUEUE, 0);
+    tracer.record(LATENCY_STAGE_ENQUEUE, monotonic_nanos());
+
+    EXPECT_EQ(1, tracer.histogram(LATENCY_STAGE_ENQUEUE).count());
+    EXPECT_EQ(0, tracer.histogram(LATENCY_STAGE_DEQUEUE).count());
+    EXPECT_STREQ("complete", LatencyTracer::StageName(LATENCY_STAGE_COMPLETE));
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "plugins/common/lineframer.h"
+
+static std::vector<std::string> FrameAll(LineFramer &framer, const std::string &data)
+{
+    std::vector<std::string> lines;
+
+    framer.append(data.data(), data.size(), [&](char *line, size_t length) {
+        EXPECT_EQ('\0', line[length]);
+        lines.push_back(std::string(line, length));
+    });
+
+    return lines;
+}
+
+TEST(LineFramerTest, FramesCompleteLines)
+{
+    LineFramer framer(64);
+    std::vector<std::string> lines = FrameAll(framer, "N_ONE = 1\nG_TWO = 2.5\r\nI_THREE = 0\n");
+
+    ASSERT_EQ(3, lines.size());
+    EXPECT_EQ("N_ONE = 1", lines[0]);
+    EXPECT_EQ("G_TWO = 2.5", lines[1]);
+    EXPECT_EQ("I_THREE = 0", lines[2]);
+    EXPECT_EQ(0, framer.pending());
+}
+
+TEST(LineFramerTest, CarriesPartialLinesAcrossReads)
+{
+    LineFramer framer(64);
+
+    EXPECT_TRUE(FrameAll(framer, "G_MIP_ALT").empty());
+    EXPECT_EQ(9, framer.pending());
+
+    std::vector<std::string> lines = FrameAll(framer, "ITUDE = 1025");
+    EXPECT_TRUE(lines.empty());
+
+    lines = FrameAll(framer, "0.5\r\nN_NEXT = 3\nN_PART");
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("G_MIP_ALTITUDE = 10250.5", lines[0]);
+    EXPECT_EQ("N_NEXT = 3", lines[1]);
+    EXPECT_EQ(6, framer.pending());
+}
+
+TEST(LineFramerTest, SocketReadsLandInPlace)
+{
+    LineFramer framer(16);
+    std::vector<std::string> lines;
+    std::string stream;
+
+    for (int i = 0; i < 20; i++) {
+        stream += "N_" + std::to_string(i) + " = " + std::to_string(i * 7) + "\n";
+    }
+
+    // byte at a time reads force the partial line to move to the front
+    for (char c : stream) {
+        ASSERT_GT(framer.writeSpaceSize(), 0);
+        *framer.writeSpace() = c;
+        framer.commit(1);
+        framer.frame([&](char *line, size_t length) { lines.push_back(std::string(line, length)); });
+    }
+
+    ASSERT_EQ(20, lines.size());
+    EXPECT_EQ("N_19 = 133", lines[19]);
+}
+
+TEST(LineFramerTest, DropsOverlongLines)
+{
+    LineFramer framer(16);
+    std::vector<std::string> lines = FrameAll(framer, "N_SHORT = 1\nV_FAR_TOO_LONG_FOR_THE_BUFFER = something\nN_AFTER = 2\n");
+
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ("N_SHORT = 1", lines[0]);
+    EXPECT_EQ("N_AFTER = 2", lines[1]);
+    EXPECT_EQ(1, framer.overlongLines());
+}
+
+TEST(LineFramerTest, SplitRecordTrimsInPlace)
+{
+    char line[] = "V_FMC_SCRATCHPAD =  KJFK DEP ";
+    TextView name;
+    TextView value;
+
+    ASSERT_TRUE(SplitRecord(line, strlen(line), name, value));
+    EXPECT_STREQ("V_FMC_SCRATCHPAD", name.data);
+    EXPECT_EQ(16, name.length);
+    EXPECT_STREQ("KJFK DEP", value.data);
+    EXPECT_EQ(8, value.length);
+
+    char noAssign[] = "N_BROKEN 1";
+    EXPECT_FALSE(SplitRecord(noAssign, strlen(noAssign), name, value));
+
+    char noName[] = " = 1";
+    EXPECT_FALSE(SplitRecord(noName, strlen(noName), name, value));
+}
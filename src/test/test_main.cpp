@@ -1,4 +1,24 @@
 #include "test_logging.h"
+#include "test_ring_queue.h"
+#include "test_symbol_table.h"
+#include "test_event_record.h"
+#include "test_conflation.h"
+#include "test_routing_table.h"
+#include "test_block_pool.h"
+#include "test_plugin_registry.h"
+#include "test_delivery_worker.h"
+#include "test_event_lanes.h"
+#include "test_hdr_histogram.h"
+#include "test_metrics.h"
+#include "test_event_log.h"
+#include "test_line_framer.h"
+#include "test_delimiter_scanner.h"
+#include "test_number_parse.h"
+#include "test_backoff.h"
+#include "test_transform_engine.h"
+#include "test_poll_rate.h"
+#include "test_pokey_scheduler.h"
+#include "test_pokey_pin_state.h"
 #include <gtest/gtest.h>
 #include <thread>
 
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "plugins/common/metrics.h"
+
+TEST(MetricsTest, CounterSumsShardsAcrossThreads)
+{
+    MetricCounter counter;
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < 8; i++) {
+        threads.push_back(std::thread([&counter] {
+            for (int j = 0; j < 10000; j++) {
+                counter.add();
+            }
+        }));
+    }
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(80000, counter.value());
+}
+
+TEST(MetricsTest, RegisteringAgainReturnsTheSameSeries)
+{
+    MetricsRegistry metrics;
+
+    MetricCounter &first = metrics.counter("test_total", "help", "plugin=\"pokey\"");
+    MetricCounter &second = metrics.counter("test_total", "help", "plugin=\"pokey\"");
+    MetricCounter &other = metrics.counter("test_total", "help", "plugin=\"prepare3d\"");
+
+    EXPECT_EQ(&first, &second);
+    EXPECT_NE(&first, &other);
+}
+
+TEST(MetricsTest, ExpositionFormat)
+{
+    MetricsRegistry metrics;
+
+    metrics.counter("simhub_test_total", "Test events", "plugin=\"pokey\"").add(3);
+    metrics.gaugeFunction("simhub_test_depth", "Test depth", "", [] { return 7.0; });
+    metrics.histogram("simhub_test_seconds", "Test duration").record(2000000000);
+
+    std::string exposition = metrics.exposition();
+
+    EXPECT_NE(std::string::npos, exposition.find("# HELP simhub_test_total Test events\n"));
+    EXPECT_NE(std::string::npos, exposition.find("# TYPE simhub_test_total counter\n"));
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_total{plugin=\"pokey\"} 3\n"));
+    EXPECT_NE(std::string::npos, exposition.find("# TYPE simhub_test_depth gauge\n"));
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_depth 7\n"));
+    EXPECT_NE(std::string::npos, exposition.find("# TYPE simhub_test_seconds summary\n"));
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_seconds{quantile=\"0.5\"} 2"));
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_seconds_count 1\n"));
+}
+
+TEST(MetricsTest, LargeCountersStayExact)
+{
+    MetricsRegistry metrics;
+    MetricCounter &counter = metrics.counter("simhub_test_total", "Test events");
+    uint64_t function = 12345678901234ULL;
+
+    counter.add(12345678);
+    metrics.counterFunction("simhub_test_function_total", "Test events", "", [&function] { return function; });
+
+    std::string exposition = metrics.exposition();
+
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_total 12345678\n"));
+    EXPECT_NE(std::string::npos, exposition.find("simhub_test_function_total 12345678901234\n"));
+
+    counter.add(10);
+
+    EXPECT_NE(std::string::npos, metrics.exposition().find("simhub_test_total 12345688\n"));
+}
+
+TEST(MetricsTest, GaugeFunctionsKeepFullPrecision)
+{
+    MetricsRegistry metrics;
+
+    metrics.gaugeFunction("simhub_test_ratio", "Test ratio", "", [] { return 1234567.125; });
+
+    EXPECT_NE(std::string::npos, metrics.exposition().find("simhub_test_ratio 1234567.125\n"));
+}
+
+TEST(MetricsTest, CountersStartOnTheirOwnCacheLine)
+{
+    MetricsRegistry metrics;
+
+    for (int i = 0; i < 8; i++) {
+        MetricCounter &counter = metrics.counter("simhub_test_total", "Test events", "shard=\"" + std::to_string(i) + "\"");
+        EXPECT_EQ(0, (uintptr_t)&counter % METRIC_CACHE_LINE);
+    }
+}
+
+TEST(MetricsTest, FunctionsAreCalledWithoutTheRegistryLock)
+{
+    MetricsRegistry metrics;
+
+    // would deadlock if the scrape still held the lock
+    metrics.gaugeFunction("simhub_test_lookup", "Test lookup", "", [&metrics] { return (double)metrics.counter("simhub_test_total", "Test events").value(); });
+
+    EXPECT_NE(std::string::npos, metrics.exposition().find("simhub_test_lookup 0\n"));
+}
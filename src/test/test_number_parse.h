@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <string>
+
+#include "plugins/common/numberparse.h"
+
+static bool ParseIntString(const std::string &text, int64_t &value)
+{
+    return ParseInt(text.data(), text.size(), value);
+}
+
+static bool ParseFloatString(const std::string &text, double &value)
+{
+    return ParseFloat(text.data(), text.size(), value);
+}
+
+TEST(NumberParseTest, ParsesIntegers)
+{
+    int64_t value = 0;
+
+    EXPECT_TRUE(ParseIntString("0", value));
+    EXPECT_EQ(0, value);
+    EXPECT_TRUE(ParseIntString("-42", value));
+    EXPECT_EQ(-42, value);
+    EXPECT_TRUE(ParseIntString("+17", value));
+    EXPECT_EQ(17, value);
+    EXPECT_TRUE(ParseIntString("9223372036854775807", value));
+    EXPECT_EQ(INT64_MAX, value);
+    EXPECT_TRUE(ParseIntString("-9223372036854775808", value));
+    EXPECT_EQ(INT64_MIN, value);
+}
+
+TEST(NumberParseTest, RejectsMalformedIntegers)
+{
+    int64_t value = 7;
+
+    for (const char *text : {"", "-", "+", "12a", "1 2", " 1", "1.0", "0x10", "9223372036854775808", "99999999999999999999"}) {
+        EXPECT_FALSE(ParseIntString(text, value)) << text;
+    }
+
+    EXPECT_EQ(7, value);
+}
+
+TEST(NumberParseTest, ParsesFloatsLikeStrtod)
+{
+    for (const char *text : {"0", "1", "-1", "10250.5", "251.25", "0.1", "-0.000125", ".5", "5.", "1e3", "2.5E-4", "+3.75", "123456789012345", "29.92", "0.0000001"}) {
+        double value = 0;
+
+        ASSERT_TRUE(ParseFloatString(text, value)) << text;
+        EXPECT_DOUBLE_EQ(strtod(text, NULL), value) << text;
+    }
+}
+
+TEST(NumberParseTest, RejectsMalformedFloats)
+{
+    double value = 7;
+
+    for (const char *text : {"", "-", ".", "e5", "1e", "1e+", "1.2.3", "1,5", "12 ", "nan", "inf", "1e999"}) {
+        EXPECT_FALSE(ParseFloatString(text, value)) << text;
+    }
+
+    EXPECT_EQ(7, value);
+}
+
+TEST(NumberParseTest, ParsesBools)
+{
+    bool value = false;
+
+    EXPECT_TRUE(ParseBool("1", 1, value));
+    EXPECT_TRUE(value);
+    EXPECT_TRUE(ParseBool("0", 1, value));
+    EXPECT_FALSE(value);
+    EXPECT_TRUE(ParseBool("TRUE", 4, value));
+    EXPECT_TRUE(value);
+    EXPECT_TRUE(ParseBool("false", 5, value));
+    EXPECT_FALSE(value);
+    EXPECT_FALSE(ParseBool("yes", 3, value));
+    EXPECT_FALSE(ParseBool("", 0, value));
+}
@@ -0,0 +1,40 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "registry/pluginRegistry.h"
+
+static int registryTestInstance;
+
+TEST(PluginRegistryTest, KeepsLoadOrderAndRejectsDuplicates)
+{
+    PluginRegistry registry;
+
+    PluginContext *pokey = registry.add({"pokey", "libpokey", "config/pokey.cfg"}, &registry);
+    PluginContext *prepare3d = registry.add({"prepare3d", "libprepare3d", ""}, &registry);
+
+    ASSERT_NE(nullptr, pokey);
+    ASSERT_NE(nullptr, prepare3d);
+    EXPECT_EQ(nullptr, registry.add({"pokey", "libother", ""}, &registry));
+
+    EXPECT_EQ(2, registry.size());
+    EXPECT_EQ(pokey, &registry[0]);
+    EXPECT_EQ(prepare3d, &registry[1]);
+    EXPECT_EQ(prepare3d, registry.find("prepare3d"));
+    EXPECT_EQ(nullptr, registry.find("loadgen"));
+    EXPECT_EQ("libpokey", registry.find("pokey")->descriptor.library);
+}
+
+TEST(PluginRegistryTest, FindsOwnerOfLoadedInstance)
+{
+    PluginRegistry registry;
+    PluginContext *pokey = registry.add({"pokey", "libpokey", ""}, &registry);
+
+    EXPECT_EQ(false, pokey->loaded());
+    EXPECT_EQ(nullptr, registry.ownerOf(&registryTestInstance));
+
+    pokey->methods.plugin_instance = &registryTestInstance;
+
+    EXPECT_EQ(true, pokey->loaded());
+    EXPECT_EQ(pokey, registry.ownerOf(&registryTestInstance));
+    EXPECT_EQ(nullptr, registry.ownerOf(NULL));
+}
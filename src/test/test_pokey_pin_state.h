@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+#include <string.h>
+#include <vector>
+
+#include "pokey/pokeyPinState.h"
+
+#define PIN_STATE_TEST_PINS 55
+
+//! an in memory device with every pin an input except every fifth from pin 4, an output
+class PokeyPinStateTest : public ::testing::Test
+{
+protected:
+    sPoKeysDevice _device;
+    std::vector<sPoKeysPinData> _devicePins;
+    device_port_t _pins[PIN_STATE_TEST_PINS];
+    PokeyPinState _pinState;
+    std::vector<int> _changed;
+
+    void SetUp(void)
+    {
+        _devicePins.resize(PIN_STATE_TEST_PINS);
+        memset(&_device, 0, sizeof(_device));
+        memset(_devicePins.data(), 0, _devicePins.size() * sizeof(sPoKeysPinData));
+        _device.info.iPinCount = PIN_STATE_TEST_PINS;
+        _device.Pins = _devicePins.data();
+
+        for (int i = 0; i < PIN_STATE_TEST_PINS; i++) {
+            _pins[i].pinName = "PIN_" + std::to_string(i + 1);
+            _pins[i].pinNumber = i + 1;
+            _pins[i].pinIndex = i;
+            _pins[i].type = i % 5 == 3 ? PIN_TYPE_DIGITAL_OUTPUT : PIN_TYPE_DIGITAL_INPUT;
+            _pins[i].defaultValue = 0;
+        }
+
+        _pinState.configure(_pins, PIN_STATE_TEST_PINS);
+    }
+
+    //! sets the device state of pinNumber (1 based)
+    void set(int pinNumber, bool value) { _devicePins[pinNumber - 1].DigitalValueGet = value ? 1 : 0; }
+
+    size_t diff(void)
+    {
+        _changed.clear();
+        return _pinState.diff(&_device, _changed);
+    }
+};
+
+TEST_F(PokeyPinStateTest, ConfigureBuildsTheInputMask)
+{
+    EXPECT_EQ(PIN_STATE_TEST_PINS - 11, _pinState.inputPinCount());
+    EXPECT_NE(0, _pinState.inputMask() & 1);
+    EXPECT_EQ(0, _pinState.inputMask() & ((uint64_t)1 << 3));
+    EXPECT_NE(0, _pinState.inputMask() & ((uint64_t)1 << 54));
+    EXPECT_EQ(0, _pinState.inputMask() >> PIN_STATE_TEST_PINS);
+}
+
+TEST_F(PokeyPinStateTest, ConfigureSkipsEmptyEntries)
+{
+    _pins[0].pinName = "";
+    _pins[1].pinNumber = 0;
+    _pins[2].pinNumber = POKEY_PIN_BITS + 1;
+    _pinState.configure(_pins, PIN_STATE_TEST_PINS);
+
+    EXPECT_EQ(0, _pinState.inputMask() & 0x7);
+    EXPECT_EQ(PIN_STATE_TEST_PINS - 11 - 3, _pinState.inputPinCount());
+}
+
+TEST_F(PokeyPinStateTest, FirstSampleAtDefaultsReportsNothing)
+{
+    EXPECT_EQ(0, _pinState.sample(&_device));
+    EXPECT_EQ(0, diff());
+    EXPECT_TRUE(_changed.empty());
+}
+
+TEST_F(PokeyPinStateTest, DefaultValuesAreTheFirstReportedState)
+{
+    _pins[4].defaultValue = 1;
+    _pinState.configure(_pins, PIN_STATE_TEST_PINS);
+
+    EXPECT_EQ(true, _pinState.value(5));
+    EXPECT_EQ(1, diff());
+    EXPECT_EQ(4, _changed[0]);
+
+    set(5, true);
+
+    EXPECT_EQ(0, diff());
+}
+
+TEST_F(PokeyPinStateTest, OutputsAreIgnored)
+{
+    set(4, true);
+    set(9, true);
+
+    EXPECT_EQ(0, _pinState.sample(&_device));
+    EXPECT_EQ(0, _pinState.changes((uint64_t)1 << 3 | (uint64_t)1 << 8));
+    EXPECT_EQ(0, diff());
+}
+
+TEST_F(PokeyPinStateTest, SingleBitFlip)
+{
+    set(10, true);
+
+    ASSERT_EQ(1, diff());
+    EXPECT_EQ(9, _changed[0]);
+    EXPECT_EQ(true, _pinState.changed(10, &_device));
+
+    // reported - no longer a change until the device moves again
+    _pinState.setValue(10, true);
+
+    EXPECT_EQ(0, diff());
+    EXPECT_EQ(false, _pinState.changed(10, &_device));
+
+    set(10, false);
+
+    ASSERT_EQ(1, diff());
+    EXPECT_EQ(9, _changed[0]);
+}
+
+TEST_F(PokeyPinStateTest, ChangesAcrossTheWholeMask)
+{
+    // first pin, either side of the 32 bit boundary and the last pin
+    set(1, true);
+    set(32, true);
+    set(33, true);
+    set(55, true);
+
+    ASSERT_EQ(4, diff());
+    EXPECT_EQ(0, _changed[0]);
+    EXPECT_EQ(31, _changed[1]);
+    EXPECT_EQ(32, _changed[2]);
+    EXPECT_EQ(54, _changed[3]);
+
+    uint64_t expected = (uint64_t)1 | ((uint64_t)1 << 31) | ((uint64_t)1 << 32) | ((uint64_t)1 << 54);
+
+    EXPECT_EQ(expected, _pinState.sample(&_device));
+    EXPECT_EQ(expected, _pinState.changes(_pinState.sample(&_device)));
+}
+
+TEST_F(PokeyPinStateTest, SkippedPinsAreNotReported)
+{
+    set(33, true);
+    _pinState.setSkipped(33, true);
+
+    EXPECT_EQ(true, _pinState.skipped(33));
+    EXPECT_EQ(0, diff());
+    EXPECT_EQ(false, _pinState.changed(33, &_device));
+
+    _pinState.setSkipped(33, false);
+
+    ASSERT_EQ(1, diff());
+    EXPECT_EQ(32, _changed[0]);
+}
+
+TEST_F(PokeyPinStateTest, PinsBeyondTheDeviceAreNotSampled)
+{
+    set(55, true);
+    _device.info.iPinCount = 54;
+
+    EXPECT_EQ(0, diff());
+}
+
+TEST_F(PokeyPinStateTest, InvalidPinNumbersAreIgnored)
+{
+    _pinState.setValue(0, true);
+    _pinState.setValue(POKEY_PIN_BITS + 1, true);
+    _pinState.setSkipped(0, true);
+
+    EXPECT_EQ(false, _pinState.value(0));
+    EXPECT_EQ(false, _pinState.value(POKEY_PIN_BITS + 1));
+    EXPECT_EQ(false, _pinState.skipped(0));
+    EXPECT_EQ(false, _pinState.changed(0, &_device));
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "plugins/pokey/pokeyScheduler.h"
+
+//! polls until condition holds or a second has passed
+template <typename Condition> static bool WaitFor(Condition condition)
+{
+    for (int i = 0; i < 1000 && !condition(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return condition();
+}
+
+TEST(PokeySchedulerTest, RunsTasksInDeadlineOrder)
+{
+    PokeyScheduler scheduler;
+    std::mutex mutex;
+    std::vector<int> order;
+    int owners[3];
+
+    for (int i = 2; i >= 0; i--) {
+        scheduler.schedule(&owners[i], 10 + i * 20, [&, i] {
+            std::lock_guard<std::mutex> lock(mutex);
+            order.push_back(i);
+            return 100000u;
+        });
+    }
+
+    scheduler.start(1);
+
+    ASSERT_TRUE(WaitFor([&] {
+        std::lock_guard<std::mutex> lock(mutex);
+        return order.size() == 3;
+    }));
+
+    scheduler.stop();
+
+    EXPECT_EQ(std::vector<int>({0, 1, 2}), order);
+}
+
+TEST(PokeySchedulerTest, ReschedulesWithTheReturnedDelay)
+{
+    PokeyScheduler scheduler;
+    std::atomic<int> runs(0);
+    int owner;
+
+    scheduler.schedule(&owner, 0, [&] {
+        runs++;
+        return 1u;
+    });
+
+    scheduler.start(2);
+
+    EXPECT_TRUE(WaitFor([&] { return runs >= 10; }));
+
+    scheduler.stop();
+}
+
+TEST(PokeySchedulerTest, NeverRunsTwoTasksOfOneOwnerAtOnce)
+{
+    PokeyScheduler scheduler;
+    std::atomic<int> running(0);
+    std::atomic<int> overlaps(0);
+    std::atomic<int> runs(0);
+    int owner;
+
+    for (int i = 0; i < 3; i++) {
+        scheduler.schedule(&owner, 0, [&] {
+            overlaps += running.fetch_add(1) > 0;
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            running--;
+            runs++;
+            return 0u;
+        });
+    }
+
+    scheduler.start(4);
+
+    EXPECT_TRUE(WaitFor([&] { return runs >= 30; }));
+
+    scheduler.stop();
+
+    EXPECT_EQ(0, overlaps);
+}
+
+TEST(PokeySchedulerTest, OwnersRunInParallelUpToTheThreadCount)
+{
+    PokeyScheduler scheduler;
+    std::atomic<int> running(0);
+    std::atomic<int> peak(0);
+    std::atomic<int> runs(0);
+    int owners[8];
+
+    for (int &owner : owners) {
+        scheduler.schedule(&owner, 0, [&] {
+            int now = ++running;
+            int seen = peak;
+
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            running--;
+            runs++;
+            return 0u;
+        });
+    }
+
+    scheduler.start(3);
+
+    EXPECT_TRUE(WaitFor([&] { return runs >= 24; }));
+    EXPECT_EQ(3u, scheduler.threads());
+
+    scheduler.stop();
+
+    EXPECT_LE(peak, 3);
+    EXPECT_GE(peak, 2);
+}
+
+TEST(PokeySchedulerTest, CancelRemovesTheOwnersTasks)
+{
+    PokeyScheduler scheduler;
+    std::atomic<int> runs(0);
+    int owner;
+    int other;
+
+    scheduler.schedule(&owner, 0, [&] {
+        runs++;
+        return 1u;
+    });
+    scheduler.schedule(&other, 100000, [] { return 100000u; });
+
+    scheduler.start(2);
+
+    ASSERT_TRUE(WaitFor([&] { return runs > 0; }));
+
+    scheduler.cancel(&owner);
+    int cancelledAt = runs;
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    scheduler.stop();
+
+    EXPECT_EQ(cancelledAt, runs);
+    EXPECT_EQ(1u, scheduler.tasks());
+}
+
+TEST(PokeySchedulerTest, ExpediteBringsTasksForward)
+{
+    PokeyScheduler scheduler;
+    std::atomic<int> runs(0);
+    int owner;
+
+    scheduler.schedule(&owner, 100000, [&] {
+        runs++;
+        return 100000u;
+    });
+
+    scheduler.start(1);
+    scheduler.expedite(&owner, 0);
+
+    EXPECT_TRUE(WaitFor([&] { return runs == 1; }));
+
+    scheduler.stop();
+}
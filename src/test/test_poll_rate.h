@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include "plugins/pokey/pokeyPollRate.h"
+
+#define POLL_TEST_MS 1000000LL
+
+TEST(PollRateTest, PollsAtTheIdleIntervalWithoutAdaptiveMode)
+{
+    PollRate rate;
+
+    rate.configure(100);
+
+    EXPECT_EQ(100u, rate.polled(1000 * POLL_TEST_MS, 0));
+    EXPECT_EQ(100u, rate.polled(1100 * POLL_TEST_MS, 1050 * POLL_TEST_MS));
+    EXPECT_FALSE(rate.active(1100 * POLL_TEST_MS, 1050 * POLL_TEST_MS));
+}
+
+TEST(PollRateTest, SpeedsUpAfterAChangeAndBacksOffOnceIdle)
+{
+    PollRate rate;
+
+    rate.configure(250, 5, 3000);
+
+    EXPECT_EQ(250u, rate.polled(1000 * POLL_TEST_MS, 0));
+    EXPECT_EQ(5u, rate.polled(1250 * POLL_TEST_MS, 1250 * POLL_TEST_MS));
+    EXPECT_EQ(5u, rate.polled(4200 * POLL_TEST_MS, 1250 * POLL_TEST_MS));
+    EXPECT_EQ(250u, rate.polled(4250 * POLL_TEST_MS, 1250 * POLL_TEST_MS));
+}
+
+TEST(PollRateTest, ActiveIntervalNeverExceedsTheIdleOne)
+{
+    PollRate rate;
+
+    rate.configure(20, 50, 1000);
+
+    EXPECT_EQ(20u, rate.polled(1000 * POLL_TEST_MS, 1000 * POLL_TEST_MS));
+}
+
+TEST(PollRateTest, MeasuresFrequencyAndJitter)
+{
+    PollRate rate;
+
+    rate.configure(10);
+
+    EXPECT_EQ(0, rate.frequency());
+
+    int64_t now = 1000 * POLL_TEST_MS;
+
+    for (int i = 0; i < 1000; i++) {
+        rate.polled(now, 0);
+        // every other poll runs 2ms late
+        now += (i % 2 ? 12 : 10) * POLL_TEST_MS;
+    }
+
+    EXPECT_EQ(1000u, rate.polls());
+    EXPECT_NEAR(1000.0 / 11, rate.frequency(), 1.0);
+    EXPECT_NEAR(0.001, rate.jitter(), 0.0005);
+}
@@ -0,0 +1,205 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "queue/ring_queue.h"
+
+TEST(RingQueueTest, CapacityRoundsUpToPowerOfTwo)
+{
+    RingQueue<int> queue(100);
+    EXPECT_EQ(128, queue.capacity());
+}
+
+TEST(RingQueueTest, PreservesFIFOOrder)
+{
+    RingQueue<int> queue(16);
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(true, queue.push(i));
+    }
+
+    EXPECT_EQ(10, queue.size());
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, queue.pop());
+    }
+
+    EXPECT_EQ(true, queue.empty());
+}
+
+TEST(RingQueueTest, DropNewestOnOverflow)
+{
+    RingQueue<int> queue(4, OVERFLOW_DROP_NEWEST);
+
+    for (int i = 0; i < 6; i++) {
+        queue.push(i);
+    }
+
+    EXPECT_EQ(2, queue.droppedCount());
+
+    for (int i = 0; i < 4; i++) {
+        EXPECT_EQ(i, queue.pop());
+    }
+}
+
+TEST(RingQueueTest, DropOldestOnOverflow)
+{
+    RingQueue<int> queue(4, OVERFLOW_DROP_OLDEST);
+
+    for (int i = 0; i < 6; i++) {
+        EXPECT_EQ(true, queue.push(i));
+    }
+
+    EXPECT_EQ(2, queue.droppedCount());
+
+    for (int i = 2; i < 6; i++) {
+        EXPECT_EQ(i, queue.pop());
+    }
+}
+
+TEST(RingQueueTest, UnblockInterruptsWaitingConsumer)
+{
+    RingQueue<std::shared_ptr<int>> queue(8);
+    bool interrupted = false;
+
+    std::thread consumer([&] {
+        try {
+            queue.pop();
+        }
+        catch (ConcurrentQueueInterrupted &queueException) {
+            interrupted = true;
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.unblock();
+    consumer.join();
+
+    EXPECT_EQ(true, interrupted);
+    EXPECT_EQ(false, queue.push(std::make_shared<int>(1)));
+}
+
+TEST(RingQueueTest, UnblockReleasesBlockedProducer)
+{
+    RingQueue<int> queue(2, OVERFLOW_BLOCK);
+
+    queue.push(1);
+    queue.push(2);
+
+    std::thread producer([&] { EXPECT_EQ(false, queue.push(3)); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.unblock();
+    producer.join();
+}
+
+TEST(RingQueueTest, BlockTimeoutDropsAndCounts)
+{
+    RingQueue<int> queue(2, OVERFLOW_BLOCK);
+
+    queue.setBlockTimeout(std::chrono::milliseconds(10));
+    queue.push(1);
+    queue.push(2);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    EXPECT_EQ(false, queue.push(3));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+    EXPECT_EQ(1, queue.droppedCount());
+
+    // the queued values are untouched
+    EXPECT_EQ(1, queue.pop());
+    EXPECT_EQ(true, queue.push(3));
+}
+
+TEST(RingQueueTest, BlockTimeoutCanEvictTheOldest)
+{
+    RingQueue<int> queue(2, OVERFLOW_BLOCK);
+    int evicted = -1;
+
+    queue.setBlockTimeout(std::chrono::milliseconds(10), OVERFLOW_DROP_OLDEST);
+    queue.setDropHandler([&evicted](int &value) { evicted = value; });
+    queue.push(1);
+    queue.push(2);
+
+    EXPECT_EQ(true, queue.push(3));
+    EXPECT_EQ(1, evicted);
+    EXPECT_EQ(1, queue.droppedCount());
+    EXPECT_EQ(2, queue.pop());
+    EXPECT_EQ(3, queue.pop());
+}
+
+TEST(RingQueueTest, MultipleProducersLoseNothingWhenBlocking)
+{
+    static const int PRODUCERS = 4;
+    static const int EVENTS = 20000;
+
+    RingQueue<int> queue(64, OVERFLOW_BLOCK);
+    std::vector<std::thread> producers;
+    std::vector<int> lastSeen(PRODUCERS, -1);
+    bool ordered = true;
+
+    for (int p = 0; p < PRODUCERS; p++) {
+        producers.push_back(std::thread([&queue, p] {
+            for (int i = 0; i < EVENTS; i++) {
+                queue.push(p * EVENTS + i);
+            }
+        }));
+    }
+
+    for (int i = 0; i < PRODUCERS * EVENTS; i++) {
+        int value = queue.pop();
+        int producer = value / EVENTS;
+
+        // order must be preserved per producer
+        if (value % EVENTS <= lastSeen[producer]) {
+            ordered = false;
+        }
+
+        lastSeen[producer] = value % EVENTS;
+    }
+
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    EXPECT_EQ(true, ordered);
+    EXPECT_EQ(0, queue.droppedCount());
+    EXPECT_EQ(true, queue.empty());
+}
+
+TEST(RingQueueTest, PopBatchTakesUpToMaxItems)
+{
+    RingQueue<int> queue(16, OVERFLOW_BLOCK);
+    std::vector<int> batch;
+
+    for (int i = 0; i < 10; i++) {
+        queue.push(i);
+    }
+
+    EXPECT_EQ(4, queue.popBatch(batch, 4, std::chrono::microseconds(0)));
+    EXPECT_EQ(6, queue.popBatch(batch, 8, std::chrono::microseconds(0)));
+    EXPECT_EQ(10, batch.size());
+
+    for (int i = 0; i < 10; i++) {
+        EXPECT_EQ(i, batch[i]);
+    }
+}
+
+TEST(RingQueueTest, PopBatchLingersForLateArrivals)
+{
+    RingQueue<int> queue(16, OVERFLOW_BLOCK);
+    std::vector<int> batch;
+
+    queue.push(1);
+
+    std::thread producer([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        queue.push(2);
+    });
+
+    // generous linger so the late element makes it into this batch
+    EXPECT_EQ(2, queue.popBatch(batch, 2, std::chrono::microseconds(2000000)));
+    producer.join();
+}
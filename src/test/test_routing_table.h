@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+#include "routing/routingTable.h"
+
+static int routingTestPokey;
+static int routingTestPrepare3d;
+static int routingTestDevice;
+
+//! a pokey-like destination that declares its targets and a prepare3d-like one that takes anything
+class RoutingTableTest : public ::testing::Test
+{
+protected:
+    SymbolTable _symbols;
+    RoutingTable _routing;
+    simplug_vtable _pokey;
+    simplug_vtable _prepare3d;
+
+    void SetUp(void)
+    {
+        memset(&_pokey, 0, sizeof(simplug_vtable));
+        memset(&_prepare3d, 0, sizeof(simplug_vtable));
+        _pokey.plugin_instance = &routingTestPokey;
+        _prepare3d.plugin_instance = &routingTestPrepare3d;
+
+        _routing.addDestination(&_pokey);
+        _routing.declareTarget("I_OH_LIGHT", &routingTestDevice);
+        _routing.declareTarget("I_OH_OTHER", &routingTestDevice);
+        _routing.addDestination(&_prepare3d);
+    }
+};
+
+TEST_F(RoutingTableTest, DeclaredTargetGoesToDeclaringPlugin)
+{
+    _routing.compile(&_symbols);
+
+    const RouteList &routes = _routing.routes(_symbols.find("I_OH_LIGHT"));
+
+    // prepare3d accepts everything, the echo back to it is filtered at delivery
+    ASSERT_EQ(2, routes.size());
+    EXPECT_EQ(&_pokey, routes[0].destination);
+    EXPECT_EQ(&routingTestDevice, routes[0].handle);
+    EXPECT_EQ(SYMBOL_UNRESOLVED, routes[0].target);
+    EXPECT_EQ(true, RoutingTable::IsEcho(routes[1], _symbols.find("I_OH_LIGHT"), &routingTestPrepare3d));
+}
+
+TEST_F(RoutingTableTest, UnknownSourceGoesToAcceptAllPlugins)
+{
+    _routing.compile(&_symbols);
+
+    const RouteList &routes = _routing.routes(_symbols.intern("N_UNKNOWN"));
+
+    ASSERT_EQ(1, routes.size());
+    EXPECT_EQ(&_prepare3d, routes[0].destination);
+    EXPECT_EQ(1, routes[0].destinationIndex);
+}
+
+TEST_F(RoutingTableTest, MappingFansOutAndRenames)
+{
+    _routing.addMapping("S_OH_SWITCH", {"I_OH_LIGHT", "I_OH_OTHER"});
+    _routing.compile(&_symbols);
+
+    const RouteList &routes = _routing.routes(_symbols.find("S_OH_SWITCH"));
+    std::vector<std::string> pokeyTargets;
+
+    for (const Route &route : routes) {
+        if (route.destination == &_pokey) {
+            pokeyTargets.push_back(_symbols.name(route.target));
+            EXPECT_EQ(&routingTestDevice, route.handle);
+        }
+
+        // renamed, so even a route back to the source plugin is not an echo
+        EXPECT_EQ(false, RoutingTable::IsEcho(route, _symbols.find("S_OH_SWITCH"), route.destination->plugin_instance));
+    }
+
+    ASSERT_EQ(2, pokeyTargets.size());
+    EXPECT_EQ("I_OH_LIGHT", pokeyTargets[0]);
+    EXPECT_EQ("I_OH_OTHER", pokeyTargets[1]);
+    EXPECT_EQ(4, routes.size());
+}
+
+TEST_F(RoutingTableTest, MappingLimitedToNamedDestinations)
+{
+    RoutingTable routing;
+
+    routing.addDestination(&_pokey, "pokey");
+    routing.declareTarget("I_OH_LIGHT", &routingTestDevice);
+    routing.addDestination(&_prepare3d, "prepare3d");
+    routing.addMapping("S_OH_SWITCH", {"I_OH_LIGHT"}, {"prepare3d"});
+    routing.compile(&_symbols);
+
+    const RouteList &routes = routing.routes(_symbols.find("S_OH_SWITCH"));
+
+    ASSERT_EQ(1, routes.size());
+    EXPECT_EQ(&_prepare3d, routes[0].destination);
+    EXPECT_EQ(1, routes[0].destinationIndex);
+}
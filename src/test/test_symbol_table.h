@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "plugins/common/symboltable.h"
+
+TEST(SymbolTableTest, InternAssignsDenseIds)
+{
+    SymbolTable symbols;
+
+    EXPECT_EQ(1, symbols.intern("S_OH_ONE"));
+    EXPECT_EQ(2, symbols.intern("S_OH_TWO"));
+    EXPECT_EQ(1, symbols.intern("S_OH_ONE"));
+    EXPECT_EQ(3, symbols.bound());
+}
+
+TEST(SymbolTableTest, FindDoesNotIntern)
+{
+    SymbolTable symbols;
+
+    EXPECT_EQ(SYMBOL_UNRESOLVED, symbols.find("S_OH_ONE"));
+    EXPECT_EQ(SYMBOL_UNRESOLVED, symbols.intern(""));
+    EXPECT_EQ(1, symbols.bound());
+}
+
+TEST(SymbolTableTest, NameRoundTrips)
+{
+    SymbolTable symbols;
+    SymbolId symbol = symbols.intern("G_MIP_FLAPS");
+
+    EXPECT_STREQ("G_MIP_FLAPS", symbols.name(symbol).c_str());
+    EXPECT_STREQ("", symbols.name(SYMBOL_UNRESOLVED).c_str());
+    EXPECT_STREQ("", symbols.name(symbol + 1).c_str());
+}
+
+TEST(SymbolTableTest, GrowsPastFirstChunk)
+{
+    SymbolTable symbols;
+
+    for (int i = 0; i < SYMBOL_CHUNK_SIZE * 3; i++) {
+        symbols.intern("N_ELEMENT_" + std::to_string(i));
+    }
+
+    SymbolId symbol = symbols.find("N_ELEMENT_" + std::to_string(SYMBOL_CHUNK_SIZE * 2 + 7));
+
+    EXPECT_EQ(SYMBOL_CHUNK_SIZE * 2 + 8, symbol);
+    EXPECT_STREQ(("N_ELEMENT_" + std::to_string(SYMBOL_CHUNK_SIZE * 2 + 7)).c_str(), symbols.name(symbol).c_str());
+}
+
+TEST(SymbolTableTest, ConcurrentInternAgrees)
+{
+    static const int THREADS = 4;
+    static const int NAMES = 2000;
+
+    SymbolTable symbols;
+    std::vector<std::vector<SymbolId>> results(THREADS, std::vector<SymbolId>(NAMES));
+    std::vector<std::thread> threads;
+
+    for (int t = 0; t < THREADS; t++) {
+        threads.push_back(std::thread([&symbols, &results, t] {
+            for (int i = 0; i < NAMES; i++) {
+                results[t][i] = symbols.intern("I_NAME_" + std::to_string(i));
+            }
+        }));
+    }
+
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (int t = 1; t < THREADS; t++) {
+        EXPECT_EQ(results[0], results[t]);
+    }
+
+    EXPECT_EQ(NAMES + 1, symbols.bound());
+}
+
+TEST(SymbolIndexTest, LooksUpBySymbol)
+{
+    SymbolIndex<int> index;
+
+    index.set(5, 42);
+    index.set(SYMBOL_UNRESOLVED, 1);
+
+    EXPECT_EQ(true, index.contains(5));
+    EXPECT_EQ(false, index.contains(4));
+    EXPECT_EQ(false, index.contains(SYMBOL_UNRESOLVED));
+    EXPECT_EQ(false, index.contains(500));
+    EXPECT_EQ(42, *index.find(5));
+    EXPECT_EQ(NULL, index.find(6));
+}
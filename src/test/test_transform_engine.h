@@ -0,0 +1,105 @@
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+
+#include "plugins/common/transformengine.h"
+
+static std::string TransformLabel(const TransformEngine &engine, TransformId id, double value)
+{
+    TransformResult result;
+
+    engine.apply(id, value, result);
+
+    return result.label ? std::string(result.label, result.labelLength) : "<none>";
+}
+
+static double TransformNumber(const TransformEngine &engine, TransformId id, double value)
+{
+    TransformResult result;
+
+    engine.apply(id, value, result);
+
+    return result.number;
+}
+
+TEST(TransformEngineTest, BoolLabelsPassOtherValuesThrough)
+{
+    TransformEngine engine;
+    TransformId id = engine.add("S_MIP_GEAR", 3, TransformChain().boolLabels("Down", "Off"));
+
+    EXPECT_EQ("Down", TransformLabel(engine, id, 0));
+    EXPECT_EQ("Off", TransformLabel(engine, id, 1));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, 2));
+    EXPECT_EQ(2, TransformNumber(engine, id, 2));
+}
+
+TEST(TransformEngineTest, ScalesClampsAndInvertsInOrder)
+{
+    TransformEngine engine;
+    TransformId scaled = engine.compile(TransformChain().scale(2, 10).clamp(0, 100));
+    TransformId inverted = engine.compile(TransformChain().invert());
+
+    EXPECT_EQ(20, TransformNumber(engine, scaled, 5));
+    EXPECT_EQ(100, TransformNumber(engine, scaled, 60));
+    EXPECT_EQ(0, TransformNumber(engine, scaled, -30));
+    EXPECT_EQ(1, TransformNumber(engine, inverted, 0));
+    EXPECT_EQ(0, TransformNumber(engine, inverted, 7));
+}
+
+TEST(TransformEngineTest, LabelMapsMatchExactValues)
+{
+    TransformEngine engine;
+    std::map<int, std::string> positions = {{4, "FLT"}, {1, "GRD"}, {0, "Off"}, {2, "CONT"}};
+    TransformId id = engine.compile(TransformChain().labels(positions));
+
+    EXPECT_EQ("Off", TransformLabel(engine, id, 0));
+    EXPECT_EQ("GRD", TransformLabel(engine, id, 1));
+    EXPECT_EQ("CONT", TransformLabel(engine, id, 2));
+    EXPECT_EQ("FLT", TransformLabel(engine, id, 4));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, 3));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, 1.5));
+}
+
+TEST(TransformEngineTest, LabelMapsSkipValuesOutsideTheKeyRange)
+{
+    TransformEngine engine;
+    TransformId id = engine.compile(TransformChain().labels({{0, "Off"}, {1, "On"}}));
+
+    EXPECT_EQ("<none>", TransformLabel(engine, id, std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, std::numeric_limits<double>::infinity()));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, -std::numeric_limits<double>::infinity()));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, 1e19));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, -1e19));
+    EXPECT_EQ("<none>", TransformLabel(engine, id, 9223372036854775808.0));
+    EXPECT_TRUE(std::isnan(TransformNumber(engine, id, std::numeric_limits<double>::quiet_NaN())));
+}
+
+TEST(TransformEngineTest, ChainsIntoALabel)
+{
+    TransformEngine engine;
+    TransformId id = engine.compile(TransformChain().invert().boolLabels("Off", "On").scale(100));
+
+    EXPECT_EQ("On", TransformLabel(engine, id, 0));
+    EXPECT_EQ("Off", TransformLabel(engine, id, 1));
+
+    // nothing runs after the label
+    EXPECT_EQ(0, TransformNumber(engine, id, 1));
+}
+
+TEST(TransformEngineTest, FindsBySymbolThenName)
+{
+    TransformEngine engine;
+    TransformId bySymbol = engine.add("S_OH_GALLEY", 7, TransformChain().boolLabels("Off", "On"));
+
+    EXPECT_EQ(bySymbol, engine.find("S_OH_GALLEY", 7));
+    EXPECT_EQ(TRANSFORM_NONE, engine.find("S_OH_GALLEY_2", 8));
+    EXPECT_EQ(bySymbol, engine.find("S_OH_GALLEY", SYMBOL_UNRESOLVED));
+
+    TransformId byName = engine.add("S_OH_ATTEND", SYMBOL_UNRESOLVED, TransformChain().boolLabels("Off", "Pushed"));
+
+    EXPECT_EQ(byName, engine.find("S_OH_ATTEND", 9));
+    EXPECT_EQ(bySymbol, engine.add("S_OH_GALLEY", 7, TransformChain().invert()));
+    EXPECT_EQ(TRANSFORM_NONE, engine.add("S_EMPTY", 10, TransformChain()));
+    EXPECT_EQ(2u, engine.count());
+}
@@ -34,6 +34,8 @@ cli.version('1.0.0')
   .usage('[options]')
   .option('-p --port [8091]', 'TCP Port', '8091')
   .option('-t --training_port [8080]', 'Training TCP port', '8080')
+  .option('-d --drop_every [seconds]', 'Drop every client connection at this interval', parseFloat)
+  .option('-r --refuse_for [seconds]', 'Refuse new connections for this long after a drop', parseFloat, 0)
   .parse(process.argv)
 
 console.log(color.green(`Starting emulator on port ${cli.port}`))
@@ -46,6 +48,33 @@ server.on('connection', handleConnection)
 trainingServer.on('connection', handleTrainingConnection)
 
 var connections = {}
+var clients = new Set()
+var refusingUntil = 0
+
+// simulates ProSim going away - every client is reset and, with
+// --refuse_for, reconnects are turned away for a while
+function dropClients (reason) {
+  console.log(color.red(`Dropping ${clients.size} client(s) - ${reason}`))
+
+  clients.forEach((conn) => conn.destroy())
+  clients.clear()
+
+  if (cli.refuse_for > 0) {
+    refusingUntil = _.now() + cli.refuse_for * 1000
+    console.log(color.red(`Refusing connections for ${cli.refuse_for}s`))
+  }
+}
+
+if (cli.drop_every > 0) {
+  setInterval(() => dropClients('interval'), cli.drop_every * 1000)
+}
+
+// on demand: "d" + enter on stdin, or kill -USR2 <pid>
+process.stdin.on('data', (data) => {
+  if (data.toString().trim() === 'd') dropClients('requested')
+})
+process.on('SIGUSR2', () => dropClients('SIGUSR2'))
+console.log(color.green('Type d + enter (or send SIGUSR2) to drop all connections'))
 
 function getBytes (string) {
   return Buffer.byteLength(string, 'utf8')
@@ -90,6 +119,7 @@ function handleTrainingConnection (conn) {
   }
 
   function onConnClose () {
+    clients.delete(conn)
     clearInterval(intervalTimer)
     connections[portString].endTime = _.now()
     duration =
@@ -151,12 +181,22 @@ function handleConnection (conn) {
   var portString = port.toString()
   var intervalTimer
 
+  if (_.now() < refusingUntil) {
+    console.log(color.red(`Refused client - ${address}:${port}`))
+    conn.destroy()
+    return
+  }
+
+  clients.add(conn)
+
   connections[portString] = {
     startTime: _.now()
   }
 
   console.log(color.yellow(`Client connected - ${address}:${port}`))
 
+  // commands and resynced values from the hub
+  conn.on('data', (data) => process.stdout.write(color.cyan(data.toString())))
   conn.once('close', onConnClose)
   conn.once('error', onConnError)
 